@@ -27,7 +27,7 @@ bool parse_arguments(int argc, char *argv[], nlohmann::json& config)
   cxxopts::Options options("glm", "GLM toolkit");
 
   options.add_options()
-    ("m,mode", "mode [create-configs,create,augment,distill,train,predict,explore]",
+    ("m,mode", "mode [create-configs,create,augment,distill,train,predict,explore,serve]",
      cxxopts::value<std::string>()->default_value("create-configs"))
     ("c,config", "config-file for the model",
      cxxopts::value<std::string>()->default_value("./config.json"))
@@ -45,7 +45,7 @@ bool parse_arguments(int argc, char *argv[], nlohmann::json& config)
   if(result.count("mode")==0)
     {
       LOG_S(WARNING) << "`mode` is a required and needs to be one of "
-		     << "`create-configs`, `create`, `distill`, `query` or `explore`";
+		     << "`create-configs`, `create`, `distill`, `query`, `explore` or `serve`";
       return false;
     }
   
@@ -54,12 +54,12 @@ bool parse_arguments(int argc, char *argv[], nlohmann::json& config)
   
   std::set<std::string> modes = {"create-configs","create",
 				 "augment","distill",
-				 "query","explore"};
+				 "query","explore","serve"};
   
   if(modes.count(mode)==0)
     {
       LOG_S(WARNING) << "mode `" << mode << "` needs to be one of "
-		     << "`create-configs`, `create` , `distill`, `query` or `explore`";
+		     << "`create-configs`, `create` , `distill`, `query`, `explore` or `serve`";
       return false;
     }
   
@@ -71,7 +71,7 @@ bool parse_arguments(int argc, char *argv[], nlohmann::json& config)
   if(result.count("config")==0)
     {
       LOG_S(WARNING) << "`config` is required for `mode` of type "
-		     << "`create`, `distill`, `query` or `explore`.";
+		     << "`create`, `distill`, `query`, `explore` or `serve`.";
       return false;
     }  
 
@@ -99,6 +99,9 @@ bool parse_arguments(int argc, char *argv[], nlohmann::json& config)
   else if(mode==to_string(andromeda::glm::EXPLORE))
     {
     }
+  else if(mode==to_string(andromeda::glm::SERVE))
+    {
+    }
   else
     {
       LOG_S(WARNING) << "run with `-h` or -m <mode> -c <config-file>";
@@ -158,9 +161,13 @@ int main(int argc, char *argv[])
     {
       andromeda::glm::explore_glm_model(args, model);      
     }    
+  else if(mode==to_string(andromeda::glm::SERVE))
+    {
+      andromeda::glm::serve_glm_model(args, model);
+    }
   else
     {
-      LOG_S(ERROR) << "no key of value: `create`, `distill`, `query` or `explore`";
+      LOG_S(ERROR) << "no key of value: `create`, `distill`, `query`, `explore` or `serve`";
     }
   
   return 0;
@@ -0,0 +1,1580 @@
+//-*-C++-*-
+
+#include <filesystem>
+
+#include "libraries.h"
+#include "andromeda.h"
+
+// counts the bytes that are live through this allocator (and all its
+// rebinds), so that the memory of node-based containers can be compared
+// to flat ones.
+struct allocation_counter
+{
+  static inline std::size_t allocated = 0;
+};
+
+template<typename item_type>
+class counting_allocator: public allocation_counter
+{
+public:
+
+  typedef item_type value_type;
+
+  counting_allocator() {}
+
+  template<typename other_type>
+  counting_allocator(const counting_allocator<other_type>&) {}
+
+  value_type* allocate(std::size_t n)
+  {
+    allocated += n*sizeof(value_type);
+    return std::allocator<value_type>().allocate(n);
+  }
+
+  void deallocate(value_type* ptr, std::size_t n)
+  {
+    allocated -= n*sizeof(value_type);
+    std::allocator<value_type>().deallocate(ptr, n);
+  }
+
+  template<typename other_type>
+  bool operator==(const counting_allocator<other_type>&) const { return true; }
+
+  template<typename other_type>
+  bool operator!=(const counting_allocator<other_type>&) const { return false; }
+};
+
+double to_msec(std::chrono::time_point<std::chrono::system_clock> t0,
+               std::chrono::time_point<std::chrono::system_clock> t1)
+{
+  std::chrono::duration<double, std::milli> delta = t1-t0;
+  return delta.count();
+}
+
+void benchmark_hash_index(std::size_t N)
+{
+  typedef andromeda::base_types::hash_type hash_type;
+  typedef andromeda::base_types::flvr_type flvr_type;
+  typedef andromeda::base_types::ind_type ind_type;
+
+  typedef std::pair<flvr_type, ind_type> key_type;
+  typedef std::pair<const hash_type, key_type> value_type;
+
+  typedef std::unordered_map<hash_type, key_type,
+                             std::hash<hash_type>, std::equal_to<hash_type>,
+                             counting_allocator<value_type> > map_type;
+
+  typedef andromeda::glm::glm_hash_index index_type;
+
+  LOG_S(INFO) << "benchmarking hash-index with " << N << " entries";
+
+  // edge-hashes as they are produced by `base_edge`
+  std::vector<hash_type> hashes(N), misses(N);
+  for(std::size_t i=0; i<N; i++)
+    {
+      andromeda::glm::base_edge edge(i%64, 3*i+1, 7*i+3);
+      hashes.at(i) = edge.get_hash();
+
+      andromeda::glm::base_edge miss(i%64, 3*i+2, 7*i+5);
+      misses.at(i) = miss.get_hash();
+    }
+
+  std::vector<std::string> header = {"container", "insert [Mop/s]", "hit [Mop/s]", "miss [Mop/s]",
+                                     "bytes/entry", "load-factor"};
+  std::vector<std::vector<std::string> > data={};
+
+  std::size_t checksum=0;
+
+  {
+    allocation_counter::allocated = 0;
+
+    map_type map;
+    map.reserve(N);
+    map.max_load_factor(32.0);
+
+    auto t0 = std::chrono::system_clock::now();
+    for(std::size_t i=0; i<N; i++)
+      {
+        map.insert(std::make_pair(hashes[i], key_type(i%64, i)));
+      }
+
+    auto t1 = std::chrono::system_clock::now();
+    for(std::size_t i=0; i<N; i++)
+      {
+        auto itr = map.find(hashes[i]);
+        checksum += (itr->second).second;
+      }
+
+    auto t2 = std::chrono::system_clock::now();
+    for(std::size_t i=0; i<N; i++)
+      {
+        checksum += map.count(misses[i]);
+      }
+
+    auto t3 = std::chrono::system_clock::now();
+
+    double bytes = allocation_counter::allocated;
+    data.push_back({"std::unordered_map (mlf=32)",
+                    std::to_string(N/(1.e3*to_msec(t0, t1))),
+                    std::to_string(N/(1.e3*to_msec(t1, t2))),
+                    std::to_string(N/(1.e3*to_msec(t2, t3))),
+                    std::to_string(bytes/N),
+                    std::to_string(map.load_factor())});
+  }
+
+  {
+    index_type index;
+    index.reserve(N);
+
+    auto t0 = std::chrono::system_clock::now();
+    for(std::size_t i=0; i<N; i++)
+      {
+        index.insert(hashes[i], key_type(i%64, i));
+      }
+
+    auto t1 = std::chrono::system_clock::now();
+    for(std::size_t i=0; i<N; i++)
+      {
+        key_type key;
+        index.find(hashes[i], key);
+        checksum -= key.second;
+      }
+
+    auto t2 = std::chrono::system_clock::now();
+    for(std::size_t i=0; i<N; i++)
+      {
+        checksum -= index.count(misses[i]);
+      }
+
+    auto t3 = std::chrono::system_clock::now();
+
+    double bytes = index.memory_size();
+    data.push_back({"glm_hash_index",
+                    std::to_string(N/(1.e3*to_msec(t0, t1))),
+                    std::to_string(N/(1.e3*to_msec(t1, t2))),
+                    std::to_string(N/(1.e3*to_msec(t2, t3))),
+                    std::to_string(bytes/N),
+                    std::to_string(index.load_factor())});
+  }
+
+  if(checksum!=0)
+    {
+      LOG_S(ERROR) << "hash-index and unordered_map disagree on lookups!";
+    }
+
+  LOG_S(INFO) << andromeda::utils::to_string("hash-index versus unordered_map", header, data);
+}
+
+void benchmark_traverse(std::size_t N)
+{
+  typedef andromeda::base_types::hash_type hash_type;
+  typedef andromeda::base_types::flvr_type flvr_type;
+
+  typedef andromeda::glm::glm_edges edges_type;
+  typedef typename edges_type::edge_type edge_type;
+
+  flvr_type flvr = andromeda::glm::edge_names::next;
+
+  std::size_t M = std::max(std::size_t(1), N/16);
+  LOG_S(INFO) << "benchmarking traversal with " << N << " edges over " << M << " sources";
+
+  std::mt19937_64 gen(12345);
+
+  std::vector<hash_type> sources(M);
+  for(std::size_t i=0; i<M; i++)
+    {
+      sources.at(i) = gen();
+    }
+
+  edges_type edges;
+  edges.reserve(N);
+
+  for(std::size_t i=0; i<N; i++)
+    {
+      edges.insert(flvr, sources.at(gen()%M), gen()%(N/4+1)+1, 1+gen()%32, false);
+    }
+
+  edges.sort(flvr);
+
+  // random order of the source-nodes, as they would come out of a SELECT
+  std::shuffle(sources.begin(), sources.end(), gen);
+
+  std::vector<std::string> header = {"traversal", "time [msec]", "throughput [Mnode/s]", "#-edges", "checksum"};
+  std::vector<std::vector<std::string> > data={};
+
+  {
+    auto t0 = std::chrono::system_clock::now();
+    edges.freeze(flvr);
+    auto t1 = std::chrono::system_clock::now();
+
+    data.push_back({"freeze", std::to_string(to_msec(t0, t1)), "", "", ""});
+  }
+
+  for(std::string mode:{"vector-copy", "range-view", "count"})
+    {
+      std::vector<edge_type> tmps={};
+
+      std::size_t num_edges=0;
+      double checksum=0;
+
+      auto t0 = std::chrono::system_clock::now();
+      for(auto hash_i:sources)
+        {
+          if(mode=="vector-copy")
+            {
+              num_edges += edges.traverse(flvr, hash_i, tmps, true);
+              for(const auto& edge:tmps)
+                {
+                  checksum += edge.get_prob()*(edge.get_hash_j()%7);
+                }
+            }
+          else if(mode=="range-view")
+            {
+              for(const auto edge:edges.traverse(flvr, hash_i))
+                {
+                  num_edges += 1;
+                  checksum += edge.get_prob()*(edge.get_hash_j()%7);
+                }
+            }
+          else
+            {
+              auto cnts = edges.get_number_of_edges(flvr, hash_i);
+
+              num_edges += cnts.first;
+              checksum += cnts.second;
+            }
+        }
+      auto t1 = std::chrono::system_clock::now();
+
+      data.push_back({mode,
+                      std::to_string(to_msec(t0, t1)),
+                      std::to_string(M/(1.e3*to_msec(t0, t1))),
+                      std::to_string(num_edges),
+                      std::to_string(checksum)});
+    }
+
+  LOG_S(INFO) << andromeda::utils::to_string("edge traversal over a frozen flavor", header, data);
+}
+
+void benchmark_merge(std::size_t N)
+{
+  typedef andromeda::base_types::hash_type hash_type;
+  typedef andromeda::base_types::flvr_type flvr_type;
+
+  typedef andromeda::glm::glm_edges edges_type;
+
+  flvr_type flvr = andromeda::glm::edge_names::next;
+
+  std::size_t M = std::max(std::size_t(1), N/16);
+  LOG_S(INFO) << "benchmarking merge of two models with " << N << " edges each";
+
+  std::mt19937_64 gen(12345);
+
+  std::vector<hash_type> sources(M);
+  for(std::size_t i=0; i<M; i++)
+    {
+      sources.at(i) = gen();
+    }
+
+  // two corpus slices with overlapping edges
+  std::array<edges_type, 2> slices;
+  for(auto& slice:slices)
+    {
+      slice.reserve(N);
+      for(std::size_t i=0; i<N; i++)
+        {
+          slice.insert(flvr, sources.at(gen()%M), gen()%(N/8+1)+1, 1+gen()%32, false);
+        }
+      slice.sort();
+    }
+
+  std::vector<std::string> header = {"merge", "time [msec]", "#-edges", "checksum"};
+  std::vector<std::vector<std::string> > data={};
+
+  for(std::string mode:{"insert", "sort-merge"})
+    {
+      edges_type edges;
+      for(auto itr=slices[0].begin(); itr!=slices[0].end(); itr++)
+        {
+          for(const auto& edge:itr->second)
+            {
+              edges.push_back(edge, true);
+            }
+        }
+      edges.sort();
+
+      auto t0 = std::chrono::system_clock::now();
+      if(mode=="insert")
+        {
+          for(auto itr=slices[1].begin(); itr!=slices[1].end(); itr++)
+            {
+              for(const auto& edge:itr->second)
+                {
+                  edges.insert(edge, false);
+                }
+            }
+          edges.sort();
+        }
+      else
+        {
+          edges.merge(slices[1]);
+        }
+      auto t1 = std::chrono::system_clock::now();
+
+      double checksum=0;
+      for(auto hash_i:sources)
+        {
+          for(const auto edge:edges.traverse(flvr, hash_i))
+            {
+              checksum += edge.get_count()*(edge.get_hash_j()%7);
+            }
+        }
+
+      data.push_back({mode,
+                      std::to_string(to_msec(t0, t1)),
+                      std::to_string(edges.size()),
+                      std::to_string(checksum)});
+    }
+
+  LOG_S(INFO) << andromeda::utils::to_string("merging two sorted edge-sets", header, data);
+}
+
+void benchmark_load(std::size_t N)
+{
+  typedef andromeda::base_types::hash_type hash_type;
+  typedef andromeda::base_types::flvr_type flvr_type;
+
+  typedef andromeda::glm::model model_type;
+  typedef andromeda::glm::io_base io_type;
+
+  typedef typename model_type::node_type node_type;
+
+  flvr_type node_flvr = andromeda::glm::node_names::WORD_TOKEN;
+  flvr_type edge_flvr = andromeda::glm::edge_names::next;
+
+  std::size_t M = std::max(std::size_t(1), N/16);
+  LOG_S(INFO) << "benchmarking load with " << N << " edges over " << M << " nodes";
+
+  std::mt19937_64 gen(12345);
+
+  std::vector<hash_type> hashes={};
+  auto model_ptr = std::make_shared<model_type>();
+  {
+    auto& nodes = model_ptr->get_nodes();
+    auto& edges = model_ptr->get_edges();
+
+    for(std::size_t i=0; i<M; i++)
+      {
+        node_type node(node_flvr, "word-"+std::to_string(i));
+        hashes.push_back(nodes.insert(node, false).get_hash());
+      }
+
+    for(std::size_t i=0; i<N; i++)
+      {
+        edges.insert(edge_flvr, hashes.at(gen()%M), hashes.at(gen()%M), 1+gen()%32, false);
+      }
+
+    nodes.sort();
+
+    edges.sort();
+    edges.freeze();
+  }
+
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "glm-benchmark-load";
+
+  std::vector<std::string> header = {"format", "save [msec]", "load [msec]", "traverse [msec]", "#-edges"};
+  std::vector<std::vector<std::string> > data={};
+
+  for(int version:{1, 2})
+    {
+      std::filesystem::path path = root / ("v"+std::to_string(version));
+      std::filesystem::create_directories(path);
+
+      nlohmann::json config = nlohmann::json::object({});
+      config[io_type::io_lbl][io_type::save_lbl][io_type::root_lbl] = path.string();
+      config[io_type::io_lbl][io_type::save_lbl][io_type::format_lbl] = version;
+
+      auto t0 = std::chrono::system_clock::now();
+      {
+        andromeda::glm::model_op<andromeda::glm::SAVE> io;
+        io.from_config(config);
+        io.save(model_ptr);
+      }
+      auto t1 = std::chrono::system_clock::now();
+
+      auto loaded = std::make_shared<model_type>();
+      {
+        andromeda::glm::model_op<andromeda::glm::LOAD> io;
+        io.load(path, loaded);
+      }
+      auto t2 = std::chrono::system_clock::now();
+
+      std::size_t num_edges=0;
+      for(auto hash_i:hashes)
+        {
+          for(const auto edge:loaded->get_edges().traverse(edge_flvr, hash_i))
+            {
+              num_edges += (edge.get_count()>0);
+            }
+        }
+      auto t3 = std::chrono::system_clock::now();
+
+      data.push_back({"v"+std::to_string(version),
+                      std::to_string(to_msec(t0, t1)),
+                      std::to_string(to_msec(t1, t2)),
+                      std::to_string(to_msec(t2, t3)),
+                      std::to_string(num_edges)});
+    }
+
+  std::filesystem::remove_all(root);
+
+  LOG_S(INFO) << andromeda::utils::to_string("model load (v1: stream, v2: memory-mapped)", header, data);
+}
+
+// the create configuration of the documents in `input`, with the model in `root`
+nlohmann::json create_benchmark_config(std::filesystem::path input, std::filesystem::path root)
+{
+  typedef andromeda::glm::model model_type;
+  typedef andromeda::glm::io_base io_type;
+
+  nlohmann::json config = nlohmann::json::object({});
+  {
+    auto model = std::make_shared<model_type>();
+
+    andromeda::glm::model_cli<andromeda::glm::CREATE, model_type> creator(model);
+    config = creator.to_config();
+
+    config[io_type::io_lbl][io_type::save_lbl][io_type::root_lbl] = root.string();
+    config[io_type::io_lbl][io_type::load_lbl][io_type::root_lbl] = root.string();
+
+    config["parameters"]["nlp-models"] = "conn;verb;term;abbreviation";
+
+    nlohmann::json producer = nlohmann::json::object({});
+    {
+      producer["input-format"] = "json";
+      producer["input-paths"] = nlohmann::json::array({input.string()});
+
+      producer["keep-figures"] = true;
+      producer["keep-tables"] = true;
+      producer["keep-text"] = true;
+      producer["order-text"] = true;
+
+      producer["output"] = false;
+      producer["subject-type"] = "DOCUMENT";
+    }
+    config["producers"] = nlohmann::json::array({producer});
+  }
+
+  return config;
+}
+
+/*
+ * Sums the merge and wait times over the merges in the create-log
+ * (`model-creation-*.csv`) in `root`, see `create_log`.
+ */
+bool read_create_log(std::filesystem::path root, std::size_t& num_merges,
+                     double& merge_time, double& wait_time)
+{
+  num_merges=0;
+  merge_time=0.0;
+  wait_time=0.0;
+
+  for(auto& entry:std::filesystem::directory_iterator(root))
+    {
+      std::string name = entry.path().filename().string();
+      if(name.rfind("model-creation-", 0)!=0 or entry.path().extension()!=".csv")
+        {
+          continue;
+        }
+
+      std::ifstream ifs(entry.path());
+
+      std::string line;
+      std::getline(ifs, line);
+
+      std::vector<std::string> header = andromeda::utils::split(line, ',');
+
+      auto merge_itr = std::find(header.begin(), header.end(), "merge [msec]");
+      auto wait_itr = std::find(header.begin(), header.end(), "wait [msec]");
+
+      if(merge_itr==header.end() or wait_itr==header.end())
+        {
+          return false;
+        }
+
+      while(std::getline(ifs, line))
+        {
+          std::vector<std::string> row = andromeda::utils::split(line, ',');
+          if(row.size()<header.size())
+            {
+              continue;
+            }
+
+          num_merges += 1;
+          merge_time += std::stod(row.at(merge_itr-header.begin()));
+          wait_time += std::stod(row.at(wait_itr-header.begin()));
+        }
+
+      return true;
+    }
+
+  return false;
+}
+
+void benchmark_create_scaling(std::filesystem::path input, std::size_t max_threads)
+{
+  typedef andromeda::glm::model model_type;
+
+  if(input.empty())
+    {
+      input = std::filesystem::path(ROOT_PATH) / "data" / "documents";
+    }
+
+  LOG_S(INFO) << "benchmarking create-scaling on " << input;
+
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "glm-benchmark-create";
+  std::filesystem::create_directories(root);
+
+  nlohmann::json config = create_benchmark_config(input, root);
+
+  std::vector<std::string> header = {"#-threads", "time [sec]", "speedup", "#-nodes", "#-edges",
+                                     "#-merges", "merge [sec]", "wait [sec]"};
+  std::vector<std::vector<std::string> > data={};
+
+  double reference=0;
+  for(std::size_t num_threads=1; num_threads<=max_threads; num_threads*=2)
+    {
+      config["create"]["number-of-threads"] = num_threads;
+
+      // every run writes its own create-log
+      std::filesystem::remove_all(root);
+      std::filesystem::create_directories(root);
+
+      auto model = std::make_shared<model_type>();
+
+      auto t0 = std::chrono::system_clock::now();
+      andromeda::glm::create_glm_model(config, model);
+      auto t1 = std::chrono::system_clock::now();
+
+      double time = to_msec(t0, t1)/1.e3;
+      reference = (num_threads==1? time: reference);
+
+      std::size_t num_merges=0;
+      double merge_time=0.0, wait_time=0.0;
+
+      if(not read_create_log(root, num_merges, merge_time, wait_time))
+        {
+          LOG_S(WARNING) << "no create-log with merge and wait times in " << root;
+        }
+
+      data.push_back({std::to_string(num_threads),
+                      std::to_string(time),
+                      std::to_string(reference/time),
+                      std::to_string(model->get_nodes().size()),
+                      std::to_string(model->get_edges().size()),
+                      std::to_string(num_merges),
+                      std::to_string(merge_time/1.e3),
+                      std::to_string(wait_time/1.e3)});
+
+      LOG_S(INFO) << andromeda::utils::to_string("create-scaling", header, data);
+    }
+
+  std::filesystem::remove_all(root);
+}
+
+/*
+ * The heavy-hitter admission during create, against an unfiltered create
+ * followed by a distill with the same minimum count. Recall and
+ * precision are those of the admitted edges with respect to the
+ * distilled ones, the counters of the common nodes are compared with the
+ * exact ones of the unfiltered model.
+ */
+void benchmark_admission(std::filesystem::path input, std::size_t num_threads)
+{
+  typedef andromeda::base_types::hash_type hash_type;
+
+  typedef andromeda::glm::model model_type;
+  typedef typename model_type::node_type node_type;
+
+  if(input.empty())
+    {
+      input = std::filesystem::path(ROOT_PATH) / "data" / "documents";
+    }
+
+  // the default `number` is meant for the synthetic benchmarks
+  num_threads = std::clamp(num_threads, std::size_t(1), std::size_t(std::max(4u, std::thread::hardware_concurrency())));
+  LOG_S(INFO) << "benchmarking admission on " << input << " (" << num_threads << " threads)";
+
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "glm-benchmark-admission";
+  std::filesystem::create_directories(root);
+
+  std::size_t min_count=2;
+
+  nlohmann::json config = create_benchmark_config(input, root);
+  config["create"]["number-of-threads"] = num_threads;
+
+  // three models and the sketches are alive at the same time
+  config["create"]["model"]["max-nodes"] = 1000000;
+  config["create"]["model"]["max-edges"] = 10000000;
+
+  auto get_edges = [](std::shared_ptr<model_type> model)
+  {
+    std::unordered_set<hash_type> hashes={};
+    for(auto itr=model->get_edges().begin(); itr!=model->get_edges().end(); itr++)
+      {
+        for(const auto& edge:itr->second)
+          {
+            hashes.insert(edge.get_hash());
+          }
+      }
+
+    return hashes;
+  };
+
+  // the unfiltered model, before and after distilling
+  auto exact = std::make_shared<model_type>();
+
+  auto t0 = std::chrono::system_clock::now();
+  andromeda::glm::create_glm_model(config, exact);
+  auto t1 = std::chrono::system_clock::now();
+
+  auto distilled = std::make_shared<model_type>();
+  {
+    andromeda::glm::model_op<andromeda::glm::LOAD> io;
+    io.load(root, distilled);
+  }
+
+  auto t2 = std::chrono::system_clock::now();
+  {
+    andromeda::glm::model_cli<andromeda::glm::DISTILL, model_type> distiller(distilled);
+    distiller.from_config(nlohmann::json::object({{"min-edge-count", min_count}, {"in-place", true}}));
+
+    distilled = distiller.distill();
+  }
+  auto t3 = std::chrono::system_clock::now();
+
+  std::unordered_set<hash_type> reference = get_edges(distilled);
+
+  // the same documents, with admission during create
+  auto admitted = std::make_shared<model_type>();
+
+  config["create"]["heavy-hitters"] = true;
+  config["create"]["heavy-hitter-min-count"] = min_count;
+
+  auto t4 = std::chrono::system_clock::now();
+  andromeda::glm::create_glm_model(config, admitted);
+  auto t5 = std::chrono::system_clock::now();
+
+  std::size_t num_common=0, num_dangling=0;
+  for(auto itr=admitted->get_edges().begin(); itr!=admitted->get_edges().end(); itr++)
+    {
+      for(const auto& edge:itr->second)
+        {
+          num_common += reference.count(edge.get_hash());
+
+          num_dangling += (not (admitted->get_nodes().has(edge.get_hash_i()) and
+                                admitted->get_nodes().has(edge.get_hash_j())));
+        }
+    }
+
+  std::size_t num_nodes=0, num_exact=0;
+  for(auto itr=admitted->get_nodes().begin(); itr!=admitted->get_nodes().end(); itr++)
+    {
+      for(const auto& node:itr->second)
+        {
+          node_type other;
+          if(not exact->get_nodes().get(node.get_hash(), other))
+            {
+              continue;
+            }
+
+          num_nodes += 1;
+          num_exact += (node.get_word_cnt()==other.get_word_cnt() and
+                        node.get_sent_cnt()==other.get_sent_cnt() and
+                        node.get_text_cnt()==other.get_text_cnt() and
+                        node.get_tabl_cnt()==other.get_tabl_cnt() and
+                        node.get_fdoc_cnt()==other.get_fdoc_cnt());
+        }
+    }
+
+  std::size_t num_admitted = admitted->get_edges().size();
+
+  std::vector<std::string> header = {"model", "create [sec]", "distill [sec]", "#-nodes", "#-edges",
+                                     "recall", "precision", "#-dangling", "exact counters"};
+  std::vector<std::vector<std::string> > data={};
+
+  data.push_back({"unfiltered", std::to_string(to_msec(t0, t1)/1.e3), "",
+                  std::to_string(exact->get_nodes().size()), std::to_string(exact->get_edges().size()),
+                  "", "", "", ""});
+
+  data.push_back({"distilled", "", std::to_string(to_msec(t2, t3)/1.e3),
+                  std::to_string(distilled->get_nodes().size()), std::to_string(reference.size()),
+                  "1", "1", "", ""});
+
+  data.push_back({"admission", std::to_string(to_msec(t4, t5)/1.e3), "",
+                  std::to_string(admitted->get_nodes().size()), std::to_string(num_admitted),
+                  std::to_string(num_common/std::max(1.0, double(reference.size()))),
+                  std::to_string(num_common/std::max(1.0, double(num_admitted))),
+                  std::to_string(num_dangling),
+                  std::to_string(num_exact)+"/"+std::to_string(num_nodes)});
+
+  LOG_S(INFO) << andromeda::utils::to_string("heavy-hitter admission vs create + distill (min-count: "+
+                                             std::to_string(min_count)+")", header, data);
+
+  if(num_dangling>0)
+    {
+      LOG_S(ERROR) << num_dangling << " admitted edges have a node that was not admitted!";
+    }
+
+  std::filesystem::remove_all(root);
+}
+
+// random `next`-edges over `M` word-nodes with the texts "word-<i>"
+std::shared_ptr<andromeda::glm::model> create_synthetic_model(std::size_t N, std::size_t M)
+{
+  typedef andromeda::base_types::hash_type hash_type;
+  typedef andromeda::base_types::flvr_type flvr_type;
+
+  typedef andromeda::glm::model model_type;
+  typedef typename model_type::node_type node_type;
+
+  flvr_type node_flvr = andromeda::glm::node_names::WORD_TOKEN;
+  flvr_type edge_flvr = andromeda::glm::edge_names::next;
+
+  std::mt19937_64 gen(12345);
+
+  auto model_ptr = std::make_shared<model_type>();
+  {
+    auto& nodes = model_ptr->get_nodes();
+    auto& edges = model_ptr->get_edges();
+
+    std::vector<hash_type> hashes={};
+    for(std::size_t i=0; i<M; i++)
+      {
+        node_type node(node_flvr, "word-"+std::to_string(i));
+
+        // mostly small counters, with a few that need the full width
+        node.set_word_cnt(i%97==0? 100000+i: 1+gen()%200);
+
+        node.incr_sent_cnt();
+        node.incr_text_cnt();
+        node.incr_tabl_cnt(gen()%4==0);
+        node.incr_fdoc_cnt(gen()%2==0);
+
+        hashes.push_back(nodes.insert(node, false).get_hash());
+      }
+
+    for(std::size_t i=0; i<N; i++)
+      {
+        edges.insert(edge_flvr, hashes.at(gen()%M), hashes.at(gen()%M), 1+gen()%32, false);
+      }
+
+    nodes.sort();
+  }
+
+  return model_ptr;
+}
+
+// a SELECT of a few words, followed by two traversals along `next`
+nlohmann::json create_synthetic_query(std::size_t seed, std::size_t M)
+{
+  nlohmann::json words = nlohmann::json::array({});
+  for(std::size_t l=0; l<4; l++)
+    {
+      words.push_back(nlohmann::json::array({"word-"+std::to_string((seed*7919+l*104729)%M)}));
+    }
+
+  nlohmann::json output = nlohmann::json::object({{"ind-nodes", 0}, {"num-nodes", 32},
+                                                  {"ind-edges", 0}, {"num-edges", 32}});
+
+  nlohmann::json flow = nlohmann::json::array({});
+  {
+    flow.push_back({{"flid", 0}, {"flop", "SELECT"}, {"deps", nlohmann::json::array({})},
+                    {"parameters", {{"nodes", words}}}, {"output", output}});
+
+    flow.push_back({{"flid", 1}, {"flop", "TRAVERSE"}, {"deps", {0}},
+                    {"parameters", {{"edge", "next"}}}, {"output", output}});
+
+    flow.push_back({{"flid", 2}, {"flop", "TRAVERSE"}, {"deps", {1}},
+                    {"parameters", {{"edge", "next"}}}, {"output", output}});
+  }
+
+  nlohmann::json query = nlohmann::json::object({});
+  query["flow-name"] = "synthetic-"+std::to_string(seed);
+  query["flow"] = flow;
+
+  return query;
+}
+
+// an op that fails hard, to check that the server still answers
+class throwing_op: public andromeda::glm::query_baseop
+{
+public:
+
+  throwing_op(std::shared_ptr<const model_type> model_ptr, flow_id_type flid):
+    query_baseop(model_ptr, andromeda::glm::SELECT, flid, {})
+  {}
+
+  bool execute(results_type& results)
+  {
+    throw std::runtime_error("throwing-op "+std::to_string(flid));
+  }
+};
+
+void benchmark_serve(std::size_t N)
+{
+  typedef andromeda::glm::model model_type;
+
+  typedef andromeda::glm::model_cli<andromeda::glm::SERVE, model_type> server_type;
+  typedef andromeda::glm::query_flow<const model_type> qflow_type;
+
+  std::size_t M = std::max(std::size_t(64), N/16);
+  LOG_S(INFO) << "benchmarking serve with " << N << " edges over " << M << " nodes";
+
+  auto model_ptr = create_synthetic_model(N, M);
+
+  std::size_t num_threads=4;
+
+  nlohmann::json config = nlohmann::json::object({});
+  config["serve"]["number-of-threads"] = num_threads;
+  config["serve"]["flow-threads"] = 2;
+
+  server_type server(model_ptr, config);
+  if(not server.start())
+    {
+      LOG_S(ERROR) << "could not start the server";
+      return;
+    }
+
+  std::vector<std::string> header = {"request", "#-requests", "#-success", "#-errors", "flow-threads", "time [msec]"};
+  std::vector<std::vector<std::string> > data={};
+
+  std::size_t failures=0;
+
+  auto check = [&](std::string name, std::size_t num, std::vector<nlohmann::json> results,
+                   bool expected, std::chrono::time_point<std::chrono::system_clock> t0)
+  {
+    std::size_t num_success=0, num_errors=0, max_threads=0;
+    for(auto& result:results)
+      {
+        num_success += result.value("success", false);
+        num_errors += result.count("error");
+
+        if(result.count("overview"))
+          {
+            max_threads = std::max(max_threads, result["overview"].value("num-threads", std::size_t(0)));
+          }
+      }
+
+    if((expected and num_success!=num) or ((not expected) and num_errors!=num) or max_threads>2)
+      {
+        LOG_S(ERROR) << "unexpected responses for `" << name << "`";
+        failures += 1;
+      }
+
+    data.push_back({name, std::to_string(num), std::to_string(num_success), std::to_string(num_errors),
+                    std::to_string(max_threads), std::to_string(to_msec(t0, std::chrono::system_clock::now()))});
+  };
+
+  {
+    auto t0 = std::chrono::system_clock::now();
+
+    // `num-threads`=0 asks for all cores, the server caps it
+    std::vector<nlohmann::json> results={};
+    for(std::size_t l=0; l<16; l++)
+      {
+        nlohmann::json query = create_synthetic_query(l, M);
+        query["num-threads"] = 0;
+
+        results.push_back(server.execute(query.dump()));
+      }
+
+    check("query-flow", 16, results, true, t0);
+  }
+
+  {
+    auto t0 = std::chrono::system_clock::now();
+
+    std::vector<nlohmann::json> queries={};
+    for(std::size_t l=0; l<16; l++)
+      {
+        queries.push_back(create_synthetic_query(l, M));
+      }
+
+    nlohmann::json result = server.execute(nlohmann::json(queries).dump());
+    check("batch", 16, result.value("results", std::vector<nlohmann::json>({})), true, t0);
+  }
+
+  {
+    auto t0 = std::chrono::system_clock::now();
+
+    std::vector<nlohmann::json> results={};
+    for(std::string line:{"{not json", "{\"foo\": 1}", "{\"command\": \"unknown\"}"})
+      {
+        results.push_back(server.execute(line));
+      }
+
+    check("malformed", 3, results, false, t0);
+  }
+
+  {
+    auto t0 = std::chrono::system_clock::now();
+
+    // more throwing flows than workers: a worker that does not recover would block the rest
+    std::size_t num = 4*num_threads;
+
+    // the server sealed the model when it started
+    std::shared_ptr<const model_type> snapshot = model_ptr;
+
+    std::vector<std::future<nlohmann::json> > futures={};
+    for(std::size_t l=0; l<num; l++)
+      {
+        auto qflow = std::make_shared<qflow_type>(snapshot);
+        qflow->from_config(create_synthetic_query(l, M));
+
+        // next to the ops of the flow, that may still be running
+        qflow->push_back(std::make_shared<throwing_op>(snapshot, 3));
+        qflow->push_back(std::make_shared<throwing_op>(snapshot, 4));
+
+        futures.push_back(server.submit(qflow, nlohmann::json()));
+      }
+
+    std::vector<nlohmann::json> results={};
+    for(auto& future:futures)
+      {
+        results.push_back(future.get());
+      }
+
+    check("throwing flow", num, results, false, t0);
+  }
+
+  {
+    auto t0 = std::chrono::system_clock::now();
+
+    std::vector<nlohmann::json> results={};
+    for(std::size_t l=0; l<16; l++)
+      {
+        results.push_back(server.execute(create_synthetic_query(l, M).dump()));
+      }
+
+    check("after errors", 16, results, true, t0);
+  }
+
+  server.stop();
+
+  LOG_S(INFO) << andromeda::utils::to_string("serve (in-process requests)", header, data);
+
+  if(failures>0)
+    {
+      LOG_S(ERROR) << failures << " request-types got unexpected responses!";
+    }
+}
+
+bool benchmark_compact(std::size_t N)
+{
+  typedef andromeda::base_types::flvr_type flvr_type;
+
+  typedef andromeda::glm::model model_type;
+  typedef andromeda::glm::query_flow<const model_type> qflow_type;
+
+  typedef typename model_type::node_type node_type;
+
+  flvr_type node_flvr = andromeda::glm::node_names::WORD_TOKEN;
+  flvr_type edge_flvr = andromeda::glm::edge_names::next;
+
+  std::size_t M = std::max(std::size_t(64), N/16);
+  LOG_S(INFO) << "benchmarking compact counters with " << N << " edges over " << M << " nodes";
+
+  auto model_ptr = create_synthetic_model(N, M);
+  model_ptr->seal();
+
+  // the five counters of every node, and the results of a set of queries
+  auto get_state = [&](std::vector<std::string>& state)
+  {
+    state.clear();
+
+    const auto& nodes = model_ptr->get_nodes();
+    for(std::size_t i=0; i<M; i++)
+      {
+        node_type node;
+        nodes.get(node_type(node_flvr, "word-"+std::to_string(i)).get_hash(), node);
+
+        state.push_back(std::to_string(node.get_word_cnt())+","+std::to_string(node.get_sent_cnt())+","+
+                        std::to_string(node.get_text_cnt())+","+std::to_string(node.get_tabl_cnt())+","+
+                        std::to_string(node.get_fdoc_cnt()));
+      }
+
+    std::shared_ptr<const model_type> snapshot = model_ptr;
+    for(std::size_t l=0; l<64; l++)
+      {
+        qflow_type qflow(snapshot);
+        qflow.execute(create_synthetic_query(l, M));
+
+        state.push_back(qflow.to_json()["result"].dump());
+      }
+  };
+
+  std::vector<std::string> header = {"model", "nodes [MB]", "edges [MB]", "total [MB]", "state [msec]", "identical"};
+  std::vector<std::vector<std::string> > data={};
+
+  std::vector<std::string> reference={}, state={};
+
+  std::size_t failures=0;
+
+  auto report = [&](std::string name)
+  {
+    auto t0 = std::chrono::system_clock::now();
+    get_state(state);
+    auto t1 = std::chrono::system_clock::now();
+
+    if(reference.size()==0)
+      {
+        reference = state;
+      }
+
+    bool identical = (state==reference);
+    if(not identical)
+      {
+        LOG_S(ERROR) << "counters or query results of the `" << name << "` model differ";
+        failures += 1;
+      }
+
+    data.push_back({name,
+                    std::to_string(model_ptr->get_nodes().memory_size()/1.e6),
+                    std::to_string(model_ptr->get_edges().memory_size()/1.e6),
+                    std::to_string(model_ptr->memory_size()/1.e6),
+                    std::to_string(to_msec(t0, t1)),
+                    identical? "yes":"no"});
+  };
+
+  report("plain");
+
+  model_ptr->pack();
+  report("packed");
+
+  // an update materialises the nodes and counts, it does not touch the words that are queried
+  {
+    node_type node_i(node_flvr, "extra-0"), node_j(node_flvr, "extra-1");
+
+    auto& nodes = model_ptr->get_nodes();
+    auto& edges = model_ptr->get_edges();
+
+    edges.insert(edge_flvr, nodes.insert(node_i, false).get_hash(), nodes.insert(node_j, false).get_hash(), 1, false);
+    model_ptr->seal();
+  }
+  report("updated");
+
+  LOG_S(INFO) << andromeda::utils::to_string("compact counters (packed nodes and edge-counts)", header, data);
+
+  return (failures==0);
+}
+
+// the same query-flows from N threads against one sealed model, checked against a single thread
+bool benchmark_snapshot(std::size_t N)
+{
+  typedef andromeda::glm::model model_type;
+  typedef andromeda::glm::query_flow<const model_type> qflow_type;
+
+  std::size_t M = std::max(std::size_t(64), N/16);
+  LOG_S(INFO) << "benchmarking snapshot with " << N << " edges over " << M << " nodes";
+
+  std::shared_ptr<const model_type> snapshot = model_type::snapshot(create_synthetic_model(N, M));
+
+  std::size_t num_queries=64, num_rounds=4;
+
+  std::vector<nlohmann::json> queries={};
+  for(std::size_t l=0; l<num_queries; l++)
+    {
+      queries.push_back(create_synthetic_query(l, M));
+      queries.back()["num-threads"] = 1;
+    }
+
+  auto run = [&](std::size_t ind)
+  {
+    qflow_type qflow(snapshot);
+    qflow.execute(queries.at(ind));
+
+    return qflow.to_json()["result"].dump();
+  };
+
+  std::vector<std::string> header = {"threads", "#-flows", "#-mismatches", "time [msec]", "throughput [flows/s]"};
+  std::vector<std::vector<std::string> > data={};
+
+  std::vector<std::string> reference={};
+  {
+    auto t0 = std::chrono::system_clock::now();
+    for(std::size_t l=0; l<num_queries; l++)
+      {
+        reference.push_back(run(l));
+      }
+    auto t1 = std::chrono::system_clock::now();
+
+    data.push_back({"reference", std::to_string(num_queries), "0", std::to_string(to_msec(t0, t1)),
+                    std::to_string(num_queries/to_msec(t0, t1)*1.e3)});
+  }
+
+  std::size_t failures=0;
+
+  std::size_t max_threads = std::max(std::size_t(8), std::size_t(std::thread::hardware_concurrency()));
+  for(std::size_t num_threads=1; num_threads<=max_threads; num_threads*=2)
+    {
+      std::atomic<std::size_t> num_mismatches=0;
+
+      auto t0 = std::chrono::system_clock::now();
+      {
+        std::vector<std::thread> threads={};
+        for(std::size_t t=0; t<num_threads; t++)
+          {
+            // every thread starts at another query, so different flows overlap
+            threads.emplace_back([&, t]()
+            {
+              for(std::size_t i=0; i<num_rounds*num_queries; i++)
+                {
+                  std::size_t ind = (t*7+i)%num_queries;
+                  num_mismatches += (run(ind)!=reference.at(ind));
+                }
+            });
+          }
+
+        for(auto& thread:threads)
+          {
+            thread.join();
+          }
+      }
+      auto t1 = std::chrono::system_clock::now();
+
+      std::size_t num_flows = num_threads*num_rounds*num_queries;
+      failures += num_mismatches;
+
+      data.push_back({std::to_string(num_threads), std::to_string(num_flows), std::to_string(num_mismatches),
+                      std::to_string(to_msec(t0, t1)), std::to_string(num_flows/to_msec(t0, t1)*1.e3)});
+    }
+
+  LOG_S(INFO) << andromeda::utils::to_string("query-flows on a shared snapshot", header, data);
+
+  if(failures>0)
+    {
+      LOG_S(ERROR) << failures << " query-flows differ from the single-threaded reference!";
+    }
+
+  return (failures==0);
+}
+
+// prefix, caseless and fuzzy lookups in the term-index of a vocabulary of N mixed-case words
+void benchmark_term_index(std::size_t N)
+{
+  typedef andromeda::base_types::hash_type hash_type;
+  typedef andromeda::base_types::flvr_type flvr_type;
+
+  typedef andromeda::glm::model model_type;
+  typedef typename model_type::node_type node_type;
+
+  typedef andromeda::glm::glm_term_index term_index_type;
+  typedef typename term_index_type::match_type match_type;
+
+  flvr_type node_flvr = andromeda::glm::node_names::WORD_TOKEN;
+
+  LOG_S(INFO) << "benchmarking term-index with " << N << " words";
+
+  std::mt19937_64 gen(12345);
+
+  // lower-case words of 4 to 12 letters, a quarter capitalised and a few all upper-case
+  auto create_word = [&]()
+  {
+    std::string word(4+gen()%9, 'a');
+    for(auto& c:word)
+      {
+        c = 'a'+gen()%26;
+      }
+
+    std::size_t r = gen()%16;
+    if(r<4)
+      {
+        word[0] = std::toupper(word[0]);
+      }
+    else if(r==4)
+      {
+        word = andromeda::utils::to_upper(word);
+      }
+
+    return word;
+  };
+
+  std::vector<std::string> words={};
+
+  auto model_ptr = std::make_shared<model_type>();
+  {
+    auto& nodes = model_ptr->get_nodes();
+    for(std::size_t i=0; i<N; i++)
+      {
+        words.push_back(create_word());
+
+        node_type node(node_flvr, words.back());
+        nodes.insert(node, false);
+      }
+
+    nodes.sort();
+  }
+
+  term_index_type& index = model_ptr->get_term_index();
+  {
+    auto t0 = std::chrono::system_clock::now();
+    index.build(model_ptr->get_nodes(), andromeda::glm::glm_parallel::number_of_threads(0));
+    auto t1 = std::chrono::system_clock::now();
+
+    LOG_S(INFO) << "built term-index over " << model_ptr->get_nodes().size() << " nodes in "
+                << to_msec(t0, t1) << " msec (" << index.memory_size()/1.e6 << " MB)";
+  }
+
+  std::size_t num_queries = 1000, max_results = 1024;
+
+  std::vector<std::string> header = {"lookup", "#-queries", "avg #-matches", "found [%]",
+                                     "latency [usec]"};
+  std::vector<std::vector<std::string> > data={};
+
+  // `key_of` turns a word of the vocabulary into a query, which should find that word back
+  auto run = [&](std::string name,
+                 std::function<std::string(const std::string&)> key_of,
+                 std::function<void(const std::string&, std::vector<match_type>&)> lookup)
+  {
+    std::vector<std::string> keys={};
+    std::vector<hash_type> hashes={};
+    for(std::size_t l=0; l<num_queries; l++)
+      {
+        const std::string& word = words.at(gen()%words.size());
+
+        keys.push_back(key_of(word));
+        hashes.push_back(node_type(node_flvr, word).get_hash());
+      }
+
+    std::vector<std::vector<match_type> > matches(num_queries);
+
+    auto t0 = std::chrono::system_clock::now();
+    for(std::size_t l=0; l<num_queries; l++)
+      {
+        lookup(keys[l], matches[l]);
+      }
+    auto t1 = std::chrono::system_clock::now();
+
+    std::size_t num_matches=0, num_found=0;
+    for(std::size_t l=0; l<num_queries; l++)
+      {
+        num_matches += matches[l].size();
+
+        for(auto& match:matches[l])
+          {
+            if(match.first==hashes[l])
+              {
+                num_found += 1;
+                break;
+              }
+          }
+      }
+
+    data.push_back({name, std::to_string(num_queries),
+                    std::to_string(num_matches/double(num_queries)),
+                    std::to_string(100.0*num_found/num_queries),
+                    std::to_string(to_msec(t0, t1)*1.e3/num_queries)});
+  };
+
+  auto prefix_of = [](const std::string& word) { return word.substr(0, 3); };
+
+  // the same word with every letter in the other case
+  auto swap_case = [](const std::string& word)
+  {
+    std::string result=word;
+    for(auto& c:result)
+      {
+        c = std::isupper(c)? std::tolower(c):std::toupper(c);
+      }
+
+    return result;
+  };
+
+  // the same word with `num` letters replaced
+  auto with_typos = [&](const std::string& word, std::size_t num)
+  {
+    std::string result=word;
+    for(std::size_t l=0; l<num; l++)
+      {
+        result[gen()%result.size()] = 'a'+gen()%26;
+      }
+
+    return result;
+  };
+
+  run("prefix (exact)", prefix_of, [&](const std::string& key, std::vector<match_type>& matches)
+  {
+    index.find_prefix(key, false, max_results, matches);
+  });
+
+  run("prefix (caseless)", prefix_of, [&](const std::string& key, std::vector<match_type>& matches)
+  {
+    index.find_prefix(key, true, max_results, matches);
+  });
+
+  run("caseless", swap_case, [&](const std::string& key, std::vector<match_type>& matches)
+  {
+    index.find_caseless(key, max_results, matches);
+  });
+
+  for(std::size_t max_dist=1; max_dist<=2; max_dist++)
+    {
+      run("fuzzy (dist<="+std::to_string(max_dist)+")",
+          [&](const std::string& word) { return with_typos(word, max_dist); },
+          [&](const std::string& key, std::vector<match_type>& matches)
+          {
+            index.find_fuzzy(key, false, max_dist, max_results, matches);
+          });
+
+      run("fuzzy (dist<="+std::to_string(max_dist)+", caseless)",
+          [&](const std::string& word) { return swap_case(with_typos(word, max_dist)); },
+          [&](const std::string& key, std::vector<match_type>& matches)
+          {
+            index.find_fuzzy(key, true, max_dist, max_results, matches);
+          });
+    }
+
+  LOG_S(INFO) << andromeda::utils::to_string("term-index lookups", header, data);
+}
+
+/*
+ * Saves a model, loads it (mapped or not) and saves it back into the
+ * directory it was loaded from, in every binary-format. The loaded model
+ * has to stay valid while its files are replaced, and the model that is
+ * read back has to be identical to the original one. Loading it a second
+ * time incrementally (as `augment` does) has to double all the counts.
+ */
+bool benchmark_save_reload(std::size_t N)
+{
+  typedef andromeda::base_types::hash_type hash_type;
+  typedef andromeda::base_types::flvr_type flvr_type;
+
+  typedef andromeda::glm::model model_type;
+  typedef andromeda::glm::io_base io_type;
+
+  typedef typename model_type::node_type node_type;
+
+  flvr_type node_flvr = andromeda::glm::node_names::WORD_TOKEN;
+  flvr_type edge_flvr = andromeda::glm::edge_names::next;
+
+  std::size_t M = std::max(std::size_t(64), N/16);
+  LOG_S(INFO) << "benchmarking save-reload with " << N << " edges over " << M << " nodes";
+
+  auto model_ptr = create_synthetic_model(N, M);
+  model_ptr->seal();
+
+  // the text and counters of every word, and the counts of its outgoing edges (times `times`)
+  auto get_state = [&](std::shared_ptr<model_type> ptr, std::size_t times)
+  {
+    std::vector<std::string> state={};
+
+    const auto& nodes = ptr->get_nodes();
+    for(std::size_t i=0; i<M; i++)
+      {
+        hash_type hash = node_type(node_flvr, "word-"+std::to_string(i)).get_hash();
+
+        node_type node;
+        if(not nodes.get(hash, node))
+          {
+            state.push_back("missing");
+            continue;
+          }
+
+        std::size_t num_edges=0, sum_edges=0;
+        for(const auto edge:ptr->get_edges().traverse(edge_flvr, hash))
+          {
+            num_edges += 1;
+            sum_edges += times*edge.get_count();
+          }
+
+        state.push_back(node.get_text()+","+std::to_string(times*node.get_word_cnt())+","+
+                        std::to_string(times*node.get_sent_cnt())+","+std::to_string(times*node.get_text_cnt())+","+
+                        std::to_string(times*node.get_tabl_cnt())+","+std::to_string(times*node.get_fdoc_cnt())+","+
+                        std::to_string(num_edges)+","+std::to_string(sum_edges));
+      }
+
+    return state;
+  };
+
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "glm-benchmark-save-reload";
+
+  auto save = [&](std::shared_ptr<model_type> ptr, int version)
+  {
+    nlohmann::json config = nlohmann::json::object({});
+    config[io_type::io_lbl][io_type::save_lbl][io_type::root_lbl] = root.string();
+    config[io_type::io_lbl][io_type::save_lbl][io_type::format_lbl] = version;
+
+    andromeda::glm::model_op<andromeda::glm::SAVE> io;
+    io.from_config(config);
+
+    return io.save(ptr);
+  };
+
+  auto load = [&](bool memory_map, std::shared_ptr<model_type> ptr, bool incremental)
+  {
+    nlohmann::json config = nlohmann::json::object({});
+    config[io_type::io_lbl][io_type::load_lbl][io_type::root_lbl] = root.string();
+    config[io_type::io_lbl][io_type::load_lbl][io_type::mmap_lbl] = memory_map;
+
+    andromeda::glm::model_op<andromeda::glm::LOAD> io;
+    io.from_config(config);
+    io.set_incremental(incremental);
+
+    return (io.load(ptr)? ptr: NULL);
+  };
+
+  std::vector<std::string> reference = get_state(model_ptr, 1);
+  std::vector<std::string> doubled = get_state(model_ptr, 2);
+
+  std::vector<std::string> header = {"format", "memory-map", "loaded", "after save", "reloaded", "incremental"};
+  std::vector<std::vector<std::string> > data={};
+
+  std::size_t failures=0;
+  for(int version:{1, 2, 3})
+    {
+      for(bool memory_map:{true, false})
+        {
+          std::filesystem::remove_all(root);
+          std::filesystem::create_directories(root);
+
+          std::vector<std::string> row = {"v"+std::to_string(version), memory_map? "yes":"no"};
+
+          auto check = [&](std::shared_ptr<model_type> ptr, const std::vector<std::string>& expected)
+          {
+            bool identical = (ptr!=NULL and get_state(ptr, 1)==expected);
+
+            failures += (identical? 0:1);
+            row.push_back(identical? "identical":"differs");
+          };
+
+          save(model_ptr, version);
+
+          auto loaded = load(memory_map, std::make_shared<model_type>(), false);
+          check(loaded, reference);
+
+          if(loaded!=NULL)
+            {
+              save(loaded, version);
+              check(loaded, reference);
+
+              loaded.reset();
+              check(load(memory_map, std::make_shared<model_type>(), false), reference);
+
+              auto twice = load(memory_map, std::make_shared<model_type>(), false);
+              check(twice==NULL? NULL: load(memory_map, twice, true), doubled);
+            }
+
+          data.push_back(row);
+        }
+    }
+
+  std::filesystem::remove_all(root);
+
+  LOG_S(INFO) << andromeda::utils::to_string("save into the directory of the loaded model", header, data);
+
+  if(failures>0)
+    {
+      LOG_S(ERROR) << failures << " models differ from the saved one!";
+    }
+
+  return (failures==0);
+}
+
+bool parse_arguments(int argc, char *argv[], nlohmann::json& config)
+{
+  cxxopts::Options options("glm-benchmark", "GLM benchmarks");
+
+  options.add_options()
+    ("m,mode", "mode [hash-index, traverse, merge, load, create-scaling, serve, compact, snapshot, admission, term-index, save-reload]",
+     cxxopts::value<std::string>()->default_value("hash-index"))
+    ("n,number", "number of entries (maximum number of threads for create-scaling, threads for admission)",
+     cxxopts::value<std::size_t>()->default_value("10000000"))
+    ("i,input", "input directory for create-scaling (default: data/documents)",
+     cxxopts::value<std::string>()->default_value(""))
+    ("h,help", "print usage");
+
+  auto result = options.parse(argc, argv);
+
+  if(result.count("help")==1)
+    {
+      LOG_S(INFO) << options.help();
+      return false;
+    }
+
+  config["mode"] = result["mode"].as<std::string>();
+  config["number"] = result["number"].as<std::size_t>();
+  config["input"] = result["input"].as<std::string>();
+
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  loguru::init(argc, argv);
+
+  nlohmann::json args;
+  if(not parse_arguments(argc, argv, args))
+    {
+      return -1;
+    }
+
+  std::string mode = args["mode"].get<std::string>();
+  LOG_S(INFO) << "mode: " << mode;
+
+  // the modes that check their results fail the run on a mismatch
+  bool success=true;
+
+  if(mode=="hash-index")
+    {
+      benchmark_hash_index(args["number"].get<std::size_t>());
+    }
+  else if(mode=="traverse")
+    {
+      benchmark_traverse(args["number"].get<std::size_t>());
+    }
+  else if(mode=="merge")
+    {
+      benchmark_merge(args["number"].get<std::size_t>());
+    }
+  else if(mode=="load")
+    {
+      benchmark_load(args["number"].get<std::size_t>());
+    }
+  else if(mode=="create-scaling")
+    {
+      benchmark_create_scaling(args["input"].get<std::string>(),
+                               std::min(args["number"].get<std::size_t>(), std::size_t(32)));
+    }
+  else if(mode=="serve")
+    {
+      benchmark_serve(args["number"].get<std::size_t>());
+    }
+  else if(mode=="compact")
+    {
+      success = benchmark_compact(args["number"].get<std::size_t>());
+    }
+  else if(mode=="snapshot")
+    {
+      success = benchmark_snapshot(args["number"].get<std::size_t>());
+    }
+  else if(mode=="admission")
+    {
+      benchmark_admission(args["input"].get<std::string>(), args["number"].get<std::size_t>());
+    }
+  else if(mode=="term-index")
+    {
+      benchmark_term_index(args["number"].get<std::size_t>());
+    }
+  else if(mode=="save-reload")
+    {
+      success = benchmark_save_reload(args["number"].get<std::size_t>());
+    }
+  else
+    {
+      LOG_S(ERROR) << "unknown benchmark mode: " << mode;
+      return -1;
+    }
+
+  return (success? 0: -1);
+}
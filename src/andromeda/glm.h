@@ -84,6 +84,11 @@ namespace andromeda
         configs.push_back(explorer.to_config());
       }
 
+      {
+        glm::model_cli<glm::SERVE, glm_model_type> server(model);
+        configs.push_back(server.to_config());
+      }
+
       return configs;
     }
 
@@ -104,7 +109,17 @@ namespace andromeda
           creator.create(producer);
         }
 
-      if(glm::io_base::has_save(config))
+      // the created model is a delta for the model in `io.load.root`
+      if(glm::model_op<glm::APPEND>::has_append(config))
+        {
+          glm::model_op<glm::APPEND> io;
+
+          if(io.from_config(config))
+            {
+              io.append(model);
+            }
+        }
+      else if(glm::io_base::has_save(config))
         {
           glm::model_op<glm::SAVE> io;
 	  
@@ -229,6 +244,31 @@ namespace andromeda
       explorer.interactive();
     }
 
+    template<typename glm_model_type>
+    void serve_glm_model(nlohmann::json& config, std::shared_ptr<glm_model_type> model)
+    {
+      if(glm::io_base::has_load(config))
+        {
+          glm::model_op<glm::LOAD> io;
+
+	  io.from_config(config);
+	  io.set_incremental(false);
+
+	  if(not io.load(model))
+	    {
+	      return;
+	    }
+        }
+      else
+        {
+          LOG_S(WARNING) << "`io.load.root` is required to serve a model";
+          return;
+        }
+
+      glm::model_cli<glm::SERVE, glm_model_type> server(model, config);
+      server.serve();
+    }
+
   }
 
 }
@@ -5,9 +5,17 @@
 
 #include <andromeda/glm/model/base.h>
 
+#include <andromeda/glm/model/utils/binary.h>
+#include <andromeda/glm/model/utils/mmap_file.h>
+#include <andromeda/glm/model/utils/parallel.h>
+#include <andromeda/glm/model/utils/hash_index.h>
+
 #include <andromeda/glm/model/nodes.h>
 #include <andromeda/glm/model/edges.h>
 
+#include <andromeda/glm/model/utils/text_index.h>
+#include <andromeda/glm/model/utils/term_index.h>
+
 #include <andromeda/glm/model/utils/parameters.h>
 #include <andromeda/glm/model/utils/topology.h>
 
@@ -26,6 +34,9 @@ namespace andromeda
       typedef glm_nodes nodes_type;
       typedef glm_edges edges_type;
 
+      typedef glm_text_index text_index_type;
+      typedef glm_term_index term_index_type;
+
       typedef typename glm_nodes::node_type node_type;
       typedef typename glm_edges::edge_type edge_type;
     };
@@ -52,6 +63,18 @@ namespace andromeda
       nodes_type& get_nodes() { return nodes; }
       edges_type& get_edges() { return edges; }
 
+      text_index_type& get_text_index() { return text_index; }
+      term_index_type& get_term_index() { return term_index; }
+
+      const parameters_type& get_parameters() const { return parameters; }
+      const topology_type& get_topology() const { return topology; }
+
+      const nodes_type& get_nodes() const { return nodes; }
+      const edges_type& get_edges() const { return edges; }
+
+      const text_index_type& get_text_index() const { return text_index; }
+      const term_index_type& get_term_index() const { return term_index; }
+
       std::vector<node_type>& get_nodes(flvr_type flvr) { return nodes.at(flvr); }
       
       bool configure(nlohmann::json& config, bool verbose);
@@ -61,7 +84,22 @@ namespace andromeda
       bool initialise(index_type reserved_nodes,
 		      index_type reserved_edges);
 
+      void reset();
+
       bool finalise(bool compute_topo=true);
+
+      // sorts and freezes the edges, after which lookups on a const model never write
+      void seal();
+      bool is_sealed() const { return edges.is_sealed(); }
+
+      // a read-only view that any number of threads can query concurrently
+      static std::shared_ptr<const model> snapshot(std::shared_ptr<model> model_ptr);
+
+      // seals the model and packs the nodes and edge-counts in narrow columns
+      void pack();
+
+      // the resident memory of the nodes, edges and indexes (in bytes)
+      std::size_t memory_size() const;
       
     private:
       
@@ -70,6 +108,10 @@ namespace andromeda
       
       nodes_type nodes;
       edges_type edges;
+
+      // optional, see `model_op<LOAD>`
+      text_index_type text_index;
+      term_index_type term_index;
     };
 
     model::model():
@@ -77,7 +119,10 @@ namespace andromeda
       topology(),
       
       nodes(),
-      edges()
+      edges(),
+
+      text_index(),
+      term_index()
     {}
 
     model::model(nlohmann::json config, bool verbose):
@@ -85,7 +130,10 @@ namespace andromeda
       topology(),
       
       nodes(),
-      edges()
+      edges(),
+
+      text_index(),
+      term_index()
     {}    
         
     model::model(parameters_type& params):
@@ -93,7 +141,10 @@ namespace andromeda
       topology(),
       
       nodes(),
-      edges()
+      edges(),
+
+      text_index(),
+      term_index()
     {}    
 
     model::~model()
@@ -124,11 +175,23 @@ namespace andromeda
       return true;
     }
     
+    /* empties the model, but keeps its memory for a refill of similar size */
+    void model::reset()
+    {
+      nodes.reset();
+      edges.reset();
+
+      text_index.clear();
+      term_index.clear();
+    }
+
     bool model::finalise(bool compute_topo)
     {
       nodes.sort();
       edges.sort();
 
+      edges.freeze();
+
       if(compute_topo)
 	{
 	  topology.compute(*this);
@@ -136,6 +199,53 @@ namespace andromeda
       
       return true;
     }
+
+    void model::seal()
+    {
+      if(edges.is_sealed())
+        {
+          return;
+        }
+
+      edges.sort();
+      edges.freeze();
+    }
+
+    /*
+     * Seals the model in place (no copy) and hands it out as const. The
+     * const interface of the nodes, edges and indexes has no lazy sorting
+     * or freezing, so the snapshot can be shared by the query threads
+     * without any locking. The caller must not modify `model_ptr` anymore.
+     */
+    std::shared_ptr<const model> model::snapshot(std::shared_ptr<model> model_ptr)
+    {
+      if(model_ptr==NULL)
+        {
+          return NULL;
+        }
+
+      model_ptr->seal();
+
+      return model_ptr;
+    }
+
+    /*
+     * Packing only pays off for a model that is queried, not modified: any
+     * update materialises the packed nodes and counts again.
+     */
+    void model::pack()
+    {
+      seal();
+
+      nodes.pack();
+      edges.pack_counts();
+    }
+
+    std::size_t model::memory_size() const
+    {
+      return (nodes.memory_size() + edges.memory_size() +
+              text_index.memory_size() + term_index.memory_size());
+    }
     
   }
 
@@ -5,6 +5,10 @@
 
 #include <andromeda/glm/model/edges/base.h>
 #include <andromeda/glm/model/edges/base_edge.h>
+#include <andromeda/glm/model/edges/edge_coll.h>
+#include <andromeda/glm/model/edges/adjacency.h>
+#include <andromeda/glm/model/edges/edge_range.h>
+#include <andromeda/glm/model/edges/edge_columns.h>
 
 namespace andromeda
 {
@@ -19,36 +23,46 @@ namespace andromeda
       typedef base_edge edge_type;
 
       typedef std::pair<flvr_type, ind_type> key_type;
+      typedef std::pair<hash_type, key_type> index_item_type;
 
-      typedef          std::vector<edge_type>   edge_coll_type;
-      typedef typename edge_coll_type::iterator edge_itr_type;
+      typedef          glm_edge_coll                  edge_coll_type;
+      typedef typename edge_coll_type::const_iterator edge_itr_type;
 
       typedef std::map<flvr_type, edge_coll_type> flvr_map_type;
       typedef typename flvr_map_type::iterator    flvr_itr_type;
 
-      typedef std::unordered_map<hash_type, key_type> hash_map_type;
+      typedef glm_hash_index hash_map_type;
+
+      typedef glm_adjacency adjacency_type;
+      typedef glm_edge_range range_type;
+
+      typedef glm_edge_columns columns_type;
 
     public:
 
       glm_edges();
+
+      // the adjacencies are views into the collections, a copy would point into the original
+      glm_edges(const glm_edges&) = delete;
+      glm_edges& operator=(const glm_edges&) = delete;
       ~glm_edges();
 
       double load_factor() { return hash_to_key.load_factor(); }
       double max_load_factor() { return hash_to_key.max_load_factor(); }
 
-      std::size_t number_of_flavors() { return flvr_colls.size(); }
+      std::size_t number_of_flavors() { return (is_mapped()? mapped_colls.size(): flvr_colls.size()); }
 
-      std::size_t size() { return hash_to_key.size(); }
-      std::size_t size(flvr_type flvr) { return flvr_colls.at(flvr).size(); }
+      std::size_t size() const { return hash_to_key.size(); }
+      std::size_t size(flvr_type flvr);
 
-      edge_type& at(key_type key) { return flvr_colls.at(key.first).at(key.second); }
-      edge_coll_type& at(flvr_type flvr) { return flvr_colls.at(flvr); }
+      edge_type at(key_type key) { materialise(); return flvr_colls.at(key.first).at(key.second); }
+      edge_coll_type& at(flvr_type flvr) { materialise(); return flvr_colls.at(flvr); }
 
-      flvr_itr_type begin() { return flvr_colls.begin(); }
-      flvr_itr_type end() { return flvr_colls.end(); }
+      flvr_itr_type begin() { materialise(); return flvr_colls.begin(); }
+      flvr_itr_type end() { materialise(); return flvr_colls.end(); }
 
-      edge_itr_type begin(flvr_type flvr) { return flvr_colls.at(flvr).begin(); }
-      edge_itr_type end(flvr_type flvr) { return flvr_colls.at(flvr).end(); }
+      edge_itr_type begin(flvr_type flvr) { materialise(); return flvr_colls.at(flvr).begin(); }
+      edge_itr_type end(flvr_type flvr) { materialise(); return flvr_colls.at(flvr).end(); }
 
       void show_bucket_distribution();
 
@@ -56,40 +70,106 @@ namespace andromeda
       void reserve(std::size_t N);
 
       void initialise();
+      void reset();
 
-      edge_type& push_back(edge_type& edge, bool update_hashmap);
+      void push_back(const edge_type& edge, bool update_hashmap);
 
-      bool has(flvr_type flavor);
-      bool has(const edge_type& edge);
+      bool has(flvr_type flavor) const;
+      bool has(const edge_type& edge) const;
 
-      bool has(flvr_type flavor, hash_type hash_i, hash_type hash_j);
+      bool has(flvr_type flavor, hash_type hash_i, hash_type hash_j) const;
 
-      bool get(hash_type& hash, edge_type& edge);
+      bool get(hash_type& hash, edge_type& edge) const;
 
-      edge_type& insert(edge_type& edge, bool check_size);
+      void insert(const edge_type& edge, bool check_size);
 
-      edge_type& insert(flvr_type flavor, hash_type hash_i, hash_type hash_j,
-                        bool check_size);
+      void insert(flvr_type flavor, hash_type hash_i, hash_type hash_j,
+                  bool check_size);
 
-      edge_type& insert(flvr_type flavor, hash_type hash_i, hash_type hash_j,
-                        cnt_type count, bool check_size);
+      void insert(flvr_type flavor, hash_type hash_i, hash_type hash_j,
+                  cnt_type count, bool check_size);
 
       void init_hashmap();
       
       void sort();
       void sort(flvr_type flvr);
 
-      bool is_sorted(flvr_type flvr);
+      void merge(glm_edges& other);
+      void merge(flvr_type flvr, edge_coll_type other_coll);
+
+      template<typename predicate_type>
+      void compact(predicate_type keep, std::size_t num_threads);
+
+      bool is_sorted(flvr_type flvr) const;
       void set_sorted(flvr_type flvr, bool sorted);
 
+      void freeze();
+      void freeze(flvr_type flvr);
+
+      bool is_frozen() const;
+
+      // every flavor is sorted and frozen, so the const lookups see all edges
+      bool is_sealed() const;
+      bool is_frozen(flvr_type flvr) const { return (flvr_adjacency.count(flvr)==1); }
+      void unfreeze(flvr_type flvr) { flvr_adjacency.erase(flvr); }
+
+      // narrow counts for edges that do not change anymore, `materialise` unpacks them
+      void pack_counts();
+      bool is_packed() const { return packed; }
+
+      // the heap memory of the index, the collections and the adjacencies
+      std::size_t memory_size() const;
+
       std::pair<cnt_type, cnt_type> get_number_of_edges(flvr_type flavor,
                                                         hash_type hash_i);
 
-      edge_itr_type traverse(flvr_type flavor, hash_type hash_i);
+      range_type traverse(flvr_type flavor, hash_type hash_i);
 
       cnt_type traverse(flvr_type flavor, hash_type hash_i,
                         std::vector<edge_type>& edges, bool sorted);
 
+      // read-only lookups: they do not sort or freeze, so unsorted or unfrozen flavors are empty
+      std::pair<cnt_type, cnt_type> get_number_of_edges(flvr_type flavor,
+                                                        hash_type hash_i) const;
+
+      range_type traverse(flvr_type flavor, hash_type hash_i) const;
+
+      cnt_type traverse(flvr_type flavor, hash_type hash_i,
+                        std::vector<edge_type>& edges, bool sorted) const;
+
+      bool is_mapped() const { return (mapped_file!=NULL); }
+
+      void write(std::ofstream& ofs);
+      bool attach(std::shared_ptr<glm_mmap_file> file);
+
+      void write_compressed(std::ofstream& ofs);
+      bool read_compressed(std::shared_ptr<glm_mmap_file> file);
+
+      template<typename visit_type>
+      std::size_t write_appended(std::ofstream& ofs, glm_edges& delta, visit_type visit);
+
+      void materialise();
+
+    private:
+
+      edge_coll_type& get_coll(flvr_type flvr);
+
+      const adjacency_type* get_adjacency(flvr_type flvr);
+      const adjacency_type* find_adjacency(flvr_type flvr) const;
+
+      void build_adjacency(flvr_type flvr, adjacency_type& adj);
+
+      void unpack_counts();
+
+      std::vector<index_item_type> sort_coll(flvr_type flvr, std::size_t num_threads);
+
+      void normalise(flvr_type flvr, std::size_t num_threads=1);
+      static void normalise(edge_coll_type& coll, std::size_t beg, std::size_t end);
+
+      template<typename source_type>
+      static void append(const source_type& lhs, const edge_coll_type& rhs,
+                         edge_coll_type& result);
+
     private:
 
       std::size_t max_allowed_size;
@@ -98,10 +178,24 @@ namespace andromeda
 
       flvr_map_type flvr_colls;
       hash_map_type hash_to_key;
+
+      std::map<flvr_type, adjacency_type> flvr_adjacency;
+
+      // the counts of all collections are packed
+      bool packed;
+
+      // read-only columns of a memory-mapped v2 binary (see `attach`)
+      std::shared_ptr<glm_mmap_file> mapped_file;
+      std::map<flvr_type, columns_type> mapped_colls;
     };
 
     glm_edges::glm_edges():
-      max_allowed_size(-1)
+      max_allowed_size(-1),
+
+      packed(false),
+
+      mapped_file(NULL),
+      mapped_colls({})
     {
       initialise();
     }
@@ -114,7 +208,7 @@ namespace andromeda
       std::map<std::size_t, std::size_t> cnt={};
       for(std::size_t i=0; i<hash_to_key.bucket_count(); i++)
         {
-          std::size_t n=hash_to_key.bucket_size(i);
+          std::size_t n=hash_to_key.probe_length(i);
           if(n>0)
             {
               auto itr = cnt.find(n);
@@ -129,7 +223,7 @@ namespace andromeda
             }
         }
 
-      LOG_S(INFO) << __FUNCTION__ << " (bucket-size versus count): " << hash_to_key.max_load_factor();
+      LOG_S(INFO) << __FUNCTION__ << " (probe-length versus count): " << hash_to_key.load_factor();
       if(cnt.size()>0)
         {
           for(auto itr=cnt.begin(); itr!=cnt.end(); itr++)
@@ -143,19 +237,78 @@ namespace andromeda
     {
       hash_to_key.clear();
       flvr_colls.clear();
+
+      flvr_adjacency.clear();
+      packed = false;
+
+      mapped_colls.clear();
+      mapped_file.reset();
+    }
+
+    std::size_t glm_edges::size(flvr_type flvr)
+    {
+      if(is_mapped())
+        {
+          return mapped_colls.at(flvr).size();
+        }
+
+      return flvr_colls.at(flvr).size();
     }
 
     void glm_edges::initialise()
     {
       clear();
 
-      reserve(1e7);
+      reserve(1e5);
+    }
+
+    /*
+     * Empties all flavors, but keeps the memory of the columns and the index
+     * at the size they needed so far. Flavors that held far less than they
+     * could are shrunk, so the reserved memory follows the observed sizes.
+     */
+    void glm_edges::reset()
+    {
+      if(is_mapped())
+        {
+          initialise();
+          return;
+        }
+
+      unpack_counts();
+
+      std::size_t total = size();
+
+      // nothing was observed since the last reset (eg after spilling)
+      if(total==0)
+        {
+          return;
+        }
+
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          auto& coll = itr->second;
+
+          std::size_t num = coll.size();
+          coll.clear();
+
+          if(coll.capacity()>2*num+1e3)
+            {
+              coll.shrink_to_fit();
+              coll.reserve(num+1e3);
+            }
+
+          flvr_sorted[itr->first] = false;
+        }
+
+      flvr_adjacency.clear();
+
+      hash_to_key.reset(total);
     }
 
     void glm_edges::reserve(std::size_t N)
     {
       hash_to_key.reserve(N);
-      hash_to_key.max_load_factor(32.0);
 
       //for(auto item:edge_names::flvr_to_name_map)
       for(auto itr=edge_names::begin(); itr!=edge_names::end(); itr++)
@@ -165,81 +318,117 @@ namespace andromeda
           if(flvr!=edge_names::UNKNOWN_FLVR)
             {
               flvr_sorted[flvr]=false;
-              flvr_colls[flvr].reserve(1e3);
+              get_coll(flvr).reserve(1e3);
             }
         }
     }
 
-    typename glm_edges::edge_type& glm_edges::push_back(edge_type& edge, bool update_hashmap)
+    typename glm_edges::edge_coll_type& glm_edges::get_coll(flvr_type flvr)
     {
-      flvr_type flvr = edge.get_flvr();
-      hash_type hash = edge.get_hash();
-
-      if(flvr_colls.count(flvr)==0)
+      auto itr = flvr_colls.find(flvr);
+      if(itr==flvr_colls.end())
         {
-          flvr_colls[flvr].reserve(1e3);
+          itr = flvr_colls.emplace(flvr, edge_coll_type(flvr)).first;
+          (itr->second).reserve(1e3);
         }
 
-      auto& flvr_coll = flvr_colls.at(flvr);
+      return itr->second;
+    }
+
+    void glm_edges::push_back(const edge_type& edge, bool update_hashmap)
+    {
+      materialise();
+
+      flvr_type flvr = edge.get_flvr();
+      hash_type hash = edge.get_hash();
+
+      auto& flvr_coll = get_coll(flvr);
 
       if(update_hashmap)
 	{
 	  ind_type ind = flvr_coll.size();
 	  key_type key(flvr, ind);
 	  
-	  hash_to_key.insert(std::make_pair(hash, key));
+	  hash_to_key.insert(hash, key);
 	}
       
       flvr_coll.push_back(edge);
       flvr_sorted[flvr]=false;
 
-      return flvr_coll.back();
+      if(flvr_adjacency.size()>0)
+        {
+          unfreeze(flvr);
+        }
     }
 
-    bool glm_edges::has(flvr_type flavor)
+    bool glm_edges::has(flvr_type flavor) const
     {
+      if(is_mapped())
+        {
+          return (mapped_colls.count(flavor)==1);
+        }
+
       return (flvr_colls.count(flavor)==1);
     }
 
-    bool glm_edges::has(const edge_type& edge)
+    bool glm_edges::has(const edge_type& edge) const
     {
-      auto itr = hash_to_key.find(edge.get_hash());
-      return (itr!=hash_to_key.end() and itr->first==edge.get_hash());
+      return (hash_to_key.count(edge.get_hash())>0);
     }
 
-    bool glm_edges::has(flvr_type flvr, hash_type hash_i, hash_type hash_j)
+    bool glm_edges::has(flvr_type flvr, hash_type hash_i, hash_type hash_j) const
     {
       edge_type edge(flvr, hash_i, hash_j, 0);
       return has(edge);
     }
 
-    bool glm_edges::get(hash_type& hash, edge_type& edge)
+    bool glm_edges::get(hash_type& hash, edge_type& edge) const
     {
-      auto itr = hash_to_key.find(hash);
+      key_type key;
 
-      if(itr!=hash_to_key.end() and itr->first==hash)
+      if(hash_to_key.find(hash, key))
         {
-          edge = this->at(itr->second);
+          if(is_mapped())
+            {
+              mapped_colls.at(key.first).get(key.second, edge);
+              return true;
+            }
+
+          edge = flvr_colls.at(key.first)[key.second];
           return true;
         }
 
       return false;
     }
 
-    typename glm_edges::edge_type& glm_edges::insert(edge_type& other, bool check_size)
+    void glm_edges::insert(const edge_type& other, bool check_size)
     {
-      auto itr = hash_to_key.find(other.get_hash());
+      materialise();
 
-      if(itr!=hash_to_key.end() and itr->first==other.get_hash())
+      key_type key;
+
+      if(hash_to_key.find(other.get_hash(), key))
         {
-          auto& edge = this->at(itr->second);
-          edge.update(other);
+          auto& coll = flvr_colls.at(key.first);
+
+          if(coll.get_hash_i(key.second)==other.get_hash_i() and
+             coll.get_hash_j(key.second)==other.get_hash_j())
+            {
+              coll.add_count(key.second, other.get_count());
+            }
+          else
+            {
+              LOG_S(ERROR) << "updating wrong edge (with same hash) ... ";
+            }
 
-          return edge;
+          if(flvr_adjacency.size()>0)
+            {
+              unfreeze(key.first);
+            }
         }
       else if((not check_size) or size()<max_allowed_size)
         {
-          return push_back(other, true);
+          push_back(other, true);
         }
       else
         {
@@ -250,37 +439,96 @@ namespace andromeda
               LOG_S(WARNING) << "exceeding reserved edge-size (" << max_allowed_size << ")";
               warned=true;
             }
-
-          return other;
         }
     }
 
-    typename glm_edges::edge_type& glm_edges::insert(flvr_type flvr, hash_type hash_i, hash_type hash_j,
-                                                     bool check_size)
+    void glm_edges::insert(flvr_type flvr, hash_type hash_i, hash_type hash_j,
+                           bool check_size)
     {
-      return this->insert(flvr, hash_i, hash_j, 1, check_size);
+      this->insert(flvr, hash_i, hash_j, 1, check_size);
     }
 
-    typename glm_edges::edge_type& glm_edges::insert(flvr_type flvr, hash_type hash_i, hash_type hash_j,
-                                                     cnt_type count, bool check_size)
+    void glm_edges::insert(flvr_type flvr, hash_type hash_i, hash_type hash_j,
+                           cnt_type count, bool check_size)
     {
       edge_type edge(flvr, hash_i, hash_j, count);
-      return insert(edge, check_size);
+      insert(edge, check_size);
+    }
+
+    /*
+     * Removes in place all edges for which `keep(edge)` is false. The
+     * flavors are filtered in parallel and the hash index is rebuilt once.
+     * Filtering keeps the order, so sorted flavors stay sorted, but their
+     * probabilities need to be renormalised.
+     */
+    template<typename predicate_type>
+    void glm_edges::compact(predicate_type keep, std::size_t num_threads)
+    {
+      materialise();
+
+      flvr_adjacency.clear();
+
+      std::vector<flvr_type> flvrs={};
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          flvrs.push_back(itr->first);
+        }
+
+      glm_parallel::for_each(flvrs.size(), num_threads, [&](std::size_t l)
+      {
+        auto& coll = flvr_colls.at(flvrs.at(l));
+
+        coll.erase_if([&keep](const edge_type& edge) { return (not keep(edge)); });
+        coll.shrink_to_fit();
+      });
+
+      std::size_t total=0;
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          total += (itr->second).size();
+        }
+
+      hash_to_key.clear();
+      hash_to_key.reserve(total);
+
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          auto& coll = itr->second;
+          for(std::size_t ind=0; ind<coll.size(); ind++)
+            {
+              hash_to_key.insert(coll.get_hash(ind), key_type({itr->first, ind}));
+            }
+        }
+
+      std::vector<flvr_type> sorted_flvrs={};
+      for(flvr_type flvr:flvrs)
+        {
+          if(is_sorted(flvr))
+            {
+              sorted_flvrs.push_back(flvr);
+            }
+        }
+
+      glm_parallel::for_each(sorted_flvrs.size(), num_threads, [&](std::size_t l)
+      {
+        normalise(sorted_flvrs.at(l));
+      });
     }
 
-    bool glm_edges::is_sorted(flvr_type flvr)
+    bool glm_edges::is_sorted(flvr_type flvr) const
     {
+      if(is_mapped())
+        {
+          return (mapped_colls.count(flvr)==1 and mapped_colls.at(flvr).is_sorted());
+        }
+
+      // a flavor without an entry was never sorted
       auto itr = flvr_sorted.find(flvr);
 
       if(itr!=flvr_sorted.end() and flvr_colls.count(flvr)>0)
         {
           return (itr->second);
         }
-      else if(itr==flvr_sorted.end() and flvr_colls.count(flvr)>0)
-        {
-          flvr_sorted[flvr]=false;
-          return flvr_sorted.at(flvr);
-        }
       else
         {
           return false;
@@ -289,6 +537,8 @@ namespace andromeda
 
     void glm_edges::set_sorted(flvr_type flvr, bool sorted)
     {
+      materialise();
+
       if(flvr_colls.count(flvr)>0)
         {
           flvr_sorted[flvr] = sorted;
@@ -301,6 +551,13 @@ namespace andromeda
 
     void glm_edges::sort(flvr_type flvr)
     {
+      if(is_mapped() and is_sorted(flvr))
+        {
+          return;
+        }
+
+      materialise();
+
       if(flvr_sorted.count(flvr)==0)
         {
           flvr_sorted[flvr] = false;
@@ -318,167 +575,1014 @@ namespace andromeda
           return;
         }
 
-      auto& coll = flvr_colls.at(flvr);
+      unfreeze(flvr);
 
-      if(coll.size()>0)
+      for(auto& item:sort_coll(flvr, 1))
         {
-          LOG_S(INFO) << "sorting edge [" << std::setw(20) << edge_names::to_name(flvr) << "]: "
-                      << std::setw(12) << coll.size();
+          hash_to_key.assign(item.first, item.second);
         }
+    }
 
-      {
-        std::sort(coll.begin(), coll.end());
+    /*
+     * Sorts a single flavor with `num_threads` threads, updates its keys in
+     * the hash index and computes the probabilities. Since the index can
+     * not grow concurrently, the (rare) hashes that were not yet indexed
+     * are returned, so that the caller can insert them afterwards.
+     */
+    std::vector<typename glm_edges::index_item_type> glm_edges::sort_coll(flvr_type flvr,
+                                                                          std::size_t num_threads)
+    {
+      auto& coll = flvr_colls.at(flvr);
 
-        for(std::size_t ind=0; ind<coll.size(); ind++)
-          {
-            edge_type& edge = coll.at(ind);
+      auto t0 = std::chrono::system_clock::now();
 
-            flvr_type flvr = edge.get_flvr();
-            hash_type hash = edge.get_hash();
+      coll.sort(edge_coll_type::BY_COUNT, num_threads);
 
-            hash_to_key.at(hash) = key_type({flvr, ind});
-          }
-      }
+      auto t1 = std::chrono::system_clock::now();
+
+      std::vector<std::size_t> bounds = glm_parallel::split(coll.size(), num_threads);
+      std::vector<std::vector<index_item_type> > missing(bounds.size()-1);
 
+      glm_parallel::for_each(bounds.size()-1, num_threads, [&](std::size_t l)
       {
-        auto edge_itr = coll.begin();
-        while(edge_itr!=coll.end())
+        for(std::size_t ind=bounds[l]; ind<bounds[l+1]; ind++)
           {
-            hash_type hash_i = edge_itr->get_hash_i();
+            hash_type hash = coll.get_hash(ind);
+            key_type key(flvr, ind);
 
-            val_type total=0.0;
-
-            auto tmp = edge_itr;
-            while(tmp!=coll.end() and
-                  tmp->get_hash_i()==hash_i)
+            if(not hash_to_key.update(hash, key))
               {
-                total += tmp->get_count();
-                tmp++;
+                missing[l].push_back({hash, key});
               }
+          }
+      });
 
-            while(edge_itr!=tmp)
-              {
-                val_type cnt = edge_itr->get_count();
-                val_type tot = total;
+      std::vector<index_item_type> result={};
+      for(auto& items:missing)
+        {
+          result.insert(result.end(), items.begin(), items.end());
+        }
 
-                edge_itr->set_prob(cnt/(tot+1.e-6));
-                edge_itr++;
-              }
-          }
-      }
+      auto t2 = std::chrono::system_clock::now();
+
+      normalise(flvr, num_threads);
+
+      auto t3 = std::chrono::system_clock::now();
 
       flvr_sorted.at(flvr)=true;
-    }
 
-    void glm_edges::sort()
+      if(coll.size()>0)
+        {
+          std::chrono::duration<double, std::milli> sort_time = t1-t0, index_time = t2-t1, prob_time = t3-t2;
+
+          LOG_S(INFO) << "sorting edge [" << std::setw(20) << edge_names::to_name(flvr) << "]: "
+                      << std::setw(12) << coll.size() << " (#-threads: " << num_threads << ", "
+                      << std::fixed << std::setprecision(1)
+                      << "sort: " << sort_time.count() << " ms, "
+                      << "index: " << index_time.count() << " ms, "
+                      << "prob: " << prob_time.count() << " ms)";
+        }
+
+      return result;
+    }
+    /*
+     * The probabilities are normalised per hash_i, so the ranges that are
+     * handed to the threads never split the edges of a single hash_i.
+     */
+    void glm_edges::normalise(flvr_type flvr, std::size_t num_threads)
     {
-      LOG_S(INFO) << __FUNCTION__;
+      auto& coll = flvr_colls.at(flvr);
 
-      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+      std::vector<std::size_t> bounds = glm_parallel::split(coll.size(), num_threads);
+      for(std::size_t l=1; l+1<bounds.size(); l++)
         {
-          sort(itr->first);
+          std::size_t& ind = bounds[l];
+
+          ind = std::max(ind, bounds[l-1]);
+          while(0<ind and ind<coll.size() and
+                coll.get_hash_i(ind)==coll.get_hash_i(ind-1))
+            {
+              ind++;
+            }
         }
+
+      glm_parallel::for_each(bounds.size()-1, num_threads, [&](std::size_t l)
+      {
+        normalise(coll, bounds[l], bounds[l+1]);
+      });
     }
 
-    void glm_edges::init_hashmap()
+    void glm_edges::normalise(edge_coll_type& coll, std::size_t beg, std::size_t end)
     {
-      LOG_S(INFO) << __FUNCTION__;
+      const hash_type* hash_i = coll.get_hash_i_column().data();
+      const cnt_type*  count = coll.get_count_column().data();
 
-      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+      std::size_t ind = beg;
+      while(ind<end)
         {
-	  flvr_type flvr = itr->first; 
-	  auto& flvr_coll = itr->second;
+          std::size_t last = ind;
+          while(last<end and hash_i[last]==hash_i[ind])
+            {
+              last++;
+            }
 
-	  LOG_S(INFO) << flvr << " [" << flvr_coll.size() << "]";
-	  for(std::size_t ind=0; ind<flvr_coll.size(); ind++)
-	    {
-	      assert(flvr==flvr_coll.at(ind).get_flvr());
+          val_type total=0.0;
+          for(std::size_t k=ind; k<last; k++)
+            {
+              total += count[k];
+            }
 
-	      key_type key(flvr, ind);
-	      hash_type hash = flvr_coll.at(ind).get_hash();
-	      
-	      hash_to_key[hash] = key;
-	    }
+          for(std::size_t k=ind; k<last; k++)
+            {
+              coll.set_prob(k, count[k]/(total+1.e-6));
+            }
+
+          ind = last;
         }
     }
-    
-    std::pair<typename glm_edges::cnt_type,
-              typename glm_edges::cnt_type> glm_edges::get_number_of_edges(flvr_type flvr,
-                                                                           hash_type hash_i)
+
+    void glm_edges::merge(glm_edges& other)
     {
-      if(flvr_sorted.count(flvr)==0 or (not flvr_sorted.at(flvr)))
-        {
-          sort(flvr);
-        }
+      LOG_S(INFO) << __FUNCTION__;
 
-      auto& coll = flvr_colls.at(flvr);
+      materialise();
 
-      edge_type edge(flvr, hash_i, 0, -1);
-      auto itr = std::lower_bound(coll.begin(), coll.end(), edge);
+      hash_to_key.reserve(size()+other.size());
 
-      cnt_type count=0, weight=0;
-      while(itr!=coll.end())
+      for(auto itr=other.begin(); itr!=other.end(); itr++)
         {
-          if(itr->get_hash_i()!=hash_i)
-            {
-              break;
-            }
-
-          count += 1;
-          weight += itr->get_count();
-
-          itr++;
+          merge(itr->first, itr->second);
         }
-
-      return std::pair<cnt_type, cnt_type>(count, weight);
     }
 
-    typename glm_edges::cnt_type glm_edges::traverse(flvr_type flvr, hash_type hash_i,
-                                                     std::vector<edge_type>& tmps, bool sorted)
+    /*
+     * Bulk merge: both sides are brought in (hash_i, hash_j) order, merged
+     * linearly while summing the counts and put back in the sorted order
+     * (descending count per source). The index is only updated once per
+     * edge and the flavor ends up sorted, so no re-sort is needed.
+     */
+    void glm_edges::merge(flvr_type flvr, edge_coll_type other_coll)
     {
-      tmps.clear();
+      materialise();
 
-      if(flvr_sorted.count(flvr)==0 or (not flvr_sorted.at(flvr)))
+      if(other_coll.size()==0)
         {
-          LOG_S(ERROR) << "flvr " << flvr << " is not sorted: aborting traversal ...";
-          return tmps.size();
+          return;
         }
 
-      if(flvr_colls.count(flvr)==0)
+      unfreeze(flvr);
+
+      auto& coll = get_coll(flvr);
+
+      if(coll.size()>0)
         {
-          LOG_S(WARNING) << "unknown flvr: " << flvr;
-          return tmps.size();
+          LOG_S(INFO) << "merging edge [" << std::setw(20) << edge_names::to_name(flvr) << "]: "
+                      << std::setw(12) << coll.size() << " + " << std::setw(12) << other_coll.size();
         }
 
-      auto& coll = flvr_colls.at(flvr);
+      edge_coll_type& rhs = other_coll;
+
+      coll.sort(edge_coll_type::BY_TARGET, 1);
+      rhs.sort(edge_coll_type::BY_TARGET, 1);
+
+      edge_coll_type result(flvr);
+      result.reserve(coll.size()+rhs.size());
 
-      std::size_t total=0;
       {
-        edge_type edge;
-	edge.set_lowerbound(flvr, hash_i);
-	
-        auto itr = std::lower_bound(coll.begin(), coll.end(), edge);
-        while(itr!=coll.end() and
-              itr->get_hash_i()==hash_i and
-              itr->get_hash_j()!=edge_names::UNKNOWN_HASH and
-              itr->get_count()>0)
+        std::size_t l=0, r=0;
+
+        while(l<coll.size() or r<rhs.size())
           {
-            tmps.push_back(*itr);
-            total += itr->get_count();
+            int cmp = 0;
+            if(r==rhs.size())
+              {
+                cmp = -1;
+              }
+            else if(l==coll.size())
+              {
+                cmp = 1;
+              }
+            else if(coll.get_hash_i(l)!=rhs.get_hash_i(r))
+              {
+                cmp = (coll.get_hash_i(l)<rhs.get_hash_i(r))? -1:1;
+              }
+            else if(coll.get_hash_j(l)!=rhs.get_hash_j(r))
+              {
+                cmp = (coll.get_hash_j(l)<rhs.get_hash_j(r))? -1:1;
+              }
 
-            itr++;
+            if(cmp<0)
+              {
+                result.push_back(coll.get_hash_i(l), coll.get_hash_j(l), coll.get_count(l));
+                l++;
+              }
+            else if(cmp>0)
+              {
+                result.push_back(rhs.get_hash_i(r), rhs.get_hash_j(r), rhs.get_count(r));
+                r++;
+              }
+            else
+              {
+                result.push_back(coll.get_hash_i(l), coll.get_hash_j(l),
+                                 coll.get_count(l)+rhs.get_count(r));
+                l++;
+                r++;
+              }
           }
       }
-      
-      for(auto& tmp:tmps)
+
+      // descending count per source as in `sort`, ties stay in hash_j order
+      result.sort(edge_coll_type::BY_COUNT, 1);
+
+      coll.swap(result);
+
+      for(std::size_t ind=0; ind<coll.size(); ind++)
+        {
+          hash_to_key.assign(coll.get_hash(ind), key_type({flvr, ind}));
+        }
+
+      normalise(flvr);
+
+      flvr_sorted[flvr] = true;
+    }
+
+    /*
+     * Sorts all flavors in parallel. Flavors that hold at least a share of
+     * 1/#-threads of the unsorted edges are sorted one after the other with
+     * all threads, the remaining ones concurrently with a thread each.
+     */
+    void glm_edges::sort()
+    {
+      LOG_S(INFO) << __FUNCTION__;
+
+      if(is_mapped())
         {
-          val_type cnt = tmp.get_count();
-          val_type tot = total;
+          bool all_sorted=true;
+          for(auto& item:mapped_colls)
+            {
+              all_sorted = (all_sorted and is_sorted(item.first));
+            }
 
-          tmp.set_prob(cnt/(tot+1.e-6));
+          if(all_sorted)
+            {
+              return;
+            }
         }
 
-      return tmps.size();
+      materialise();
+
+      std::size_t num_threads = glm_parallel::number_of_threads(0);
+
+      std::size_t total=0;
+      std::vector<flvr_type> flvrs={};
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          if(not is_sorted(itr->first))
+            {
+              unfreeze(itr->first);
+
+              flvrs.push_back(itr->first);
+              total += (itr->second).size();
+            }
+        }
+
+      std::vector<flvr_type> small_flvrs={};
+      for(flvr_type flvr:flvrs)
+        {
+          if(flvr_colls.at(flvr).size()*num_threads >= total and num_threads>1)
+            {
+              for(auto& item:sort_coll(flvr, num_threads))
+                {
+                  hash_to_key.assign(item.first, item.second);
+                }
+            }
+          else
+            {
+              small_flvrs.push_back(flvr);
+            }
+        }
+
+      std::vector<std::vector<index_item_type> > missing(small_flvrs.size());
+      glm_parallel::for_each(small_flvrs.size(), num_threads, [&](std::size_t l)
+      {
+        missing[l] = sort_coll(small_flvrs[l], 1);
+      });
+
+      for(auto& items:missing)
+        {
+          for(auto& item:items)
+            {
+              hash_to_key.assign(item.first, item.second);
+            }
+        }
+    }
+
+    /*
+     * The adjacencies of the flavors are built concurrently, their slots
+     * in `flvr_adjacency` are created up front.
+     */
+    void glm_edges::freeze()
+    {
+      // eg a mapped model that was saved frozen, which we do not materialise
+      if(is_frozen())
+        {
+          return;
+        }
+
+      LOG_S(INFO) << __FUNCTION__;
+
+      materialise();
+
+      std::vector<flvr_type> flvrs={};
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          if(is_sorted(itr->first) and (not is_frozen(itr->first)))
+            {
+              flvrs.push_back(itr->first);
+            }
+        }
+
+      std::vector<adjacency_type*> adjs={};
+      for(flvr_type flvr:flvrs)
+        {
+          adjs.push_back(&flvr_adjacency[flvr]);
+        }
+
+      glm_parallel::for_each(flvrs.size(), glm_parallel::number_of_threads(0), [&](std::size_t l)
+      {
+        build_adjacency(flvrs[l], *adjs[l]);
+      });
+    }
+
+    /*
+     * True if every sorted flavor has its adjacency. Once frozen, traversals
+     * only read the edges and can run concurrently.
+     */
+    bool glm_edges::is_frozen() const
+    {
+      std::vector<flvr_type> flvrs={};
+      if(is_mapped())
+        {
+          for(auto itr=mapped_colls.begin(); itr!=mapped_colls.end(); itr++)
+            {
+              flvrs.push_back(itr->first);
+            }
+        }
+      else
+        {
+          for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+            {
+              flvrs.push_back(itr->first);
+            }
+        }
+
+      for(flvr_type flvr:flvrs)
+        {
+          if(is_sorted(flvr) and (not is_frozen(flvr)))
+            {
+              return false;
+            }
+        }
+
+      return true;
+    }
+
+    bool glm_edges::is_sealed() const
+    {
+      std::vector<flvr_type> flvrs={};
+      if(is_mapped())
+        {
+          for(auto itr=mapped_colls.begin(); itr!=mapped_colls.end(); itr++)
+            {
+              flvrs.push_back(itr->first);
+            }
+        }
+      else
+        {
+          for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+            {
+              flvrs.push_back(itr->first);
+            }
+        }
+
+      for(flvr_type flvr:flvrs)
+        {
+          if(not (is_sorted(flvr) and is_frozen(flvr)))
+            {
+              return false;
+            }
+        }
+
+      return true;
+    }
+
+    void glm_edges::freeze(flvr_type flvr)
+    {
+      if(not is_sorted(flvr))
+        {
+          LOG_S(WARNING) << "edge-flvr " << flvr << " is not sorted: skip freezing ...";
+          return;
+        }
+
+      if(is_frozen(flvr))
+        {
+          return;
+        }
+
+      materialise();
+
+      build_adjacency(flvr, flvr_adjacency[flvr]);
+    }
+
+    void glm_edges::build_adjacency(flvr_type flvr, adjacency_type& adj)
+    {
+      auto& coll = flvr_colls.at(flvr);
+      adj.build(flvr, coll);
+
+      if(coll.size()>0)
+        {
+          LOG_S(INFO) << "freezing edge [" << std::setw(20) << edge_names::to_name(flvr) << "]: "
+                      << std::setw(12) << adj.number_of_sources() << " sources, "
+                      << std::setw(12) << adj.number_of_edges() << " edges ("
+                      << adj.memory_size()/1.e6 << " MB)";
+        }
+    }
+
+    /*
+     * Packs the counts of every collection in the smallest width that fits
+     * the flavor, the adjacencies are pointed at the packed counts. The
+     * columns of a mapped model are views into the binary and stay as they
+     * are.
+     */
+    void glm_edges::pack_counts()
+    {
+      if(packed or is_mapped())
+        {
+          return;
+        }
+
+      std::vector<flvr_type> flvrs={};
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          flvrs.push_back(itr->first);
+        }
+
+      glm_parallel::for_each(flvrs.size(), glm_parallel::number_of_threads(0), [&](std::size_t l)
+      {
+        flvr_colls.at(flvrs[l]).pack_counts();
+      });
+
+      for(auto itr=flvr_adjacency.begin(); itr!=flvr_adjacency.end(); itr++)
+        {
+          (itr->second).attach_counts(flvr_colls.at(itr->first));
+        }
+
+      packed = true;
+    }
+
+    void glm_edges::unpack_counts()
+    {
+      if(not packed)
+        {
+          return;
+        }
+
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          (itr->second).unpack_counts();
+        }
+
+      for(auto itr=flvr_adjacency.begin(); itr!=flvr_adjacency.end(); itr++)
+        {
+          (itr->second).attach_counts(flvr_colls.at(itr->first));
+        }
+
+      packed = false;
+    }
+
+    std::size_t glm_edges::memory_size() const
+    {
+      std::size_t result = hash_to_key.memory_size();
+
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          result += (itr->second).memory_size();
+        }
+
+      for(auto itr=flvr_adjacency.begin(); itr!=flvr_adjacency.end(); itr++)
+        {
+          result += (itr->second).memory_size();
+        }
+
+      return result;
+    }
+
+    void glm_edges::init_hashmap()
+    {
+      LOG_S(INFO) << __FUNCTION__;
+
+      materialise();
+
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+	  flvr_type flvr = itr->first; 
+	  auto& flvr_coll = itr->second;
+
+	  LOG_S(INFO) << flvr << " [" << flvr_coll.size() << "]";
+	  for(std::size_t ind=0; ind<flvr_coll.size(); ind++)
+	    {
+	      key_type key(flvr, ind);
+	      hash_type hash = flvr_coll.get_hash(ind);
+	      
+	      hash_to_key.assign(hash, key);
+	    }
+        }
+    }
+    
+    const typename glm_edges::adjacency_type* glm_edges::get_adjacency(flvr_type flvr)
+    {
+      auto itr = flvr_adjacency.find(flvr);
+      if(itr!=flvr_adjacency.end())
+        {
+          return &(itr->second);
+        }
+
+      if(not has(flvr))
+        {
+          LOG_S(WARNING) << "unknown flvr: " << flvr;
+          return NULL;
+        }
+
+      if(not is_sorted(flvr))
+        {
+          LOG_S(ERROR) << "flvr " << flvr << " is not sorted: aborting traversal ...";
+          return NULL;
+        }
+
+      freeze(flvr);
+
+      return &(flvr_adjacency.at(flvr));
+    }
+
+    const typename glm_edges::adjacency_type* glm_edges::find_adjacency(flvr_type flvr) const
+    {
+      auto itr = flvr_adjacency.find(flvr);
+      return (itr==flvr_adjacency.end()? NULL: &(itr->second));
+    }
+
+    std::pair<typename glm_edges::cnt_type,
+              typename glm_edges::cnt_type> glm_edges::get_number_of_edges(flvr_type flvr,
+                                                                           hash_type hash_i)
+    {
+      if(not is_sorted(flvr))
+        {
+          sort(flvr);
+        }
+
+      get_adjacency(flvr);
+
+      return std::as_const(*this).get_number_of_edges(flvr, hash_i);
+    }
+
+    std::pair<typename glm_edges::cnt_type,
+              typename glm_edges::cnt_type> glm_edges::get_number_of_edges(flvr_type flvr,
+                                                                           hash_type hash_i) const
+    {
+      const adjacency_type* adj = find_adjacency(flvr);
+
+      ind_type src=0;
+      if(adj!=NULL and adj->find(hash_i, src))
+        {
+          return std::pair<cnt_type, cnt_type>(adj->degree(src), adj->weight(src));
+        }
+
+      return std::pair<cnt_type, cnt_type>(0, 0);
+    }
+
+    typename glm_edges::range_type glm_edges::traverse(flvr_type flvr, hash_type hash_i)
+    {
+      get_adjacency(flvr);
+
+      return std::as_const(*this).traverse(flvr, hash_i);
+    }
+
+    typename glm_edges::range_type glm_edges::traverse(flvr_type flvr, hash_type hash_i) const
+    {
+      const adjacency_type* adj = find_adjacency(flvr);
+
+      ind_type src=0;
+      if(adj!=NULL and adj->find(hash_i, src))
+        {
+          return range_type(*adj, hash_i, adj->beg(src), adj->end(src));
+        }
+
+      return range_type();
+    }
+
+    typename glm_edges::cnt_type glm_edges::traverse(flvr_type flvr, hash_type hash_i,
+                                                     std::vector<edge_type>& tmps, bool sorted)
+    {
+      get_adjacency(flvr);
+
+      return std::as_const(*this).traverse(flvr, hash_i, tmps, sorted);
+    }
+
+    typename glm_edges::cnt_type glm_edges::traverse(flvr_type flvr, hash_type hash_i,
+                                                     std::vector<edge_type>& tmps, bool sorted) const
+    {
+      tmps.clear();
+
+      for(const auto view:traverse(flvr, hash_i))
+        {
+          edge_type edge(flvr, hash_i, view.get_hash_j(), view.get_count());
+          edge.set_prob(view.get_prob());
+
+          tmps.push_back(edge);
+        }
+
+      return tmps.size();
+    }
+
+    void glm_edges::write(std::ofstream& ofs)
+    {
+      materialise();
+
+      glm_binary::write_header(ofs, glm_binary::EDGES_SECTION, flvr_colls.size(), size());
+
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          flvr_type flvr = itr->first;
+
+          auto adj = flvr_adjacency.find(flvr);
+          columns_type::write(ofs, flvr, itr->second, is_sorted(flvr),
+                              adj==flvr_adjacency.end()? NULL: &(adj->second));
+        }
+
+      hash_to_key.write(ofs);
+    }
+
+    bool glm_edges::attach(std::shared_ptr<glm_mmap_file> file)
+    {
+      clear();
+
+      glm_binary::reader_type reader(file->data(), file->data()+file->size());
+
+      glm_binary::header_type header;
+      if(not glm_binary::read_header(reader, glm_binary::EDGES_SECTION, header))
+        {
+          return false;
+        }
+
+      for(std::size_t i=0; i<header.num_flavors; i++)
+        {
+          columns_type cols;
+          adjacency_type adj;
+
+          if(not columns_type::read(reader, cols, adj))
+            {
+              clear();
+              return false;
+            }
+
+          if(cols.is_frozen())
+            {
+              flvr_adjacency[cols.get_flvr()] = adj;
+            }
+
+          mapped_colls[cols.get_flvr()] = cols;
+        }
+
+      if(not hash_to_key.attach(reader))
+        {
+          clear();
+          return false;
+        }
+
+      if(hash_to_key.size()!=header.num_items)
+        {
+          LOG_S(WARNING) << "edge-index size (" << hash_to_key.size() << ") differs from "
+                         << "the number of edges (" << header.num_items << ")";
+        }
+
+      mapped_file = file;
+      return true;
+    }
+
+    /*
+     * Writes the (sorted) edges as a compressed v3 binary. The index and
+     * adjacencies are not written, they are rebuilt when reading.
+     */
+    void glm_edges::write_compressed(std::ofstream& ofs)
+    {
+      sort();
+      materialise();
+
+      glm_binary::write_header(ofs, glm_binary::EDGES_SECTION, flvr_colls.size(), size(),
+                               glm_binary::COMPRESSED_VERSION);
+
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          columns_type::write_compressed(ofs, itr->first, itr->second);
+        }
+    }
+
+    /*
+     * Reads a compressed v3 binary. The blocks of all flavors are decoded
+     * concurrently into pre-sized collections, after which the index and
+     * the probabilities are built concurrently as well. The edges are
+     * sorted, but not frozen.
+     */
+    bool glm_edges::read_compressed(std::shared_ptr<glm_mmap_file> file)
+    {
+      clear();
+
+      glm_binary::reader_type reader(file->data(), file->data()+file->size());
+
+      glm_binary::header_type header;
+      if(not glm_binary::read_header(reader, glm_binary::EDGES_SECTION, header,
+                                     glm_binary::COMPRESSED_VERSION))
+        {
+          return false;
+        }
+
+      std::vector<std::pair<flvr_type, std::size_t> > sizes={};
+      std::vector<std::pair<flvr_type, glm_binary::block_type> > tasks={};
+
+      for(std::size_t i=0; i<header.num_flavors; i++)
+        {
+          flvr_type flvr;
+          std::vector<glm_binary::block_type> blocks;
+
+          if(not columns_type::read_compressed(reader, flvr, blocks))
+            {
+              clear();
+              return false;
+            }
+
+          std::size_t num = (blocks.size()==0? 0: blocks.back().end);
+
+          // the blocks are decoded straight into their place
+          get_coll(flvr).resize(num);
+          sizes.emplace_back(flvr, num);
+
+          for(auto& block:blocks)
+            {
+              tasks.emplace_back(flvr, block);
+            }
+        }
+
+      std::size_t num_threads = glm_parallel::number_of_threads(0);
+
+      std::vector<char> success(tasks.size(), false);
+      glm_parallel::for_each(tasks.size(), num_threads, [&](std::size_t l)
+      {
+        auto& coll = flvr_colls.at(tasks[l].first);
+        success[l] = columns_type::decode(tasks[l].second, coll);
+      });
+
+      if(std::find(success.begin(), success.end(), false)!=success.end())
+        {
+          clear();
+          return false;
+        }
+
+      hash_to_key.build(sizes, [this](flvr_type flvr, ind_type ind)
+      {
+        return flvr_colls.at(flvr).get_hash(ind);
+      }, num_threads);
+
+      glm_parallel::for_each(sizes.size(), num_threads, [&](std::size_t l)
+      {
+        normalise(sizes[l].first, 1);
+      });
+
+      for(auto& item:sizes)
+        {
+          flvr_sorted[item.first] = true;
+        }
+
+      return true;
+    }
+
+    /*
+     * Writes the edges of this (memory-mapped) model with the edges of
+     * `delta` added as a v2 binary, without materialising or re-sorting the
+     * mapped flavors. Only one merged flavor is held in memory at a time,
+     * it is handed to `visit` before it is dropped. Returns the number of
+     * written edges.
+     */
+    template<typename visit_type>
+    std::size_t glm_edges::write_appended(std::ofstream& ofs, glm_edges& delta, visit_type visit)
+    {
+      if(not is_mapped())
+        {
+          LOG_S(ERROR) << "can only append to memory-mapped edges";
+          return 0;
+        }
+
+      for(auto itr=mapped_colls.begin(); itr!=mapped_colls.end(); itr++)
+        {
+          if(not (itr->second).is_sorted())
+            {
+              LOG_S(ERROR) << "can not append to unsorted edge-flvr " << itr->first;
+              return 0;
+            }
+        }
+
+      delta.sort();
+
+      std::set<flvr_type> flvrs={};
+      for(auto itr=mapped_colls.begin(); itr!=mapped_colls.end(); itr++)
+        {
+          flvrs.insert(itr->first);
+        }
+
+      for(auto itr=delta.begin(); itr!=delta.end(); itr++)
+        {
+          flvrs.insert(itr->first);
+        }
+
+      // the number of edges is only known at the end
+      std::streampos beg = ofs.tellp();
+      glm_binary::write_header(ofs, glm_binary::EDGES_SECTION, flvrs.size(), 0);
+
+      hash_map_type index;
+      index.reserve(size()+delta.size());
+
+      for(flvr_type flvr:flvrs)
+        {
+          const columns_type empty_cols;
+          const edge_coll_type empty_coll(flvr);
+
+          auto lhs_itr = mapped_colls.find(flvr);
+          auto rhs_itr = delta.flvr_colls.find(flvr);
+
+          const columns_type& lhs = (lhs_itr==mapped_colls.end()? empty_cols: lhs_itr->second);
+          const edge_coll_type& rhs = (rhs_itr==delta.flvr_colls.end()? empty_coll: rhs_itr->second);
+
+          edge_coll_type coll(flvr);
+          append(lhs, rhs, coll);
+
+          normalise(coll, 0, coll.size());
+
+          adjacency_type adj;
+          adj.build(flvr, coll);
+
+          columns_type::write(ofs, flvr, coll, true, &adj);
+
+          for(std::size_t ind=0; ind<coll.size(); ind++)
+            {
+              index.insert(coll.get_hash(ind), key_type({flvr, ind}));
+            }
+
+          if(rhs.size()>0)
+            {
+              LOG_S(INFO) << "appending edge [" << std::setw(20) << edge_names::to_name(flvr) << "]: "
+                          << std::setw(12) << lhs.size() << " + " << std::setw(12) << rhs.size()
+                          << " -> " << std::setw(12) << coll.size();
+            }
+
+          visit(flvr, coll);
+        }
+
+      index.write(ofs);
+
+      std::streampos end = ofs.tellp();
+      {
+        ofs.seekp(beg);
+        glm_binary::write_header(ofs, glm_binary::EDGES_SECTION, flvrs.size(), index.size());
+      }
+      ofs.seekp(end);
+
+      return index.size();
+    }
+
+    /*
+     * Merges two flavors that are both sorted (per hash_i by descending
+     * count) group by group. A group of a hash_i that occurs on one side
+     * only is copied as it is, only groups on both sides are combined and
+     * re-sorted (with ties in hash_j order, as in `merge`).
+     */
+    template<typename source_type>
+    void glm_edges::append(const source_type& lhs, const edge_coll_type& rhs,
+                           edge_coll_type& result)
+    {
+      flvr_type flvr = result.get_flvr();
+
+      result.clear();
+      result.reserve(lhs.size()+rhs.size());
+
+      edge_coll_type group(flvr), summed(flvr);
+
+      std::size_t l=0, r=0;
+      while(l<lhs.size() or r<rhs.size())
+        {
+          hash_type hash_i = 0;
+          if(r==rhs.size() or (l<lhs.size() and lhs.get_hash_i(l)<=rhs.get_hash_i(r)))
+            {
+              hash_i = lhs.get_hash_i(l);
+            }
+          else
+            {
+              hash_i = rhs.get_hash_i(r);
+            }
+
+          std::size_t l_end=l, r_end=r;
+
+          while(l_end<lhs.size() and lhs.get_hash_i(l_end)==hash_i) { l_end++; }
+          while(r_end<rhs.size() and rhs.get_hash_i(r_end)==hash_i) { r_end++; }
+
+          if(l==l_end or r==r_end)
+            {
+              for(std::size_t k=l; k<l_end; k++)
+                {
+                  result.push_back(hash_i, lhs.get_hash_j(k), lhs.get_count(k));
+                }
+
+              for(std::size_t k=r; k<r_end; k++)
+                {
+                  result.push_back(hash_i, rhs.get_hash_j(k), rhs.get_count(k));
+                }
+            }
+          else
+            {
+              group.clear();
+              for(std::size_t k=l; k<l_end; k++)
+                {
+                  group.push_back(hash_i, lhs.get_hash_j(k), lhs.get_count(k));
+                }
+
+              for(std::size_t k=r; k<r_end; k++)
+                {
+                  group.push_back(hash_i, rhs.get_hash_j(k), rhs.get_count(k));
+                }
+
+              group.sort(edge_coll_type::BY_TARGET, 1);
+
+              summed.clear();
+              for(std::size_t k=0; k<group.size(); k++)
+                {
+                  std::size_t last = summed.size()-1;
+                  if(summed.size()>0 and summed.get_hash_j(last)==group.get_hash_j(k))
+                    {
+                      summed.add_count(last, group.get_count(k));
+                    }
+                  else
+                    {
+                      summed.push_back(hash_i, group.get_hash_j(k), group.get_count(k));
+                    }
+                }
+
+              summed.sort(edge_coll_type::BY_COUNT, 1);
+
+              for(std::size_t k=0; k<summed.size(); k++)
+                {
+                  result.push_back(hash_i, summed.get_hash_j(k), summed.get_count(k));
+                }
+            }
+
+          l = l_end;
+          r = r_end;
+        }
+    }
+
+    void glm_edges::materialise()
+    {
+      if(packed)
+        {
+          unpack_counts();
+        }
+
+      if(not is_mapped())
+        {
+          return;
+        }
+
+      LOG_S(INFO) << "materialising " << size() << " mapped edges";
+
+      // the collections are created up front and copied concurrently
+      std::vector<flvr_type> flvrs={};
+      for(auto itr=mapped_colls.begin(); itr!=mapped_colls.end(); itr++)
+        {
+          get_coll(itr->first);
+          flvr_sorted[itr->first] = (itr->second).is_sorted();
+
+          flvrs.push_back(itr->first);
+        }
+
+      glm_parallel::for_each(flvrs.size(), glm_parallel::number_of_threads(0), [&](std::size_t l)
+      {
+        mapped_colls.at(flvrs[l]).get(flvr_colls.at(flvrs[l]));
+      });
+
+      // the keys of the index remain valid, only drop the view
+      hash_to_key.detach();
+
+      // the adjacencies point into the mapping and are rebuilt on demand
+      flvr_adjacency.clear();
+
+      mapped_colls.clear();
+      mapped_file.reset();
     }
 
   }
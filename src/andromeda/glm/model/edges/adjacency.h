@@ -0,0 +1,298 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_GLM_MODEL_EDGES_ADJACENCY_H
+#define ANDROMEDA_GLM_MODEL_EDGES_ADJACENCY_H
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Immutable compressed-sparse-row (CSR) view of a single sorted edge
+     * flavor. Every distinct source-node (`hash_i`) gets a dense id `src`,
+     * and its outgoing edges live in [offsets[src], offsets[src+1]) of the
+     * target/count/prob columns (same order as the sorted collection).
+     *
+     * Only the prefix [offsets[src], ends[src]) is traversable (valid target
+     * and non-zero count), and its probabilities are normalised over that
+     * prefix at build time.
+     *
+     * The target/count columns are not copied: they are views into the
+     * sorted edge collection of the flavor, or into the edge columns of a
+     * mapped v2 binary when the adjacency is attached. Hence, the collection
+     * can not change while the flavor is frozen (`glm_edges` unfreezes the
+     * flavor on every change).
+     *
+     * The integer columns that the adjacency owns (offsets, ends and weights)
+     * are packed in the smallest width that fits the flavor. A view keeps the
+     * full width of the binary.
+     */
+    class glm_adjacency: public base_types
+    {
+    public:
+
+      typedef base_edge edge_type;
+
+      typedef std::pair<flvr_type, ind_type> key_type;
+
+    public:
+
+      glm_adjacency();
+      ~glm_adjacency();
+
+      flvr_type get_flvr() const { return flvr; }
+
+      std::size_t number_of_sources() const { return weights.size(); }
+      std::size_t number_of_edges() const { return prob.size(); }
+
+      bool is_view() const { return prob.is_view(); }
+
+      std::size_t memory_size() const;
+
+      void clear();
+
+      void build(flvr_type flvr, const glm_edge_coll& coll);
+
+      // points the count column (again) into `coll`, eg after its counts were (un)packed
+      void attach_counts(const glm_edge_coll& coll);
+
+      bool find(hash_type hash_i, ind_type& src) const;
+
+      void write(std::ofstream& ofs) const;
+
+      bool attach(flvr_type flvr, glm_binary::reader_type& reader,
+                  const hash_type* hash_j, const cnt_type* count, std::size_t num_edges);
+
+      ind_type beg(ind_type src) const { return offsets[src]; }
+      ind_type end(ind_type src) const { return ends[src]; }
+
+      cnt_type degree(ind_type src) const { return offsets[src+1]-offsets[src]; }
+      cnt_type weight(ind_type src) const { return weights[src]; }
+
+      hash_type get_hash_j(ind_type ind) const { return hash_j[ind]; }
+      cnt_type  get_count(ind_type ind) const { return count[ind]; }
+      val_type  get_prob(ind_type ind) const { return prob[ind]; }
+
+    private:
+
+      flvr_type flvr;
+
+      glm_hash_index src_index; // hash_i -> (flvr, src)
+
+      glm_packed_column<ind_type> offsets; // #-sources + 1
+      glm_packed_column<ind_type> ends;    // #-sources
+      glm_packed_column<cnt_type> weights; // #-sources
+
+      glm_column<hash_type>        hash_j; // #-edges
+      glm_packed_column<cnt_type>  count;  // #-edges
+      glm_column<val_type>         prob;   // #-edges
+    };
+
+    glm_adjacency::glm_adjacency():
+      flvr(edge_names::UNKNOWN_FLVR),
+
+      src_index(),
+
+      offsets(),
+      ends(),
+      weights(),
+
+      hash_j(),
+      count(),
+      prob()
+    {}
+
+    glm_adjacency::~glm_adjacency()
+    {}
+
+    std::size_t glm_adjacency::memory_size() const
+    {
+      std::size_t result = src_index.memory_size();
+
+      result += offsets.memory_size();
+      result += ends.memory_size();
+      result += weights.memory_size();
+
+      result += hash_j.memory_size();
+      result += count.memory_size();
+      result += prob.memory_size();
+
+      return result;
+    }
+
+    void glm_adjacency::clear()
+    {
+      flvr = edge_names::UNKNOWN_FLVR;
+
+      src_index.clear();
+
+      offsets.clear();
+      ends.clear();
+      weights.clear();
+
+      hash_j.clear();
+      count.clear();
+      prob.clear();
+    }
+
+    void glm_adjacency::build(flvr_type flvr, const glm_edge_coll& coll)
+    {
+      clear();
+
+      this->flvr = flvr;
+
+      const std::vector<hash_type>& hash_i_ = coll.get_hash_i_column();
+
+      std::size_t num_sources=0;
+      for(std::size_t ind=0; ind<coll.size(); ind++)
+        {
+          if(ind==0 or hash_i_[ind]!=hash_i_[ind-1])
+            {
+              num_sources += 1;
+            }
+        }
+
+      src_index.reserve(num_sources);
+
+      std::vector<ind_type> offsets_={}, ends_={};
+      std::vector<cnt_type> weights_={};
+
+      offsets_.reserve(num_sources+1);
+      ends_.reserve(num_sources);
+      weights_.reserve(num_sources);
+
+      const std::vector<hash_type>& hash_j_ = coll.get_hash_j_column();
+      std::vector<val_type> prob_(coll.size());
+
+      std::size_t ind=0;
+      while(ind<coll.size())
+        {
+          hash_type hash_i = hash_i_[ind];
+
+          src_index.insert(hash_i, key_type(flvr, offsets_.size()));
+          offsets_.push_back(ind);
+
+          // the traversable prefix: edges are sorted by descending count
+          std::size_t end=ind;
+          while(end<coll.size() and
+                hash_i_[end]==hash_i and
+                hash_j_[end]!=edge_names::UNKNOWN_HASH and
+                coll.get_count(end)>0)
+            {
+              end++;
+            }
+
+          std::size_t last=end;
+          while(last<coll.size() and
+                hash_i_[last]==hash_i)
+            {
+              last++;
+            }
+
+          cnt_type weight=0;
+          val_type total=0.0;
+
+          for(std::size_t k=ind; k<last; k++)
+            {
+              weight += coll.get_count(k);
+              if(k<end)
+                {
+                  total += coll.get_count(k);
+                }
+            }
+
+          for(std::size_t k=ind; k<last; k++)
+            {
+              prob_[k] = (k<end? coll.get_count(k)/(total+1.e-6): 0.0);
+            }
+
+          ends_.push_back(end);
+          weights_.push_back(weight);
+
+          ind = last;
+        }
+
+      offsets_.push_back(coll.size());
+
+      offsets.assign(offsets_);
+      ends.assign(ends_);
+      weights.assign(weights_);
+
+      // the edges themselves stay in the collection
+      hash_j.attach(hash_j_.data(), coll.size());
+      attach_counts(coll);
+
+      prob.assign(std::move(prob_));
+    }
+
+    void glm_adjacency::attach_counts(const glm_edge_coll& coll)
+    {
+      if(coll.is_packed())
+        {
+          count.attach(coll.get_packed_count_column());
+        }
+      else
+        {
+          count.attach(coll.get_count_column().data(), coll.size());
+        }
+    }
+
+    bool glm_adjacency::find(hash_type hash_i, ind_type& src) const
+    {
+      key_type key;
+      if(src_index.find(hash_i, key))
+        {
+          src = key.second;
+          return true;
+        }
+
+      return false;
+    }
+
+    void glm_adjacency::write(std::ofstream& ofs) const
+    {
+      glm_binary::write_value(ofs, uint64_t(number_of_sources()));
+
+      offsets.write(ofs);
+      ends.write(ofs);
+      weights.write(ofs);
+
+      glm_binary::write_column(ofs, prob.data(), prob.size());
+
+      src_index.write(ofs);
+    }
+
+    bool glm_adjacency::attach(flvr_type flvr, glm_binary::reader_type& reader,
+                               const hash_type* hash_j_ptr, const cnt_type* count_ptr,
+                               std::size_t num_edges)
+    {
+      clear();
+
+      this->flvr = flvr;
+
+      std::size_t num_sources = reader.read_value<uint64_t>();
+
+      offsets.attach(reader.read_column<ind_type>(num_sources+1), num_sources+1);
+      ends.attach(reader.read_column<ind_type>(num_sources), num_sources);
+      weights.attach(reader.read_column<cnt_type>(num_sources), num_sources);
+
+      hash_j.attach(hash_j_ptr, num_edges);
+      count.attach(count_ptr, num_edges);
+      prob.attach(reader.read_column<val_type>(num_edges), num_edges);
+
+      if((not reader.good()) or (not src_index.attach(reader)))
+        {
+          LOG_S(ERROR) << "corrupt adjacency for edge-flvr " << flvr;
+
+          clear();
+          return false;
+        }
+
+      return true;
+    }
+
+  }
+
+}
+
+#endif
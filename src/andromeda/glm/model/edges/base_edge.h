@@ -7,6 +7,12 @@ namespace andromeda
 {
   namespace glm
   {
+    /*
+     * A single edge. The edge-hash is not stored but derived from (flvr,
+     * hash_i, hash_j) on demand. Inside a `glm_edges`, the edges are kept
+     * in columns (see `glm_edge_coll`) and a `base_edge` is only a value
+     * that is handed in or out.
+     */
     class base_edge: public base_types
     {
     public:
@@ -38,7 +44,7 @@ namespace andromeda
 		hash_type hash_j,
 		cnt_type count);
 
-      hash_type get_hash() const { return hash; };
+      hash_type get_hash() const { return to_hash(flvr, hash_i, hash_j); };
       flvr_type get_flvr() const { return flvr; };
       
       hash_type get_hash_i() const { return hash_i; };
@@ -62,6 +68,8 @@ namespace andromeda
 
       void set_lowerbound(flvr_type flavor, hash_type hash_i);
 
+      static hash_type to_hash(flvr_type flavor, hash_type hash_i, hash_type hash_j);
+
       friend bool operator<(const base_edge& lhs, const base_edge& rhs);
       
       friend std::ofstream& operator<<(std::ofstream& os, const base_edge& edge);
@@ -69,11 +77,6 @@ namespace andromeda
       
     private:
 
-      hash_type to_hash();
-      
-    private:
-
-      hash_type hash;
       flvr_type flvr;
 
       hash_type hash_i;
@@ -84,8 +87,6 @@ namespace andromeda
     };
 
     base_edge::base_edge():
-      hash(edge_names::UNKNOWN_HASH),
-      
       flvr(edge_names::UNKNOWN_FLVR),
       hash_i(edge_names::UNKNOWN_HASH),
       hash_j(edge_names::UNKNOWN_HASH),
@@ -97,23 +98,18 @@ namespace andromeda
     base_edge::base_edge(flvr_type flvr,
 			 hash_type hash_i,
 			 hash_type hash_j):
-      hash(edge_names::UNKNOWN_HASH),
-
       flvr(flvr),      
       hash_i(hash_i),
       hash_j(hash_j),
 
       count(0),
       prob(0.0)
-    {
-      hash = to_hash();
-    }
+    {}
     
     base_edge::base_edge(flvr_type flvr,
 			 hash_type hash_i,
 			 hash_type hash_j,
 			 cnt_type count):
-      hash(edge_names::UNKNOWN_HASH),
       flvr(flvr),
       
       hash_i(hash_i),
@@ -121,27 +117,21 @@ namespace andromeda
 
       count(count),
       prob(0.0)
-    {
-      hash = to_hash();
-    }
+    {}
 
-    typename base_edge::hash_type base_edge::to_hash()
+    typename base_edge::hash_type base_edge::to_hash(flvr_type flvr, hash_type hash_i, hash_type hash_j)
     {
-      if(hash==edge_names::UNKNOWN_HASH)
-        {
-	  hash = flvr;
-	  hash = utils::murmerhash3(hash);
+      hash_type hash = flvr;
+      hash = utils::murmerhash3(hash);
 
-	  hash = utils::combine_hash(hash, this->hash_i);
-	  hash = utils::combine_hash(hash, this->hash_j);
-        }
+      hash = utils::combine_hash(hash, hash_i);
+      hash = utils::combine_hash(hash, hash_j);
 
       return hash;
     }
 
     void base_edge::from_json(const nlohmann::json& data)
     {
-      hash = data[hash_lbl].get<hash_type>();
       flvr = data[flvr_lbl].get<flvr_type>();
 
       hash_i = data[hash_i_lbl].get<hash_type>();
@@ -150,14 +140,14 @@ namespace andromeda
       count = data[count_lbl].get<cnt_type>();
       prob = data[prob_lbl].get<val_type>();      
 
-      assert(hash==to_hash());      
+      assert(data[hash_lbl].get<hash_type>()==get_hash());
     }
     
     nlohmann::json base_edge::to_json()
     {
       nlohmann::json data;
       {
-        data[hash_lbl] = hash;
+        data[hash_lbl] = get_hash();
         data[flvr_lbl] = flvr;
 
         data[hash_i_lbl] = hash_i;
@@ -174,7 +164,7 @@ namespace andromeda
     {
       nlohmann::json row = nlohmann::json::array({});
       {
-        row.push_back(hash);
+        row.push_back(get_hash());
 	row.push_back(flvr);
         row.push_back(edge_names::to_name(flvr));
 
@@ -190,9 +180,7 @@ namespace andromeda
 
     void base_edge::update(const base_edge& other)
     {
-      //if(flvr==other.flvr and hash==other.hash and
-      //hash_i==other.hash_i and hash_j==other.hash_j)
-      if(hash==other.get_hash())
+      if(flvr==other.flvr and hash_i==other.hash_i and hash_j==other.hash_j)
         {
           count += other.get_count();
         }
@@ -200,8 +188,8 @@ namespace andromeda
         {
 	  std::stringstream ss;
 	  ss << "updating wrong edge (with same hash) ... \n"
-	     << "this : " << flvr       << ", " <<       hash_i << " -> " <<       hash_j << ":= " << hash       << "\n"
-	     << "other: " << other.flvr << ", " << other.hash_i << " -> " << other.hash_j << ":= " << other.hash << "\n";
+	     << "this : " << flvr       << ", " <<       hash_i << " -> " <<       hash_j << ":= " <<       get_hash() << "\n"
+	     << "other: " << other.flvr << ", " << other.hash_i << " -> " << other.hash_j << ":= " << other.get_hash() << "\n";
 	    
 	  LOG_S(ERROR) << ss.str();
         }
@@ -232,7 +220,9 @@ namespace andromeda
 
     std::ofstream& operator<<(std::ofstream& os, const base_edge& edge)
     {
-      os.write((char*)&edge.hash, sizeof(edge.hash));      
+      // the v1 format still carries the edge-hash
+      base_edge::hash_type hash = edge.get_hash();
+      os.write((char*)&hash, sizeof(hash));      
       os.write((char*)&edge.flvr, sizeof(edge.flvr));
 
       os.write((char*)&edge.hash_i, sizeof(edge.hash_i));
@@ -246,7 +236,8 @@ namespace andromeda
 
     std::ifstream& operator>>(std::ifstream& is, base_edge& edge)
     {
-      is.read((char*)&edge.hash, sizeof(edge.hash));      
+      base_edge::hash_type hash;
+      is.read((char*)&hash, sizeof(hash));      
       is.read((char*)&edge.flvr, sizeof(edge.flvr));
 
       is.read((char*)&edge.hash_i, sizeof(edge.hash_i));
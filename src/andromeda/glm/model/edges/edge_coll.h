@@ -0,0 +1,428 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_GLM_MODEL_EDGES_EDGE_COLL_H
+#define ANDROMEDA_GLM_MODEL_EDGES_EDGE_COLL_H
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * The edges of a single flavor, stored as columns (struct-of-arrays).
+     * The flavor is implied by the collection and the edge-hash is derived
+     * from (flvr, hash_i, hash_j), so neither is stored per edge. Scans that
+     * only need one column (eg the counts) run over contiguous memory.
+     *
+     * Elements are read as `base_edge` values and written through the
+     * setters, there are no references to individual edges.
+     *
+     * The counts of a collection that is not going to change anymore can
+     * be packed (see `glm_packed_column`). Any write unpacks them again.
+     */
+    class glm_edge_coll: public base_types
+    {
+    public:
+
+      typedef base_edge edge_type;
+
+      // order of `sort`: by descending count or by target per source
+      enum order_type { BY_COUNT, BY_TARGET };
+
+      class const_iterator
+      {
+      public:
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef edge_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const edge_type* pointer;
+        typedef edge_type reference;
+
+        const_iterator():
+          coll(NULL),
+          ind(0)
+        {}
+
+        const_iterator(const glm_edge_coll* coll, ind_type ind):
+          coll(coll),
+          ind(ind)
+        {}
+
+        edge_type operator*() const { return (*coll)[ind]; }
+
+        const_iterator& operator++() { ind++; return *this; }
+        const_iterator operator++(int) { const_iterator tmp=*this; ind++; return tmp; }
+
+        bool operator==(const const_iterator& other) const { return ind==other.ind; }
+        bool operator!=(const const_iterator& other) const { return ind!=other.ind; }
+
+      private:
+
+        const glm_edge_coll* coll;
+        ind_type ind;
+      };
+
+      typedef const_iterator iterator;
+
+    public:
+
+      glm_edge_coll();
+      glm_edge_coll(flvr_type flvr);
+
+      flvr_type get_flvr() const { return flvr; }
+
+      std::size_t size() const { return hash_i.size(); }
+      std::size_t capacity() const { return hash_i.capacity(); }
+
+      bool empty() const { return hash_i.empty(); }
+
+      std::size_t memory_size() const;
+
+      bool is_packed() const { return packed; }
+
+      void pack_counts();
+      void unpack_counts();
+
+      void clear();
+      void reserve(std::size_t num);
+      void resize(std::size_t num);
+      void shrink_to_fit();
+
+      void swap(glm_edge_coll& other);
+
+      void push_back(const edge_type& edge);
+      void push_back(hash_type hash_i, hash_type hash_j, cnt_type count, val_type prob=0.0);
+
+      edge_type operator[](ind_type ind) const;
+      edge_type at(ind_type ind) const;
+
+      const_iterator begin() const { return const_iterator(this, 0); }
+      const_iterator end() const { return const_iterator(this, size()); }
+
+      hash_type get_hash(ind_type ind) const { return edge_type::to_hash(flvr, hash_i[ind], hash_j[ind]); }
+
+      hash_type get_hash_i(ind_type ind) const { return hash_i[ind]; }
+      hash_type get_hash_j(ind_type ind) const { return hash_j[ind]; }
+
+      cnt_type get_count(ind_type ind) const { return (packed? packed_count[ind]: count[ind]); }
+      val_type get_prob(ind_type ind) const { return prob[ind]; }
+
+      void set(ind_type ind, hash_type hash_i_, hash_type hash_j_, cnt_type count_)
+      {
+        unpack_counts();
+
+        hash_i[ind] = hash_i_;
+        hash_j[ind] = hash_j_;
+
+        count[ind] = count_;
+      }
+
+      void add_count(ind_type ind, cnt_type cnt) { unpack_counts(); count[ind] += cnt; }
+      void set_prob(ind_type ind, val_type val) { prob[ind] = val; }
+
+      const std::vector<hash_type>& get_hash_i_column() const { return hash_i; }
+      const std::vector<hash_type>& get_hash_j_column() const { return hash_j; }
+
+      const std::vector<cnt_type>& get_count_column() const { assert(not packed); return count; }
+      const glm_packed_column<cnt_type>& get_packed_count_column() const { return packed_count; }
+      const std::vector<val_type>& get_prob_column() const { return prob; }
+
+      void sort(order_type order, std::size_t num_threads);
+
+      template<typename predicate_type>
+      void erase_if(predicate_type remove);
+
+    private:
+
+      void permute(const std::vector<ind_type>& order);
+
+    private:
+
+      flvr_type flvr;
+
+      std::vector<hash_type> hash_i;
+      std::vector<hash_type> hash_j;
+
+      std::vector<cnt_type> count;
+      std::vector<val_type> prob;
+
+      // replaces `count` while packed
+      bool packed;
+      glm_packed_column<cnt_type> packed_count;
+    };
+
+    glm_edge_coll::glm_edge_coll():
+      flvr(edge_names::UNKNOWN_FLVR),
+
+      hash_i({}),
+      hash_j({}),
+
+      count({}),
+      prob({}),
+
+      packed(false),
+      packed_count()
+    {}
+
+    glm_edge_coll::glm_edge_coll(flvr_type flvr):
+      flvr(flvr),
+
+      hash_i({}),
+      hash_j({}),
+
+      count({}),
+      prob({}),
+
+      packed(false),
+      packed_count()
+    {}
+
+    std::size_t glm_edge_coll::memory_size() const
+    {
+      return (hash_i.capacity()*sizeof(hash_type) +
+              hash_j.capacity()*sizeof(hash_type) +
+              count.capacity()*sizeof(cnt_type) +
+              prob.capacity()*sizeof(val_type) +
+              packed_count.memory_size());
+    }
+
+    void glm_edge_coll::pack_counts()
+    {
+      if(packed)
+        {
+          return;
+        }
+
+      packed_count.assign(count);
+      std::vector<cnt_type>().swap(count);
+
+      packed = true;
+    }
+
+    void glm_edge_coll::unpack_counts()
+    {
+      if(not packed)
+        {
+          return;
+        }
+
+      packed_count.get(count);
+      packed_count.clear();
+
+      packed = false;
+    }
+
+    void glm_edge_coll::clear()
+    {
+      unpack_counts();
+
+      hash_i.clear();
+      hash_j.clear();
+
+      count.clear();
+      prob.clear();
+    }
+
+    void glm_edge_coll::reserve(std::size_t num)
+    {
+      unpack_counts();
+
+      hash_i.reserve(num);
+      hash_j.reserve(num);
+
+      count.reserve(num);
+      prob.reserve(num);
+    }
+
+    void glm_edge_coll::resize(std::size_t num)
+    {
+      unpack_counts();
+
+      hash_i.resize(num);
+      hash_j.resize(num);
+
+      count.resize(num);
+      prob.resize(num);
+    }
+
+    void glm_edge_coll::shrink_to_fit()
+    {
+      unpack_counts();
+
+      hash_i.shrink_to_fit();
+      hash_j.shrink_to_fit();
+
+      count.shrink_to_fit();
+      prob.shrink_to_fit();
+    }
+
+    void glm_edge_coll::swap(glm_edge_coll& other)
+    {
+      unpack_counts();
+      other.unpack_counts();
+
+      std::swap(flvr, other.flvr);
+
+      hash_i.swap(other.hash_i);
+      hash_j.swap(other.hash_j);
+
+      count.swap(other.count);
+      prob.swap(other.prob);
+    }
+
+    void glm_edge_coll::push_back(const edge_type& edge)
+    {
+      push_back(edge.get_hash_i(), edge.get_hash_j(), edge.get_count(), edge.get_prob());
+    }
+
+    void glm_edge_coll::push_back(hash_type hash_i_, hash_type hash_j_,
+                                  cnt_type count_, val_type prob_)
+    {
+      unpack_counts();
+
+      hash_i.push_back(hash_i_);
+      hash_j.push_back(hash_j_);
+
+      count.push_back(count_);
+      prob.push_back(prob_);
+    }
+
+    typename glm_edge_coll::edge_type glm_edge_coll::operator[](ind_type ind) const
+    {
+      edge_type edge(flvr, hash_i[ind], hash_j[ind], get_count(ind));
+      edge.set_prob(prob[ind]);
+
+      return edge;
+    }
+
+    typename glm_edge_coll::edge_type glm_edge_coll::at(ind_type ind) const
+    {
+      if(ind>=size())
+        {
+          throw std::out_of_range("glm_edge_coll::at");
+        }
+
+      return (*this)[ind];
+    }
+
+    /*
+     * Sorts the edges per source (hash_i), followed by descending count
+     * (BY_COUNT) or ascending target (BY_TARGET). Only the sort-keys and
+     * the original position are moved around while sorting, the columns
+     * are permuted once at the end. Ties keep their original order.
+     */
+    void glm_edge_coll::sort(order_type order, std::size_t num_threads)
+    {
+      unpack_counts();
+
+      struct sort_key
+      {
+        hash_type hash_i;
+        hash_type second;
+
+        ind_type ind;
+      };
+
+      std::vector<sort_key> keys(size());
+      for(std::size_t ind=0; ind<keys.size(); ind++)
+        {
+          hash_type second = (order==BY_COUNT)?
+            hash_type(std::numeric_limits<cnt_type>::max()-count[ind]) : hash_j[ind];
+
+          keys[ind] = {hash_i[ind], second, ind};
+        }
+
+      auto comp = [](const sort_key& lhs, const sort_key& rhs)
+      {
+        if(lhs.hash_i!=rhs.hash_i)
+          {
+            return (lhs.hash_i<rhs.hash_i);
+          }
+
+        if(lhs.second!=rhs.second)
+          {
+            return (lhs.second<rhs.second);
+          }
+
+        return (lhs.ind<rhs.ind);
+      };
+
+      glm_parallel::sort(keys.begin(), keys.end(), comp, num_threads);
+
+      std::vector<ind_type> perm(keys.size());
+      for(std::size_t ind=0; ind<keys.size(); ind++)
+        {
+          perm[ind] = keys[ind].ind;
+        }
+
+      permute(perm);
+    }
+
+    void glm_edge_coll::permute(const std::vector<ind_type>& order)
+    {
+      {
+        std::vector<hash_type> tmp(order.size());
+
+        for(std::size_t l=0; l<order.size(); l++) { tmp[l] = hash_i[order[l]]; }
+        hash_i.swap(tmp);
+
+        for(std::size_t l=0; l<order.size(); l++) { tmp[l] = hash_j[order[l]]; }
+        hash_j.swap(tmp);
+      }
+
+      {
+        std::vector<cnt_type> tmp(order.size());
+
+        for(std::size_t l=0; l<order.size(); l++) { tmp[l] = count[order[l]]; }
+        count.swap(tmp);
+      }
+
+      {
+        std::vector<val_type> tmp(order.size());
+
+        for(std::size_t l=0; l<order.size(); l++) { tmp[l] = prob[order[l]]; }
+        prob.swap(tmp);
+      }
+    }
+
+    /*
+     * Removes all edges for which `remove(edge)` is true, the order of the
+     * remaining edges is kept.
+     */
+    template<typename predicate_type>
+    void glm_edge_coll::erase_if(predicate_type remove)
+    {
+      unpack_counts();
+
+      std::size_t num=0;
+      for(std::size_t ind=0; ind<size(); ind++)
+        {
+          if(remove((*this)[ind]))
+            {
+              continue;
+            }
+
+          if(num!=ind)
+            {
+              hash_i[num] = hash_i[ind];
+              hash_j[num] = hash_j[ind];
+
+              count[num] = count[ind];
+              prob[num] = prob[ind];
+            }
+
+          num += 1;
+        }
+
+      hash_i.resize(num);
+      hash_j.resize(num);
+
+      count.resize(num);
+      prob.resize(num);
+    }
+
+  }
+
+}
+
+#endif
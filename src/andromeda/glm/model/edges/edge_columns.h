@@ -0,0 +1,260 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_GLM_MODEL_EDGES_EDGE_COLUMNS_H
+#define ANDROMEDA_GLM_MODEL_EDGES_EDGE_COLUMNS_H
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Read-only column view on the edges of a single flavor in a v2 binary
+     * (see `glm_binary`). The edge-hash is not stored, since it is derived
+     * from (flvr, hash_i, hash_j). If the flavor was frozen when saved, its
+     * adjacency follows the columns and shares the hash_j/count columns.
+     *
+     * In a compressed (v3) binary, the edges of a flavor are stored in
+     * blocks of varints instead: per edge, the delta of hash_i with the
+     * previous edge, the raw hash_j and the count (as a delta with the
+     * previous count inside a run of the same hash_i). The probabilities
+     * are not stored, they are recomputed from the counts.
+     */
+    class glm_edge_columns: public base_types
+    {
+    public:
+
+      typedef base_edge edge_type;
+
+      typedef glm_edge_coll edge_coll_type;
+
+      typedef glm_adjacency adjacency_type;
+
+    public:
+
+      glm_edge_columns();
+
+      flvr_type get_flvr() const { return flvr; }
+      std::size_t size() const { return num; }
+
+      bool is_sorted() const { return sorted; }
+      bool is_frozen() const { return frozen; }
+
+      hash_type get_hash_i(ind_type ind) const { return hash_i[ind]; }
+      hash_type get_hash_j(ind_type ind) const { return hash_j[ind]; }
+
+      cnt_type get_count(ind_type ind) const { return count[ind]; }
+
+      void get(ind_type ind, edge_type& edge) const;
+      void get(edge_coll_type& coll) const;
+
+      static void write(std::ofstream& ofs, flvr_type flvr, const edge_coll_type& coll,
+                        bool sorted, const adjacency_type* adj);
+
+      static bool read(glm_binary::reader_type& reader, glm_edge_columns& cols,
+                       adjacency_type& adj);
+
+      static void write_compressed(std::ofstream& ofs, flvr_type flvr, const edge_coll_type& coll);
+
+      static bool read_compressed(glm_binary::reader_type& reader, flvr_type& flvr,
+                                  std::vector<glm_binary::block_type>& blocks);
+
+      // decodes the block into [block.beg, block.end) of a pre-sized `coll`
+      static bool decode(const glm_binary::block_type& block, edge_coll_type& coll);
+
+    private:
+
+      flvr_type flvr;
+      std::size_t num;
+
+      bool sorted, frozen;
+
+      const hash_type* hash_i;
+      const hash_type* hash_j;
+
+      const cnt_type* count;
+      const val_type* prob;
+    };
+
+    glm_edge_columns::glm_edge_columns():
+      flvr(edge_names::UNKNOWN_FLVR),
+      num(0),
+
+      sorted(false),
+      frozen(false),
+
+      hash_i(NULL),
+      hash_j(NULL),
+
+      count(NULL),
+      prob(NULL)
+    {}
+
+    void glm_edge_columns::get(ind_type ind, edge_type& edge) const
+    {
+      edge = edge_type(flvr, hash_i[ind], hash_j[ind], count[ind]);
+      edge.set_prob(prob[ind]);
+    }
+
+    void glm_edge_columns::get(edge_coll_type& coll) const
+    {
+      coll = edge_coll_type(flvr);
+      coll.reserve(num);
+
+      for(std::size_t ind=0; ind<num; ind++)
+        {
+          coll.push_back(hash_i[ind], hash_j[ind], count[ind], prob[ind]);
+        }
+    }
+
+    void glm_edge_columns::write(std::ofstream& ofs, flvr_type flvr, const edge_coll_type& coll,
+                                 bool sorted, const adjacency_type* adj)
+    {
+      glm_binary::write_value(ofs, uint64_t(flvr));
+      glm_binary::write_value(ofs, uint64_t(coll.size()));
+
+      glm_binary::write_value(ofs, uint32_t(sorted));
+      glm_binary::write_value(ofs, uint32_t(adj!=NULL));
+
+      // the in-memory collection is already column-oriented
+      glm_binary::write_column(ofs, coll.get_hash_i_column());
+      glm_binary::write_column(ofs, coll.get_hash_j_column());
+
+      glm_binary::write_column(ofs, coll.get_count_column());
+      glm_binary::write_column(ofs, coll.get_prob_column());
+
+      if(adj!=NULL)
+        {
+          adj->write(ofs);
+        }
+    }
+
+    bool glm_edge_columns::read(glm_binary::reader_type& reader, glm_edge_columns& cols,
+                                adjacency_type& adj)
+    {
+      cols.flvr = reader.read_value<uint64_t>();
+      cols.num = reader.read_value<uint64_t>();
+
+      cols.sorted = (reader.read_value<uint32_t>()!=0);
+      cols.frozen = (reader.read_value<uint32_t>()!=0);
+
+      cols.hash_i = reader.read_column<hash_type>(cols.num);
+      cols.hash_j = reader.read_column<hash_type>(cols.num);
+
+      cols.count = reader.read_column<cnt_type>(cols.num);
+      cols.prob = reader.read_column<val_type>(cols.num);
+
+      if(not reader.good())
+        {
+          LOG_S(ERROR) << "corrupt edge columns";
+          return false;
+        }
+
+      if(cols.frozen)
+        {
+          return adj.attach(cols.flvr, reader, cols.hash_j, cols.count, cols.num);
+        }
+
+      return true;
+    }
+
+    void glm_edge_columns::write_compressed(std::ofstream& ofs, flvr_type flvr, const edge_coll_type& coll)
+    {
+      glm_binary::write_value(ofs, uint64_t(flvr));
+      glm_binary::write_value(ofs, uint64_t(coll.size()));
+
+      glm_binary::write_blocks(ofs, coll.size(), [&coll](std::size_t beg, std::size_t end,
+                                                         std::vector<uint8_t>& buffer)
+      {
+        hash_type prev_hash=0;
+        cnt_type prev_cnt=0;
+
+        for(std::size_t ind=beg; ind<end; ind++)
+          {
+            hash_type hash_i = coll.get_hash_i(ind);
+            hash_type hash_j = coll.get_hash_j(ind);
+
+            cnt_type count = coll.get_count(ind);
+
+            // a delta of zero continues the run of the previous hash_i
+            bool same_run = (ind>beg and hash_i==prev_hash);
+
+            glm_binary::write_varint(buffer, hash_i-prev_hash);
+            glm_binary::write_values(buffer, &hash_j, 1);
+
+            if(same_run)
+              {
+                glm_binary::write_signed(buffer, int64_t(prev_cnt)-int64_t(count));
+              }
+            else
+              {
+                glm_binary::write_varint(buffer, count);
+              }
+
+            prev_hash = hash_i;
+            prev_cnt = count;
+          }
+      });
+    }
+
+    bool glm_edge_columns::read_compressed(glm_binary::reader_type& reader, flvr_type& flvr,
+                                           std::vector<glm_binary::block_type>& blocks)
+    {
+      flvr = reader.read_value<uint64_t>();
+      std::size_t num = reader.read_value<uint64_t>();
+
+      if(not reader.good())
+        {
+          LOG_S(ERROR) << "corrupt compressed edge columns";
+          return false;
+        }
+
+      return glm_binary::read_blocks(reader, num, blocks);
+    }
+
+    bool glm_edge_columns::decode(const glm_binary::block_type& block, edge_coll_type& coll)
+    {
+      if(coll.size()<block.end)
+        {
+          LOG_S(ERROR) << "edge collection is too small for compressed block";
+          return false;
+        }
+
+      glm_binary::decoder_type decoder(block);
+
+      hash_type hash_i=0;
+      cnt_type count=0;
+
+      for(std::size_t ind=block.beg; ind<block.end; ind++)
+        {
+          hash_type delta = decoder.read_varint();
+
+          hash_type hash_j=0;
+          decoder.read_values(&hash_j, 1);
+
+          if(ind>block.beg and delta==0)
+            {
+              count = cnt_type(int64_t(count)-decoder.read_signed());
+            }
+          else
+            {
+              count = decoder.read_varint();
+            }
+
+          hash_i += delta;
+          coll.set(ind, hash_i, hash_j, count);
+        }
+
+      if(not decoder.good())
+        {
+          LOG_S(ERROR) << "corrupt compressed edge block";
+          return false;
+        }
+
+      return true;
+    }
+
+  }
+
+}
+
+#endif
@@ -0,0 +1,119 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_GLM_MODEL_EDGES_EDGE_RANGE_H
+#define ANDROMEDA_GLM_MODEL_EDGES_EDGE_RANGE_H
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Read-only view on a single edge of a frozen flavor. It lives on the
+     * stack and only carries the columns, the edge-hash is derived on demand.
+     */
+    class glm_edge_view: public base_types
+    {
+    public:
+
+      glm_edge_view(flvr_type flvr, hash_type hash_i, hash_type hash_j,
+                    cnt_type count, val_type prob):
+        flvr(flvr),
+        hash_i(hash_i),
+        hash_j(hash_j),
+        count(count),
+        prob(prob)
+      {}
+
+      hash_type get_hash() const { return base_edge::to_hash(flvr, hash_i, hash_j); }
+      flvr_type get_flvr() const { return flvr; }
+
+      hash_type get_hash_i() const { return hash_i; }
+      hash_type get_hash_j() const { return hash_j; }
+
+      cnt_type get_count() const { return count; }
+      val_type get_prob() const { return prob; }
+
+    private:
+
+      flvr_type flvr;
+
+      hash_type hash_i;
+      hash_type hash_j;
+
+      cnt_type count;
+      val_type prob;
+    };
+
+    /*
+     * Range over the traversable edges of one source-node in a frozen flavor
+     * (see `glm_adjacency`). Iterating it does not allocate.
+     */
+    class glm_edge_range: public base_types
+    {
+    public:
+
+      class iterator
+      {
+      public:
+
+        iterator(const glm_adjacency* adj, hash_type hash_i, ind_type ind):
+          adj(adj),
+          hash_i(hash_i),
+          ind(ind)
+        {}
+
+        glm_edge_view operator*() const
+        {
+          return glm_edge_view(adj->get_flvr(), hash_i, adj->get_hash_j(ind),
+                               adj->get_count(ind), adj->get_prob(ind));
+        }
+
+        iterator& operator++() { ind++; return *this; }
+
+        bool operator==(const iterator& other) const { return ind==other.ind; }
+        bool operator!=(const iterator& other) const { return ind!=other.ind; }
+
+      private:
+
+        const glm_adjacency* adj;
+
+        hash_type hash_i;
+        ind_type ind;
+      };
+
+    public:
+
+      glm_edge_range():
+        adj(NULL),
+        hash_i(edge_names::UNKNOWN_HASH),
+        beg_ind(0),
+        end_ind(0)
+      {}
+
+      glm_edge_range(const glm_adjacency& adj, hash_type hash_i,
+                     ind_type beg_ind, ind_type end_ind):
+        adj(&adj),
+        hash_i(hash_i),
+        beg_ind(beg_ind),
+        end_ind(end_ind)
+      {}
+
+      std::size_t size() const { return end_ind-beg_ind; }
+      bool empty() const { return end_ind==beg_ind; }
+
+      iterator begin() const { return iterator(adj, hash_i, beg_ind); }
+      iterator end() const { return iterator(adj, hash_i, end_ind); }
+
+    private:
+
+      const glm_adjacency* adj;
+
+      hash_type hash_i;
+      ind_type beg_ind, end_ind;
+    };
+
+  }
+
+}
+
+#endif
@@ -4,7 +4,9 @@
 #define ANDROMEDA_MODELS_GLM_NODES_H_
 
 #include <andromeda/glm/model/nodes/base.h>
+#include <andromeda/glm/model/nodes/node_heap.h>
 #include <andromeda/glm/model/nodes/base_node.h>
+#include <andromeda/glm/model/nodes/node_columns.h>
 
 namespace andromeda
 {
@@ -25,7 +27,9 @@ namespace andromeda
       typedef std::map<flvr_type, node_coll_type> flvr_map_type;
       typedef typename flvr_map_type::iterator    flvr_itr_type;
 
-      typedef std::unordered_map<hash_type, key_type> hash_map_type;
+      typedef glm_hash_index hash_map_type;
+
+      typedef glm_node_columns columns_type;
       
     public:
 
@@ -37,17 +41,20 @@ namespace andromeda
       double load_factor() { return hash_to_key.load_factor(); }
       double max_load_factor() { return hash_to_key.max_load_factor(); }
 
-      std::size_t size() { return hash_to_key.size(); }
-      std::size_t size(flvr_type flvr) { return flvr_colls.at(flvr).size(); }
+      std::size_t size() const { return hash_to_key.size(); }
+      std::size_t size(flvr_type flvr);
+
+      // the flavors and their sizes, without materialising a mapped model
+      std::map<flvr_type, std::size_t> get_sizes() const;
 
-      node_type& at(key_type key) { return flvr_colls.at(key.first).at(key.second); }
-      node_coll_type& at(flvr_type flvr) { return flvr_colls.at(flvr); }
+      node_type& at(key_type key) { materialise(); return flvr_colls.at(key.first).at(key.second); }
+      node_coll_type& at(flvr_type flvr) { materialise(); return flvr_colls.at(flvr); }
       
-      flvr_itr_type begin() { return flvr_colls.begin(); }
-      flvr_itr_type end() { return flvr_colls.end(); }
+      flvr_itr_type begin() { materialise(); return flvr_colls.begin(); }
+      flvr_itr_type end() { materialise(); return flvr_colls.end(); }
 
-      node_itr_type begin(flvr_type flvr) { return flvr_colls.at(flvr).begin(); }
-      node_itr_type end(flvr_type flvr) { return flvr_colls.at(flvr).end(); }
+      node_itr_type begin(flvr_type flvr) { materialise(); return flvr_colls.at(flvr).begin(); }
+      node_itr_type end(flvr_type flvr) { materialise(); return flvr_colls.at(flvr).end(); }
 
       void show_bucket_distribution();
       
@@ -55,13 +62,22 @@ namespace andromeda
       void reserve(std::size_t N);
       
       void initialise();
+      void reset();
       
       node_type& push_back(node_type& node);
 
-      bool       has(hash_type hash);      
+      bool       has(hash_type hash) const;
       node_type& get(hash_type hash);
+
+      bool find(hash_type hash, key_type& key) const { return hash_to_key.find(hash, key); }
       
-      bool get(hash_type hash, node_type& node);
+      // lookups do not modify the nodes, so they can run concurrently (`node` owns its payload)
+      bool get(hash_type hash, node_type& node) const;
+      bool get(key_type key, node_type& node) const;
+
+      // as `get`, but `node` only points to the payload: it is valid until the nodes change
+      bool view(hash_type hash, node_type& node) const;
+      bool view(key_type key, node_type& node) const;
 
       flvr_type get_flvr(hash_type hash);
       
@@ -71,17 +87,63 @@ namespace andromeda
       
       void sort();
       void sort(flvr_type flavor);
+
+      template<typename predicate_type>
+      void compact(predicate_type keep, std::size_t num_threads);
+
+      bool is_mapped() const { return (mapped_file!=NULL); }
+
+      // owned columns with narrow counters for nodes that do not change anymore
+      void pack();
+      bool is_packed() const { return packed; }
+
+      // the heap memory of the index, the collections, the arena and the packed columns
+      std::size_t memory_size() const;
+
+      void write(std::ofstream& ofs);
+      bool attach(std::shared_ptr<glm_mmap_file> file);
+
+      void write_compressed(std::ofstream& ofs);
+      bool read_compressed(std::shared_ptr<glm_mmap_file> file);
+
+      template<typename visit_type>
+      std::size_t write_appended(std::ofstream& ofs, glm_nodes& delta, visit_type visit);
+
+      void materialise();
       
+    private:
+
+      void insert_names();
+
+      // the nodes are read from `mapped_colls` (mapped or packed)
+      bool in_columns() const { return (mapped_file!=NULL or packed); }
+
     private:
 
       std::size_t max_allowed_size;
       
       flvr_map_type flvr_colls;      
       hash_map_type hash_to_key;
+
+      // arena for the payload of the nodes in `flvr_colls`
+      std::shared_ptr<glm_node_heap> heap;
+
+      // read-only columns of a memory-mapped v2 binary (see `attach`), or owned ones (see `pack`)
+      std::shared_ptr<glm_mmap_file> mapped_file;
+      std::map<flvr_type, columns_type> mapped_colls;
+
+      bool packed;
     };
 
     glm_nodes::glm_nodes():
-      max_allowed_size(-1)
+      max_allowed_size(-1),
+
+      heap(std::make_shared<glm_node_heap>()),
+
+      mapped_file(NULL),
+      mapped_colls({}),
+
+      packed(false)
     {
       initialise();
     }
@@ -125,7 +187,7 @@ namespace andromeda
       std::map<std::size_t, std::size_t> cnt={};
       for(std::size_t i=0; i<hash_to_key.bucket_count(); i++)
 	{
-	  std::size_t n=hash_to_key.bucket_size(i);
+	  std::size_t n=hash_to_key.probe_length(i);
 	  if(n>0)
 	    {
 	      auto itr = cnt.find(n);
@@ -140,7 +202,7 @@ namespace andromeda
 	    }
 	}
 
-      LOG_S(INFO) << __FUNCTION__ << " (bucket-size versus count): " << hash_to_key.max_load_factor();	  
+      LOG_S(INFO) << __FUNCTION__ << " (probe-length versus count): " << hash_to_key.load_factor();	  
       if(cnt.size()>0)
 	{
 	  for(auto itr=cnt.begin(); itr!=cnt.end(); itr++)
@@ -154,17 +216,64 @@ namespace andromeda
     {
       hash_to_key.clear();
       flvr_colls.clear();
+
+      heap = std::make_shared<glm_node_heap>();
+
+      mapped_colls.clear();
+      mapped_file.reset();
+
+      packed = false;
+    }
+
+    std::size_t glm_nodes::size(flvr_type flvr)
+    {
+      if(in_columns())
+        {
+          return mapped_colls.at(flvr).size();
+        }
+
+      return flvr_colls.at(flvr).size();
     }
     
+    std::map<typename glm_nodes::flvr_type, std::size_t> glm_nodes::get_sizes() const
+    {
+      std::map<flvr_type, std::size_t> sizes={};
+
+      if(in_columns())
+        {
+          for(auto itr=mapped_colls.begin(); itr!=mapped_colls.end(); itr++)
+            {
+              sizes[itr->first] = (itr->second).size();
+            }
+        }
+      else
+        {
+          for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+            {
+              sizes[itr->first] = (itr->second).size();
+            }
+        }
+
+      return sizes;
+    }
+
     void glm_nodes::initialise()
     {
       clear();
       
+      // the collections grow on demand (see `reset` for reuse)
       for(auto itr=node_names::begin(); itr!=node_names::end(); itr++)
 	{
-	  flvr_colls[itr->first].reserve(1e6);
+	  flvr_colls[itr->first].reserve(1e3);
 	}
 
+      insert_names();
+      
+      reserve(1e5);
+    }
+
+    void glm_nodes::insert_names()
+    {
       for(std::string name:node_names::TOKEN_NAMES)	
 	{
 	  auto& node = this->insert(node_names::WORD_TOKEN, name);
@@ -176,18 +285,54 @@ namespace andromeda
 	  auto& node = this->insert(node_names::LABEL, name);
 	  node_names::to_hash[name] = node.get_hash();
 	}
-      
-      reserve(1e7);
+    }
+
+    /*
+     * Empties the nodes (up to the initial token and label nodes), but keeps
+     * the memory of the collections, the index and the arena at the size
+     * they needed so far. Collections that held far less than they could
+     * are shrunk, so the reserved memory follows the observed sizes.
+     */
+    void glm_nodes::reset()
+    {
+      if(in_columns())
+	{
+	  initialise();
+	  return;
+	}
+
+      std::size_t total = size();
+
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+	{
+	  auto& coll = itr->second;
+
+	  std::size_t num = coll.size();
+	  coll.clear();
+
+	  if(coll.capacity()>2*num+1e3)
+	    {
+	      coll.shrink_to_fit();
+	      coll.reserve(num+1e3);
+	    }
+	}
+
+      hash_to_key.reset(total);
+
+      heap->reset();
+
+      insert_names();
     }
 
     void glm_nodes::reserve(std::size_t N)
     {      
       hash_to_key.reserve(N);
-      hash_to_key.max_load_factor(32.0);
     }
     
     typename glm_nodes::node_type& glm_nodes::push_back(node_type& node)
     {
+      materialise();
+
       flvr_type flvr = node.get_flvr();
       hash_type hash = node.get_hash();
 
@@ -201,13 +346,13 @@ namespace andromeda
       ind_type ind = flvr_coll.size();
       key_type key(flvr,ind);
       
-      hash_to_key.insert(std::make_pair(hash, key));
-      flvr_coll.push_back(node);
+      hash_to_key.insert(hash, key);
+      flvr_coll.emplace_back(node, *heap);
 
       return flvr_coll.back();
     }
 
-    bool glm_nodes::has(index_type hash)
+    bool glm_nodes::has(index_type hash) const
     {
       return (hash_to_key.count(hash)>0);
     }
@@ -217,26 +362,62 @@ namespace andromeda
       return this->at(hash_to_key.at(hash));
     }
     
-    bool glm_nodes::get(hash_type hash, node_type& node)
+    bool glm_nodes::get(hash_type hash, node_type& node) const
     {
-      auto itr = hash_to_key.find(hash);      
-      
-      if(itr!=hash_to_key.end() and itr->first==hash)
+      key_type key;
+      return (hash_to_key.find(hash, key) and get(key, node));
+    }
+
+    bool glm_nodes::get(key_type key, node_type& node) const
+    {
+      // a copy of the view owns its payload
+      node_type tmp;
+      if(view(key, tmp))
         {
-	  node = this->at(itr->second);
-	  return true;
+          node = tmp;
+          return true;
         }
 
       return false;
     }
 
+    bool glm_nodes::view(hash_type hash, node_type& node) const
+    {
+      key_type key;
+      return (hash_to_key.find(hash, key) and view(key, node));
+    }
+
+    bool glm_nodes::view(key_type key, node_type& node) const
+    {
+      if(in_columns())
+        {
+          auto itr = mapped_colls.find(key.first);
+          if(itr==mapped_colls.end() or key.second>=(itr->second).size())
+            {
+              return false;
+            }
+
+          (itr->second).get(key.second, node);
+          return true;
+        }
+
+      auto itr = flvr_colls.find(key.first);
+      if(itr==flvr_colls.end() or key.second>=(itr->second).size())
+        {
+          return false;
+        }
+
+      node.set_view((itr->second)[key.second]);
+      return true;
+    }
+
     typename glm_nodes::flvr_type glm_nodes::get_flvr(hash_type hash)
     {
-      auto itr = hash_to_key.find(hash);      
+      key_type key;
       
-      if(itr!=hash_to_key.end() and itr->first==hash)
+      if(hash_to_key.find(hash, key))
 	{
-	  return (itr->second).first;
+	  return key.first;
 	}
 
       return node_names::UNKNOWN_FLVR;
@@ -247,10 +428,10 @@ namespace andromeda
       node_type node(flavor, text);
       hash_type hash = node.get_hash();
       
-      auto itr = hash_to_key.find(hash);
-      if(itr!=hash_to_key.end() and itr->first==hash)
+      key_type key;
+      if(hash_to_key.find(hash, key))
 	{
-	  return this->at(itr->second);      
+	  return this->at(key);      
 	}
       else
 	{
@@ -263,10 +444,10 @@ namespace andromeda
       node_type node(flavor, path);
       hash_type hash = node.get_hash();
       
-      auto itr = hash_to_key.find(hash);
-      if(itr!=hash_to_key.end() and itr->first==hash)
+      key_type key;
+      if(hash_to_key.find(hash, key))
 	{
-	  return this->at(itr->second);      
+	  return this->at(key);      
 	}
       else
 	{
@@ -276,11 +457,11 @@ namespace andromeda
 
     typename glm_nodes::node_type& glm_nodes::insert(node_type& other, bool check_size)
     {
-      auto itr = hash_to_key.find(other.get_hash());
+      key_type key;
 
-      if(itr!=hash_to_key.end() and itr->first==other.get_hash())
+      if(hash_to_key.find(other.get_hash(), key))
         {
-	  auto& node = this->at(itr->second);
+	  auto& node = this->at(key);
 	  node.update(other);
 
 	  return node;
@@ -305,6 +486,8 @@ namespace andromeda
 
     void glm_nodes::sort(flvr_type flvr)
     {
+      materialise();
+
       if(flvr_colls.count(flvr)==0)
 	{
 	  return;
@@ -320,16 +503,48 @@ namespace andromeda
 	  flvr_type flvr = node.get_flvr(); 
 	  hash_type hash = node.get_hash();
 	  
-	  hash_to_key.at(hash) = key_type({flvr, ind});
+	  hash_to_key.assign(hash, key_type({flvr, ind}));
 	}	  
     }
     
     void glm_nodes::sort()
     {
       LOG_S(INFO) << __FUNCTION__;
+
+      materialise();
+
+      std::vector<flvr_type> flvrs={};
       for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
 	{
-	  sort(itr->first);
+	  flvrs.push_back(itr->first);
+	}
+
+      // the flavors are sorted concurrently, only the keys of hashes that
+      // are not yet indexed need to be inserted afterwards
+      std::vector<std::vector<std::pair<hash_type, key_type> > > missing(flvrs.size());
+      glm_parallel::for_each(flvrs.size(), glm_parallel::number_of_threads(0), [&](std::size_t l)
+      {
+	auto& coll = flvr_colls.at(flvrs[l]);
+	std::sort(coll.begin(), coll.end());
+
+	for(std::size_t ind=0; ind<coll.size(); ind++)
+	  {
+	    hash_type hash = coll[ind].get_hash();
+	    key_type key(flvrs[l], ind);
+
+	    if(not hash_to_key.update(hash, key))
+	      {
+		missing[l].push_back({hash, key});
+	      }
+	  }
+      });
+
+      for(auto& items:missing)
+	{
+	  for(auto& item:items)
+	    {
+	      hash_to_key.assign(item.first, item.second);
+	    }
 	}
       
       /*
@@ -355,13 +570,440 @@ namespace andromeda
 		flvr_type flvr = node.get_flvr(); 
 		hash_type hash = node.get_hash();
 		
-		hash_to_key.at(hash) = key_type({flvr, ind});
+		hash_to_key.assign(hash, key_type({flvr, ind}));
 	      }
 	  }
       }    
       */  
     }
     
+    /*
+     * Removes in place all nodes for which `keep(key, node)` is false. The
+     * flavors are filtered in parallel, the order within a flavor is kept
+     * and the hash index is rebuilt once at the end. The payload of the
+     * surviving nodes is copied into a fresh arena, so that the memory of
+     * the removed nodes is released.
+     */
+    template<typename predicate_type>
+    void glm_nodes::compact(predicate_type keep, std::size_t num_threads)
+    {
+      materialise();
+
+      std::vector<flvr_type> flvrs={};
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+	{
+	  flvrs.push_back(itr->first);
+	}
+
+      glm_parallel::for_each(flvrs.size(), num_threads, [&](std::size_t l)
+      {
+	flvr_type flvr = flvrs.at(l);
+	auto& coll = flvr_colls.at(flvr);
+
+	std::size_t num=0;
+	for(std::size_t ind=0; ind<coll.size(); ind++)
+	  {
+	    if(keep(key_type({flvr, ind}), coll[ind]))
+	      {
+		if(num!=ind)
+		  {
+		    coll[num] = std::move(coll[ind]);
+		  }
+		num += 1;
+	      }
+	  }
+
+	coll.resize(num);
+	coll.shrink_to_fit();
+      });
+
+      {
+	auto compacted = std::make_shared<glm_node_heap>();
+	for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+	  {
+	    for(auto& node:itr->second)
+	      {
+		node = node_type(node, *compacted);
+	      }
+	  }
+
+	heap = compacted;
+      }
+
+      std::size_t total=0;
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+	{
+	  total += (itr->second).size();
+	}
+
+      hash_to_key.clear();
+      hash_to_key.reserve(total);
+
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+	{
+	  auto& coll = itr->second;
+	  for(std::size_t ind=0; ind<coll.size(); ind++)
+	    {
+	      hash_to_key.insert(coll[ind].get_hash(), key_type({itr->first, ind}));
+	    }
+	}
+    }
+    
+    void glm_nodes::write(std::ofstream& ofs)
+    {
+      materialise();
+
+      glm_binary::write_header(ofs, glm_binary::NODES_SECTION, flvr_colls.size(), size());
+
+      columns_type::write(ofs, flvr_colls);
+
+      hash_to_key.write(ofs);
+    }
+
+    bool glm_nodes::attach(std::shared_ptr<glm_mmap_file> file)
+    {
+      clear();
+
+      glm_binary::reader_type reader(file->data(), file->data()+file->size());
+
+      glm_binary::header_type header;
+      if(not glm_binary::read_header(reader, glm_binary::NODES_SECTION, header))
+        {
+          return false;
+        }
+
+      if((not columns_type::read(reader, header.num_flavors, mapped_colls)) or
+         (not hash_to_key.attach(reader)))
+        {
+          clear();
+          return false;
+        }
+
+      if(hash_to_key.size()!=header.num_items)
+        {
+          LOG_S(WARNING) << "node-index size (" << hash_to_key.size() << ") differs from "
+                         << "the number of nodes (" << header.num_items << ")";
+        }
+
+      mapped_file = file;
+      return true;
+    }
+
+    /*
+     * Writes the nodes as a compressed v3 binary. The index is not written,
+     * it is rebuilt when reading.
+     */
+    void glm_nodes::write_compressed(std::ofstream& ofs)
+    {
+      materialise();
+
+      glm_binary::write_header(ofs, glm_binary::NODES_SECTION, flvr_colls.size(), size(),
+                               glm_binary::COMPRESSED_VERSION);
+
+      columns_type::write_compressed(ofs, flvr_colls);
+    }
+
+    /*
+     * Reads a compressed v3 binary. The blocks are decoded concurrently
+     * into pre-sized collections, every block with its own arena that is
+     * adopted afterwards. The index is built concurrently as well.
+     */
+    bool glm_nodes::read_compressed(std::shared_ptr<glm_mmap_file> file)
+    {
+      clear();
+
+      glm_binary::reader_type reader(file->data(), file->data()+file->size());
+
+      glm_binary::header_type header;
+      if(not glm_binary::read_header(reader, glm_binary::NODES_SECTION, header,
+                                     glm_binary::COMPRESSED_VERSION))
+        {
+          return false;
+        }
+
+      std::vector<std::pair<flvr_type, std::size_t> > sizes={};
+      std::vector<std::pair<flvr_type, glm_binary::block_type> > tasks={};
+
+      for(std::size_t i=0; i<header.num_flavors; i++)
+        {
+          flvr_type flvr;
+          std::vector<glm_binary::block_type> blocks;
+
+          if(not columns_type::read_compressed(reader, flvr, blocks))
+            {
+              clear();
+              return false;
+            }
+
+          std::size_t num = (blocks.size()==0? 0: blocks.back().end);
+
+          flvr_colls[flvr].resize(num);
+          sizes.emplace_back(flvr, num);
+
+          for(auto& block:blocks)
+            {
+              tasks.emplace_back(flvr, block);
+            }
+        }
+
+      std::size_t num_threads = glm_parallel::number_of_threads(0);
+
+      std::vector<glm_node_heap> heaps(tasks.size());
+      std::vector<char> success(tasks.size(), false);
+
+      glm_parallel::for_each(tasks.size(), num_threads, [&](std::size_t l)
+      {
+        auto& coll = flvr_colls.at(tasks[l].first);
+        success[l] = columns_type::decode(tasks[l].second, tasks[l].first, coll, heaps[l]);
+      });
+
+      for(auto& other:heaps)
+        {
+          heap->adopt(other);
+        }
+
+      if(std::find(success.begin(), success.end(), false)!=success.end())
+        {
+          clear();
+          return false;
+        }
+
+      hash_to_key.build(sizes, [this](flvr_type flvr, ind_type ind)
+      {
+        return flvr_colls.at(flvr)[ind].get_hash();
+      }, num_threads);
+
+      return true;
+    }
+
+    /*
+     * Writes the nodes of this (memory-mapped) model with the nodes of
+     * `delta` added as a v2 binary. Only the nodes that are new or updated
+     * by `delta` are sorted, they are merged into the (sorted) mapped
+     * flavors in a single pass. Every written node is handed to `visit`.
+     * Returns the number of written nodes.
+     */
+    template<typename visit_type>
+    std::size_t glm_nodes::write_appended(std::ofstream& ofs, glm_nodes& delta, visit_type visit)
+    {
+      if(not is_mapped())
+        {
+          LOG_S(ERROR) << "can only append to memory-mapped nodes";
+          return 0;
+        }
+
+      flvr_map_type changed={};
+      std::map<flvr_type, std::vector<bool> > updated={};
+
+      for(auto itr=delta.begin(); itr!=delta.end(); itr++)
+        {
+          for(auto& node:itr->second)
+            {
+              key_type key;
+              if(hash_to_key.find(node.get_hash(), key))
+                {
+                  node_type curr;
+                  mapped_colls.at(key.first).get(key.second, curr);
+
+                  curr.update(node);
+                  changed[key.first].push_back(curr);
+
+                  auto& flags = updated[key.first];
+                  if(flags.size()==0)
+                    {
+                      flags.resize(mapped_colls.at(key.first).size(), false);
+                    }
+                  flags.at(key.second) = true;
+                }
+              else
+                {
+                  changed[node.get_flvr()].push_back(node);
+                }
+            }
+        }
+
+      std::set<flvr_type> flvrs={};
+      for(auto itr=mapped_colls.begin(); itr!=mapped_colls.end(); itr++)
+        {
+          flvrs.insert(itr->first);
+        }
+
+      for(auto itr=changed.begin(); itr!=changed.end(); itr++)
+        {
+          flvrs.insert(itr->first);
+        }
+
+      flvr_map_type result={};
+
+      std::size_t total=0;
+      for(flvr_type flvr:flvrs)
+        {
+          const columns_type empty_cols;
+
+          auto cols_itr = mapped_colls.find(flvr);
+          const columns_type& cols = (cols_itr==mapped_colls.end()? empty_cols: cols_itr->second);
+
+          auto& rhs = changed[flvr];
+          std::sort(rhs.begin(), rhs.end());
+
+          auto& flags = updated[flvr];
+
+          auto& coll = result[flvr];
+          coll.reserve(cols.size()+rhs.size());
+
+          std::size_t l=0, r=0;
+          while(l<cols.size() or r<rhs.size())
+            {
+              // the updated nodes of the mapped flavor come with `rhs`
+              if(l<cols.size() and flags.size()>0 and flags.at(l))
+                {
+                  l++;
+                  continue;
+                }
+
+              node_type node;
+              if(l<cols.size())
+                {
+                  cols.get(l, node);
+                }
+
+              if(r==rhs.size() or (l<cols.size() and node<rhs.at(r)))
+                {
+                  coll.push_back(std::move(node));
+                  l++;
+                }
+              else
+                {
+                  coll.push_back(rhs.at(r));
+                  r++;
+                }
+            }
+
+          total += coll.size();
+        }
+
+      hash_map_type index;
+      index.reserve(total);
+
+      for(auto itr=result.begin(); itr!=result.end(); itr++)
+        {
+          auto& coll = itr->second;
+          for(std::size_t ind=0; ind<coll.size(); ind++)
+            {
+              index.insert(coll[ind].get_hash(), key_type({itr->first, ind}));
+
+              visit(coll[ind]);
+            }
+        }
+
+      LOG_S(INFO) << "appending nodes: " << size() << " + " << delta.size()
+                  << " -> " << index.size();
+
+      glm_binary::write_header(ofs, glm_binary::NODES_SECTION, result.size(), index.size());
+
+      columns_type::write(ofs, result);
+
+      index.write(ofs);
+
+      return index.size();
+    }
+
+    /*
+     * Moves the nodes into owned columns (see `glm_node_columns::pack`),
+     * which are read like the columns of a mapped model. The arena is
+     * released afterwards. Any change to the nodes materialises them again.
+     */
+    void glm_nodes::pack()
+    {
+      if(in_columns())
+        {
+          return;
+        }
+
+      std::vector<flvr_type> flvrs={};
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          mapped_colls[itr->first] = columns_type();
+          flvrs.push_back(itr->first);
+        }
+
+      glm_parallel::for_each(flvrs.size(), glm_parallel::number_of_threads(0), [&](std::size_t l)
+      {
+        columns_type::pack(flvrs[l], flvr_colls.at(flvrs[l]), mapped_colls.at(flvrs[l]));
+      });
+
+      flvr_colls.clear();
+
+      heap = std::make_shared<glm_node_heap>();
+
+      packed = true;
+    }
+
+    std::size_t glm_nodes::memory_size() const
+    {
+      std::size_t result = hash_to_key.memory_size() + heap->memory_size();
+
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          result += (itr->second).capacity()*sizeof(node_type);
+        }
+
+      for(auto itr=mapped_colls.begin(); itr!=mapped_colls.end(); itr++)
+        {
+          result += (itr->second).memory_size();
+        }
+
+      return result;
+    }
+
+    void glm_nodes::materialise()
+    {
+      if(not in_columns())
+        {
+          return;
+        }
+
+      LOG_S(INFO) << "materialising " << size() << (packed? " packed":" mapped") << " nodes";
+
+      // the collections are created up front and filled concurrently
+      std::vector<flvr_type> flvrs={};
+      for(auto itr=mapped_colls.begin(); itr!=mapped_colls.end(); itr++)
+        {
+          flvr_colls[itr->first].resize((itr->second).size());
+          flvrs.push_back(itr->first);
+        }
+
+      // the columns are released (or their file is replaced when the model is saved in
+      // place), so the payload is copied (one arena per flavor)
+      std::vector<glm_node_heap> heaps(flvrs.size());
+
+      glm_parallel::for_each(flvrs.size(), glm_parallel::number_of_threads(0), [&](std::size_t l)
+      {
+        auto& cols = mapped_colls.at(flvrs[l]);
+        auto& coll = flvr_colls.at(flvrs[l]);
+
+        node_type node;
+        for(std::size_t ind=0; ind<cols.size(); ind++)
+          {
+            cols.get(ind, node);
+            coll[ind] = node_type(node, heaps[l]);
+          }
+      });
+
+      for(auto& other:heaps)
+        {
+          heap->adopt(other);
+        }
+
+      // the keys of the index remain valid, only drop the view
+      hash_to_key.detach();
+
+      mapped_colls.clear();
+      mapped_file.reset();
+
+      packed = false;
+    }
+
   }
 
 }
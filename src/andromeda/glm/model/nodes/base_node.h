@@ -9,6 +9,18 @@ namespace andromeda
   namespace glm
   {
 
+    /*
+     * The payload of a node (its text, node-path and edge-path) is not
+     * owned through separate heap objects. A node inside a `glm_nodes` only
+     * points into the arena of that collection (see `glm_node_heap`) or
+     * into its memory-mapped file, and is moved around in it without
+     * copying the payload. A free-standing node (eg one that is about to be
+     * inserted, or a copy of a node in a collection) owns its payload in a
+     * single block, so it stays valid after the collection is reset,
+     * compacted or destroyed. The payload is copied into the arena when the
+     * node is pushed into a collection. Read paths that do not keep the node
+     * use a view instead (see `glm_nodes::view`), which copies nothing.
+     */
     class base_node: public base_types
     {
     public:
@@ -51,8 +63,18 @@ namespace andromeda
       base_node(flvr_type flavor, const std::vector<std::string>& text);
       base_node(flvr_type flavor, const std::vector<hash_type>& path);
 
-      bool is_valid() const { return (hash!=node_names::UNKNOWN_HASH or text_ptr!=NULL or
-				      nodes_ptr!=NULL or edges_ptr!=NULL); }
+      base_node(const base_node& other, glm_node_heap& heap);
+
+      base_node(const base_node& other);
+      base_node(base_node&& other) noexcept;
+
+      ~base_node();
+
+      base_node& operator=(const base_node& other);
+      base_node& operator=(base_node&& other) noexcept;
+
+      bool is_valid() const { return (hash!=node_names::UNKNOWN_HASH or has_text() or
+				      has_nodes() or has_edges()); }
       
       hash_type get_hash() const { return hash; };
       flvr_type get_flvr() const { return flvr; };
@@ -60,7 +82,7 @@ namespace andromeda
       std::string get_name() const { return node_names::to_name(flvr); };
       
       cnt_type count() const { return word_cnt; }
-      ind_type length() const { return (nodes_ptr==NULL? 1: nodes_ptr->size()); }
+      ind_type length() const { return (has_nodes()? nodes_len: 1); }
 
       cnt_type get_word_cnt() const { return word_cnt; }
       cnt_type get_sent_cnt() const { return sent_cnt; }
@@ -75,8 +97,14 @@ namespace andromeda
       void incr_tabl_cnt(bool present=true) { tabl_cnt += (present? 1:0); }
       void incr_fdoc_cnt(bool present=true) { fdoc_cnt += (present? 1:0); }
 
-      std::vector<hash_type> get_nodes() { return (nodes_ptr==NULL? std::vector<hash_type>({}): *nodes_ptr.get()); }
-      std::vector<hash_type> get_edges() { return (edges_ptr==NULL? std::vector<hash_type>({}): *edges_ptr.get()); }
+      void set_word_cnt(cnt_type cnt) { word_cnt = cnt; }
+      void set_sent_cnt(cnt_type cnt) { sent_cnt = cnt; }
+      void set_text_cnt(cnt_type cnt) { text_cnt = cnt; }
+      void set_tabl_cnt(cnt_type cnt) { tabl_cnt = cnt; }
+      void set_fdoc_cnt(cnt_type cnt) { fdoc_cnt = cnt; }
+
+      std::span<const hash_type> get_nodes() const { return std::span<const hash_type>(nodes_ptr, has_nodes()? nodes_len:0); }
+      std::span<const hash_type> get_edges() const { return std::span<const hash_type>(edges_ptr, has_edges()? edges_len:0); }
 
       std::string get_text() const;
 
@@ -109,11 +137,33 @@ namespace andromeda
       
       friend std::ofstream& operator<<(std::ofstream& os, const base_node& node);
       friend std::ifstream& operator>>(std::ifstream& is, base_node& node);
+
+      friend class glm_nodes;
+      friend class glm_node_columns;
       
     private:
 
+      const static inline uint32_t ABSENT = -1;
+
+      bool has_text() const { return (text_len!=ABSENT); }
+      bool has_nodes() const { return (nodes_len!=ABSENT); }
+      bool has_edges() const { return (edges_len!=ABSENT); }
+
+      std::string_view text_view() const { return std::string_view(text_ptr, has_text()? text_len:0); }
+
       void initialise();
 
+      void copy_counters(const base_node& other);
+
+      void set_view(const base_node& other);
+
+      void set_payload(const char* text, uint32_t text_len,
+		       const hash_type* nodes, uint32_t nodes_len,
+		       const hash_type* edges, uint32_t edges_len,
+		       glm_node_heap* heap);
+
+      void release();
+
     private:
 
       // flavor of the node (see `node_names`)
@@ -128,10 +178,14 @@ namespace andromeda
       cnt_type tabl_cnt; // number of appearances in different tables
       cnt_type fdoc_cnt; // number of appearances in different docs
 
-      std::shared_ptr<std::string> text_ptr;
+      // payload, laid out as [nodes][edges][text] when owned
+      const char*      text_ptr;
+      const hash_type* nodes_ptr;
+      const hash_type* edges_ptr;
+
+      uint32_t text_len, nodes_len, edges_len; // ABSENT if not present
 
-      std::shared_ptr<std::vector<hash_type>> nodes_ptr;
-      std::shared_ptr<std::vector<hash_type>> edges_ptr;
+      bool owned;
     };
 
     base_node::base_node():
@@ -145,9 +199,14 @@ namespace andromeda
       fdoc_cnt(0),
 
       text_ptr(NULL),
-
       nodes_ptr(NULL),
-      edges_ptr(NULL)
+      edges_ptr(NULL),
+
+      text_len(ABSENT),
+      nodes_len(ABSENT),
+      edges_len(ABSENT),
+
+      owned(false)
     {}
 
     base_node::base_node(flvr_type flvr, hash_type hash):
@@ -162,9 +221,14 @@ namespace andromeda
       fdoc_cnt(flvr==node_names::FDOC? 1:0),
 
       text_ptr(NULL),
-
       nodes_ptr(NULL),
-      edges_ptr(NULL)
+      edges_ptr(NULL),
+
+      text_len(ABSENT),
+      nodes_len(ABSENT),
+      edges_len(ABSENT),
+
+      owned(false)
     {}    
 
     /* this constructor is useful for text, table and document nodes */
@@ -178,11 +242,17 @@ namespace andromeda
       tabl_cnt(0),
       fdoc_cnt(0),
 
-      text_ptr(std::make_shared<std::string>(text_)),
-
+      text_ptr(NULL),
       nodes_ptr(NULL),
-      edges_ptr(NULL)
+      edges_ptr(NULL),
+
+      text_len(ABSENT),
+      nodes_len(ABSENT),
+      edges_len(ABSENT),
+
+      owned(false)
     {
+      set_payload(text_.c_str(), text_.size(), NULL, ABSENT, NULL, ABSENT, NULL);
       initialise();
     }
     
@@ -196,11 +266,17 @@ namespace andromeda
       tabl_cnt(0),
       fdoc_cnt(0),
 
-      text_ptr(std::make_shared<std::string>(text_)),
-
+      text_ptr(NULL),
       nodes_ptr(NULL),
-      edges_ptr(NULL)
+      edges_ptr(NULL),
+
+      text_len(ABSENT),
+      nodes_len(ABSENT),
+      edges_len(ABSENT),
+
+      owned(false)
     {
+      set_payload(text_.c_str(), text_.size(), NULL, ABSENT, NULL, ABSENT, NULL);
       initialise();
     }
 
@@ -215,16 +291,23 @@ namespace andromeda
       fdoc_cnt(0),
 
       text_ptr(NULL),
+      nodes_ptr(NULL),
+      edges_ptr(NULL),
+
+      text_len(ABSENT),
+      nodes_len(ABSENT),
+      edges_len(ABSENT),
 
-      nodes_ptr(std::make_shared<std::vector<hash_type> >()),
-      edges_ptr(NULL)
+      owned(false)
     {
+      std::vector<hash_type> hashes={};
       for(std::string ptext:path)
         {
           base_node node(node_names::WORD_TOKEN, ptext);
-          nodes_ptr->push_back(node.get_hash());
+          hashes.push_back(node.get_hash());
         }
 
+      set_payload(NULL, ABSENT, hashes.data(), hashes.size(), NULL, ABSENT, NULL);
       initialise();
     }
 
@@ -239,13 +322,198 @@ namespace andromeda
       fdoc_cnt(0),
       
       text_ptr(NULL),
+      nodes_ptr(NULL),
+      edges_ptr(NULL),
+
+      text_len(ABSENT),
+      nodes_len(ABSENT),
+      edges_len(ABSENT),
 
-      nodes_ptr(std::make_shared<std::vector<hash_type> >(path)),
-      edges_ptr(NULL)
+      owned(false)
     {
+      set_payload(NULL, ABSENT, path.data(), path.size(), NULL, ABSENT, NULL);
       initialise();
     }
 
+    /* copies the node, with its payload in the arena `heap` */
+    base_node::base_node(const base_node& other, glm_node_heap& heap):
+      base_node()
+    {
+      copy_counters(other);
+      set_payload(other.text_ptr, other.text_len,
+		  other.nodes_ptr, other.nodes_len,
+		  other.edges_ptr, other.edges_len, &heap);
+    }
+
+    base_node::base_node(const base_node& other):
+      base_node()
+    {
+      *this = other;
+    }
+
+    base_node::base_node(base_node&& other) noexcept:
+      base_node()
+    {
+      *this = std::move(other);
+    }
+
+    base_node::~base_node()
+    {
+      release();
+    }
+
+    /*
+     * A copy always owns its payload, also if `other` only points into an
+     * arena or a mapped file: those go away with the collection, the copy
+     * does not.
+     */
+    base_node& base_node::operator=(const base_node& other)
+    {
+      if(this==&other)
+	{
+	  return *this;
+	}
+
+      release();
+      copy_counters(other);
+
+      set_payload(other.text_ptr, other.text_len,
+		  other.nodes_ptr, other.nodes_len,
+		  other.edges_ptr, other.edges_len, NULL);
+
+      return *this;
+    }
+
+    base_node& base_node::operator=(base_node&& other) noexcept
+    {
+      if(this==&other)
+	{
+	  return *this;
+	}
+
+      release();
+      copy_counters(other);
+
+      text_ptr = other.text_ptr;
+      nodes_ptr = other.nodes_ptr;
+      edges_ptr = other.edges_ptr;
+
+      text_len = other.text_len;
+      nodes_len = other.nodes_len;
+      edges_len = other.edges_len;
+
+      owned = other.owned;
+
+      // the payload (if owned) moved along
+      other.owned = false;
+
+      return *this;
+    }
+
+    void base_node::copy_counters(const base_node& other)
+    {
+      flvr = other.flvr;
+      hash = other.hash;
+
+      word_cnt = other.word_cnt;
+      sent_cnt = other.sent_cnt;
+      text_cnt = other.text_cnt;
+      tabl_cnt = other.tabl_cnt;
+      fdoc_cnt = other.fdoc_cnt;
+    }
+
+    /*
+     * Points to the payload of `other` without copying it, the view is only
+     * valid as long as the payload of `other` is.
+     */
+    void base_node::set_view(const base_node& other)
+    {
+      release();
+      copy_counters(other);
+
+      text_ptr = other.text_ptr;
+      nodes_ptr = other.nodes_ptr;
+      edges_ptr = other.edges_ptr;
+
+      text_len = other.text_len;
+      nodes_len = other.nodes_len;
+      edges_len = other.edges_len;
+    }
+
+    /*
+     * Copies the payload in a single block, either in the arena `heap` or,
+     * if `heap` is NULL, in a block owned by the node.
+     */
+    void base_node::set_payload(const char* text_, uint32_t text_len_,
+				const hash_type* nodes_, uint32_t nodes_len_,
+				const hash_type* edges_, uint32_t edges_len_,
+				glm_node_heap* heap)
+    {
+      release();
+
+      std::size_t num_nodes = (nodes_len_==ABSENT? 0: nodes_len_);
+      std::size_t num_edges = (edges_len_==ABSENT? 0: edges_len_);
+      std::size_t num_chars = ( text_len_==ABSENT? 0:  text_len_);
+
+      text_len = text_len_;
+      nodes_len = nodes_len_;
+      edges_len = edges_len_;
+
+      if(text_len==ABSENT and nodes_len==ABSENT and edges_len==ABSENT)
+	{
+	  return;
+	}
+
+      std::size_t num_bytes = (num_nodes+num_edges)*sizeof(hash_type) + num_chars;
+      std::size_t num_words = std::max(std::size_t(1), (num_bytes+sizeof(uint64_t)-1)/sizeof(uint64_t));
+
+      uint64_t* block = NULL;
+      if(heap==NULL)
+	{
+	  block = new uint64_t[num_words];
+	  owned = true;
+	}
+      else
+	{
+	  block = heap->allocate(num_words*sizeof(uint64_t));
+	  owned = false;
+	}
+
+      hash_type* nodes = reinterpret_cast<hash_type*>(block);
+      hash_type* edges = nodes + num_nodes;
+      char*      chars = reinterpret_cast<char*>(edges + num_edges);
+
+      std::copy(nodes_, nodes_+num_nodes, nodes);
+      std::copy(edges_, edges_+num_edges, edges);
+      std::copy( text_,  text_+num_chars, chars);
+
+      nodes_ptr = (nodes_len==ABSENT? NULL: nodes);
+      edges_ptr = (edges_len==ABSENT? NULL: edges);
+      text_ptr  = ( text_len==ABSENT? NULL: chars);
+    }
+
+    void base_node::release()
+    {
+      if(owned)
+	{
+	  // the block starts with the first array that is present
+	  const void* block = (nodes_ptr!=NULL? (const void*)nodes_ptr:
+			       (edges_ptr!=NULL? (const void*)edges_ptr: (const void*)text_ptr));
+
+	  delete [] static_cast<const uint64_t*>(block);
+	}
+
+      text_ptr = NULL;
+      nodes_ptr = NULL;
+      edges_ptr = NULL;
+
+      text_len = ABSENT;
+      nodes_len = ABSENT;
+      edges_len = ABSENT;
+
+      owned = false;
+    }
+
     void base_node::clear()
     {
       hash = node_names::UNKNOWN_HASH;
@@ -257,16 +525,14 @@ namespace andromeda
       tabl_cnt = 0;
       fdoc_cnt = 0;
       
-      if( text_ptr!=NULL) { text_ptr.reset(); }
-      if(nodes_ptr!=NULL) { nodes_ptr.reset(); }
-      if(edges_ptr!=NULL) { edges_ptr.reset(); }      
+      release();
     }
     
     void base_node::initialise()
     {
       if(hash!=node_names::UNKNOWN_HASH)
 	{}
-      else if(text_ptr!=NULL)
+      else if(has_text())
         {
           switch(flvr)
             {
@@ -276,7 +542,7 @@ namespace andromeda
             case node_names::LABEL:
 	    case node_names::SUBLABEL:
               {
-                std::string item = "__"+node_names::to_name(flvr)+"_"+*text_ptr.get()+"__";
+                std::string item = "__"+node_names::to_name(flvr)+"_"+std::string(text_view())+"__";
                 hash = utils::to_reproducible_hash(item);
               }
               break;
@@ -284,14 +550,14 @@ namespace andromeda
             default:
               {
                 //LOG_S(ERROR) << "no support for flvr " << node_names::to_name.at(flvr) << " "
-		//<< "in word " << *text_ptr.get();
+		//<< "in word " << text_view();
                 hash = node_names::UNKNOWN_HASH;
               }
             }
         }
-      else if(nodes_ptr!=NULL and edges_ptr==NULL)
+      else if(has_nodes() and not has_edges())
         {
-          std::vector<hash_type> norm_path = *nodes_ptr.get();
+          std::vector<hash_type> norm_path(nodes_ptr, nodes_ptr+nodes_len);
 
           switch(flvr)
             {
@@ -348,9 +614,9 @@ namespace andromeda
     {
       std::string res="<not-resolved>";
 
-      if(text_ptr!=NULL)
+      if(has_text())
         {
-          res = *text_ptr.get();
+          res = text_view();
         }
 
       return res;
@@ -375,16 +641,16 @@ namespace andromeda
 	case node_names::SENT:
 	case node_names::TEXT:
 	  {
-	    if(nodes_ptr==NULL)
+	    if(not has_nodes())
 	      {
 		//LOG_S(WARNING) << "nodes is NULL for " << node_names::to_name(flvr);
 		return 0;
 	      }
 	    
-	    for(hash_type hash:*nodes_ptr.get())
+	    for(hash_type hash:get_nodes())
 	      {
 		base_node node;
-		if(nodes.get(hash, node))
+		if(nodes.view(hash, node))
 		  {
 		    std::vector<hash_type> new_path={};
 		    node.get_token_path(nodes, new_path);
@@ -423,7 +689,7 @@ namespace andromeda
 	  std::string conn = (l+1==path.size()? "":" ");
 	  
 	  base_node node;
-	  if(nodes.get(path.at(l), node))
+	  if(nodes.view(path.at(l), node))
 	    {
 	      std::string token = node.get_text();
 	      ss << token << conn;
@@ -480,18 +746,18 @@ namespace andromeda
             }
 	}
       
-      if(text_ptr!=NULL)
+      if(has_text())
         {
-          std::string res = *text_ptr.get();
+          std::string res(text_view());
           return res;
         }
-      else if(nodes_ptr!=NULL)
+      else if(has_nodes())
         {
           std::stringstream ss;
-          for(hash_type phash:*nodes_ptr.get())
+          for(hash_type phash:get_nodes())
             {
 	      base_node node;			
-              if(nodes_coll.get(phash, node))
+              if(nodes_coll.view(phash, node))
                 {
                   ss << node.get_text(nodes_coll, connected) << conn;
                 }
@@ -535,21 +801,21 @@ namespace andromeda
         data[name_lbl] = node_names::to_name(flvr);
 
         data[text_lbl] = nlohmann::json::value_t::null;
-        if(text_ptr!=NULL)
+        if(has_text())
           {
-            data[text_lbl] = *text_ptr.get();
+            data[text_lbl] = std::string(text_view());
           }
 
         data[nodes_lbl] = nlohmann::json::value_t::null;
-        if(nodes_ptr!=NULL)
+        if(has_nodes())
           {
-            data[nodes_lbl] = *nodes_ptr.get();
+            data[nodes_lbl] = std::vector<hash_type>(nodes_ptr, nodes_ptr+nodes_len);
           }
 
         data[edges_lbl] = nlohmann::json::value_t::null;
-        if(edges_ptr!=NULL)
+        if(has_edges())
           {
-            data[edges_lbl] = *edges_ptr.get();
+            data[edges_lbl] = std::vector<hash_type>(edges_ptr, edges_ptr+edges_len);
           }
 
         data[cnt_lbl] = nlohmann::json::object({});
@@ -591,23 +857,29 @@ namespace andromeda
       hash = data[hash_lbl].get<hash_type>();
       flvr = data[flvr_lbl].get<flvr_type>();
 
-      if(not data[text_lbl].is_null())
-        {
-          std::string item = data[text_lbl].get<std::string>();
-          text_ptr = std::make_shared<std::string>(item);
-        }
+      {
+        std::string text="";
+        std::vector<hash_type> nodes={}, edges={};
 
-      if(not data[nodes_lbl].is_null())
-        {
-          std::vector<hash_type> item = data[nodes_lbl].get<std::vector<hash_type> >();
-          nodes_ptr = std::make_shared<std::vector<hash_type> >(item);
-        }
+        if(not data[text_lbl].is_null())
+          {
+            text = data[text_lbl].get<std::string>();
+          }
 
-      if(not data[edges_lbl].is_null())
-        {
-          std::vector<hash_type> item = data[edges_lbl].get<std::vector<hash_type> >();
-          edges_ptr = std::make_shared<std::vector<hash_type> >(item);
-        }
+        if(not data[nodes_lbl].is_null())
+          {
+            nodes = data[nodes_lbl].get<std::vector<hash_type> >();
+          }
+
+        if(not data[edges_lbl].is_null())
+          {
+            edges = data[edges_lbl].get<std::vector<hash_type> >();
+          }
+
+        set_payload(text.c_str(), data[text_lbl].is_null()? ABSENT: text.size(),
+                    nodes.data(), data[nodes_lbl].is_null()? ABSENT: nodes.size(),
+                    edges.data(), data[edges_lbl].is_null()? ABSENT: edges.size(), NULL);
+      }
 
       word_cnt = data[cnt_lbl][word_cnt_lbl].get<cnt_type>();
       sent_cnt = data[cnt_lbl][sent_cnt_lbl].get<cnt_type>();
@@ -632,13 +904,13 @@ namespace andromeda
 	row.push_back(tabl_cnt);
 	row.push_back(fdoc_cnt);
 
-	if(text_ptr==NULL)
+	if(not has_text())
 	  {
 	    row.push_back(nlohmann::json::value_t::null);
 	  }
 	else
 	  {
-	    row.push_back(*text_ptr.get());	    
+	    row.push_back(std::string(text_view()));
 	  }
 
 	row.push_back(nlohmann::json::value_t::null);
@@ -663,13 +935,13 @@ namespace andromeda
 	row.push_back(tabl_cnt);
 	row.push_back(fdoc_cnt);
 
-	if(text_ptr==NULL)
+	if(not has_text())
 	  {
 	    row.push_back(nlohmann::json::value_t::null);
 	  }
 	else
 	  {
-	    row.push_back(*text_ptr.get());	    
+	    row.push_back(std::string(text_view()));
 	  }
 
 	{
@@ -714,13 +986,9 @@ namespace andromeda
       os.write((char*)&node.tabl_cnt, sizeof(node.tabl_cnt));
       os.write((char*)&node.fdoc_cnt, sizeof(node.fdoc_cnt));
 
-      auto& text_ptr = node.text_ptr;
-      auto& nodes_ptr = node.nodes_ptr;
-      auto& edges_ptr = node.edges_ptr;
-      
-      int16_t chars_len = ( text_ptr==NULL? -1 :  text_ptr.get()->size());
-      int16_t nodes_len = (nodes_ptr==NULL? -1 : nodes_ptr.get()->size());
-      int16_t edges_len = (edges_ptr==NULL? -1 : edges_ptr.get()->size());
+      int16_t chars_len = (node.has_text()?  node.text_len:  -1);
+      int16_t nodes_len = (node.has_nodes()? node.nodes_len: -1);
+      int16_t edges_len = (node.has_edges()? node.edges_len: -1);
 
       os.write((char*)&chars_len, sizeof(chars_len));
       os.write((char*)&nodes_len, sizeof(nodes_len));
@@ -728,12 +996,12 @@ namespace andromeda
 
       if(chars_len>-1)
         {
-          os.write(text_ptr.get()->c_str(),  sizeof(char)*chars_len);
+          os.write(node.text_ptr,  sizeof(char)*chars_len);
         }
 
       if(nodes_len>-1)
         {
-          for(const auto& nhash:*nodes_ptr.get())
+          for(const auto& nhash:node.get_nodes())
             {
               os.write((char*)&nhash, sizeof(nhash));
             }
@@ -741,7 +1009,7 @@ namespace andromeda
 
       if(edges_len>-1)
         {
-          for(const auto& ehash:*edges_ptr.get())
+          for(const auto& ehash:node.get_edges())
             {
               os.write((char*)&ehash, sizeof(ehash));
             }
@@ -769,35 +1037,27 @@ namespace andromeda
       is.read((char*)&nodes_len, sizeof(nodes_len));
       is.read((char*)&edges_len, sizeof(edges_len));
       
+      std::string line(std::max<int16_t>(chars_len, 0), ' ');
       if(chars_len>-1)
         {
-          std::string line(chars_len, ' ');
           is.read((char*)&line[0],  sizeof(char)*chars_len);
-	  
-          node.text_ptr = std::make_shared<std::string>(line);
         }
 
-      if(nodes_len>-1)
-        {	  
-          std::vector<hash_type> nhashes(nodes_len);
-          for(hash_type& nhash:nhashes)
-            {
-              is.read((char*)&nhash, sizeof(nhash));
-            }
-
-          node.nodes_ptr = std::make_shared<std::vector<hash_type> >(nhashes);
+      std::vector<hash_type> nhashes(std::max<int16_t>(nodes_len, 0));
+      for(hash_type& nhash:nhashes)
+        {
+          is.read((char*)&nhash, sizeof(nhash));
         }
 
-      if(edges_len>-1)
+      std::vector<hash_type> ehashes(std::max<int16_t>(edges_len, 0));
+      for(hash_type& ehash:ehashes)
         {
-          std::vector<hash_type> ehashes(edges_len);
-          for(hash_type& ehash:ehashes)
-            {
-              is.read((char*)&ehash, sizeof(ehash));
-            }
-
-          node.edges_ptr = std::make_shared<std::vector<hash_type> >(ehashes);
+          is.read((char*)&ehash, sizeof(ehash));
         }
+
+      node.set_payload(line.c_str(),   chars_len>-1? line.size():    base_node::ABSENT,
+                       nhashes.data(), nodes_len>-1? nhashes.size(): base_node::ABSENT,
+                       ehashes.data(), edges_len>-1? ehashes.size(): base_node::ABSENT, NULL);
       
       assert(node.is_valid());
       
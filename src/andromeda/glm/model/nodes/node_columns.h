@@ -0,0 +1,583 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_GLM_MODEL_NODES_NODE_COLUMNS_H
+#define ANDROMEDA_GLM_MODEL_NODES_NODE_COLUMNS_H
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Read-only column view on the nodes of a single flavor in a v2 binary
+     * (see `glm_binary`). The texts live in a shared string-heap and the
+     * node/edge paths in a shared hash-heap, both are referenced by
+     * (offset, length) columns where a length of -1 encodes NULL. The
+     * nodes returned by `get` point straight into the heaps, so they are
+     * only valid as long as the underlying file stays mapped.
+     *
+     * In a compressed (v3) binary, the nodes of a flavor are stored in
+     * blocks instead: per node, the raw hash, the word-count as a delta
+     * with the previous node (the nodes are sorted by word-count), the
+     * other counts as varints and the text and paths inline, prefixed by
+     * their length plus one (zero encodes NULL). The payload of decoded
+     * nodes is copied in the arena that is handed to `decode`.
+     *
+     * The columns can also own their values (see `pack`): the nodes of a
+     * model that does not change anymore are then kept in columns with the
+     * counters and offsets packed in the smallest width that fits, rather
+     * than as `base_node` structs with their payload in an arena.
+     */
+    class glm_node_columns: public base_types
+    {
+    public:
+
+      typedef base_node node_type;
+
+      typedef std::vector<node_type> node_coll_type;
+      typedef std::map<flvr_type, node_coll_type> flvr_map_type;
+
+      const static inline std::size_t NUM_CNTS = 5;
+
+    public:
+
+      glm_node_columns();
+
+      flvr_type get_flvr() const { return flvr; }
+      std::size_t size() const { return num; }
+
+      hash_type get_hash(ind_type ind) const { return hash[ind]; }
+      cnt_type get_word_cnt(ind_type ind) const { return cnts[0][ind]; }
+
+      // the heap memory of the owned columns (a view on a binary has none)
+      std::size_t memory_size() const;
+
+      void get(ind_type ind, node_type& node) const;
+
+      // owned columns of the nodes of a single flavor
+      static void pack(flvr_type flvr, const node_coll_type& coll, glm_node_columns& cols);
+
+      static void write(std::ofstream& ofs, flvr_map_type& flvr_colls);
+
+      static bool read(glm_binary::reader_type& reader, std::size_t num_flavors,
+                       std::map<flvr_type, glm_node_columns>& columns);
+
+      static void write_compressed(std::ofstream& ofs, flvr_map_type& flvr_colls);
+
+      static bool read_compressed(glm_binary::reader_type& reader, flvr_type& flvr,
+                                  std::vector<glm_binary::block_type>& blocks);
+
+      // decodes the block into [block.beg, block.end) of a pre-sized `coll`
+      static bool decode(const glm_binary::block_type& block, flvr_type flvr,
+                         node_coll_type& coll, glm_node_heap& heap);
+
+    private:
+
+      static void write_payload(std::vector<uint8_t>& buffer, uint32_t len,
+                                const void* data, std::size_t size);
+
+      static uint32_t read_payload(glm_binary::decoder_type& decoder, std::vector<uint8_t>& data,
+                                   std::size_t size);
+
+    private:
+
+      flvr_type flvr;
+      std::size_t num;
+
+      glm_column<hash_type> hash;
+      std::array<glm_packed_column<cnt_type>, NUM_CNTS> cnts;
+
+      glm_packed_column<uint64_t> text_beg;
+      glm_column<int32_t>         text_len;
+
+      glm_packed_column<uint64_t> nodes_beg;
+      glm_column<int32_t>         nodes_len;
+
+      glm_packed_column<uint64_t> edges_beg;
+      glm_column<int32_t>         edges_len;
+
+      glm_column<char>      chars_heap;
+      glm_column<hash_type> hashes_heap;
+    };
+
+    glm_node_columns::glm_node_columns():
+      flvr(node_names::UNKNOWN_FLVR),
+      num(0),
+
+      hash(),
+      cnts(),
+
+      text_beg(),
+      text_len(),
+
+      nodes_beg(),
+      nodes_len(),
+
+      edges_beg(),
+      edges_len(),
+
+      chars_heap(),
+      hashes_heap()
+    {}
+
+    std::size_t glm_node_columns::memory_size() const
+    {
+      std::size_t result = hash.memory_size();
+
+      for(auto& col:cnts)
+        {
+          result += col.memory_size();
+        }
+
+      result += text_beg.memory_size() + text_len.memory_size();
+      result += nodes_beg.memory_size() + nodes_len.memory_size();
+      result += edges_beg.memory_size() + edges_len.memory_size();
+
+      result += chars_heap.memory_size() + hashes_heap.memory_size();
+
+      return result;
+    }
+
+    void glm_node_columns::get(ind_type ind, node_type& node) const
+    {
+      node.clear();
+
+      node.flvr = flvr;
+      node.hash = hash[ind];
+
+      node.word_cnt = cnts[0][ind];
+      node.sent_cnt = cnts[1][ind];
+      node.text_cnt = cnts[2][ind];
+      node.tabl_cnt = cnts[3][ind];
+      node.fdoc_cnt = cnts[4][ind];
+
+      if(text_len[ind]>-1)
+        {
+          node.text_ptr = chars_heap.data()+text_beg[ind];
+          node.text_len = text_len[ind];
+        }
+
+      if(nodes_len[ind]>-1)
+        {
+          node.nodes_ptr = hashes_heap.data()+nodes_beg[ind];
+          node.nodes_len = nodes_len[ind];
+        }
+
+      if(edges_len[ind]>-1)
+        {
+          node.edges_ptr = hashes_heap.data()+edges_beg[ind];
+          node.edges_len = edges_len[ind];
+        }
+    }
+
+    void glm_node_columns::write(std::ofstream& ofs, flvr_map_type& flvr_colls)
+    {
+      std::size_t num_chars=0, num_hashes=0;
+
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          const node_coll_type& coll = itr->second;
+
+          glm_binary::write_value(ofs, uint64_t(itr->first));
+          glm_binary::write_value(ofs, uint64_t(coll.size()));
+
+          std::vector<hash_type> hashes(coll.size());
+          for(std::size_t l=0; l<coll.size(); l++)
+            {
+              hashes[l] = coll[l].hash;
+            }
+          glm_binary::write_column(ofs, hashes);
+
+          std::vector<cnt_type> vals(coll.size());
+          for(std::size_t k=0; k<NUM_CNTS; k++)
+            {
+              for(std::size_t l=0; l<coll.size(); l++)
+                {
+                  const node_type& node = coll[l];
+                  switch(k)
+                    {
+                    case 0: { vals[l] = node.word_cnt; } break;
+                    case 1: { vals[l] = node.sent_cnt; } break;
+                    case 2: { vals[l] = node.text_cnt; } break;
+                    case 3: { vals[l] = node.tabl_cnt; } break;
+                    default: { vals[l] = node.fdoc_cnt; }
+                    }
+                }
+              glm_binary::write_column(ofs, vals);
+            }
+
+          std::vector<uint64_t> begs(coll.size());
+          std::vector<int32_t>  lens(coll.size());
+
+          for(std::size_t l=0; l<coll.size(); l++)
+            {
+              const node_type& node = coll[l];
+
+              begs[l] = num_chars;
+              lens[l] = (node.has_text()? node.text_len: -1);
+
+              num_chars += (node.has_text()? node.text_len: 0);
+            }
+          glm_binary::write_column(ofs, begs);
+          glm_binary::write_column(ofs, lens);
+
+          for(std::size_t l=0; l<coll.size(); l++)
+            {
+              const node_type& node = coll[l];
+
+              begs[l] = num_hashes;
+              lens[l] = (node.has_nodes()? node.nodes_len: -1);
+
+              num_hashes += (node.has_nodes()? node.nodes_len: 0);
+            }
+          glm_binary::write_column(ofs, begs);
+          glm_binary::write_column(ofs, lens);
+
+          for(std::size_t l=0; l<coll.size(); l++)
+            {
+              const node_type& node = coll[l];
+
+              begs[l] = num_hashes;
+              lens[l] = (node.has_edges()? node.edges_len: -1);
+
+              num_hashes += (node.has_edges()? node.edges_len: 0);
+            }
+          glm_binary::write_column(ofs, begs);
+          glm_binary::write_column(ofs, lens);
+        }
+
+      // string-heap
+      {
+        glm_binary::write_value(ofs, uint64_t(num_chars));
+
+        std::size_t cnt=0;
+        for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+          {
+            for(const auto& node:itr->second)
+              {
+                if(node.has_text())
+                  {
+                    ofs.write(node.text_ptr, node.text_len);
+                    cnt += node.text_len;
+                  }
+              }
+          }
+        assert(cnt==num_chars);
+
+        const char padding[glm_binary::ALIGNMENT] = {0};
+        ofs.write(padding, glm_binary::padded_size(num_chars)-num_chars);
+      }
+
+      // hash-heap (node paths first, then edge paths per flavor)
+      {
+        glm_binary::write_value(ofs, uint64_t(num_hashes));
+
+        for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+          {
+            for(const auto& node:itr->second)
+              {
+                if(node.has_nodes())
+                  {
+                    glm_binary::write_column(ofs, node.nodes_ptr, node.nodes_len);
+                  }
+              }
+
+            for(const auto& node:itr->second)
+              {
+                if(node.has_edges())
+                  {
+                    glm_binary::write_column(ofs, node.edges_ptr, node.edges_len);
+                  }
+              }
+          }
+      }
+    }
+
+    bool glm_node_columns::read(glm_binary::reader_type& reader, std::size_t num_flavors,
+                                std::map<flvr_type, glm_node_columns>& columns)
+    {
+      columns.clear();
+
+      for(std::size_t i=0; i<num_flavors; i++)
+        {
+          glm_node_columns cols;
+
+          cols.flvr = reader.read_value<uint64_t>();
+          cols.num = reader.read_value<uint64_t>();
+
+          cols.hash.attach(reader.read_column<hash_type>(cols.num), cols.num);
+
+          for(std::size_t k=0; k<NUM_CNTS; k++)
+            {
+              cols.cnts[k].attach(reader.read_column<cnt_type>(cols.num), cols.num);
+            }
+
+          cols.text_beg.attach(reader.read_column<uint64_t>(cols.num), cols.num);
+          cols.text_len.attach(reader.read_column<int32_t>(cols.num), cols.num);
+
+          cols.nodes_beg.attach(reader.read_column<uint64_t>(cols.num), cols.num);
+          cols.nodes_len.attach(reader.read_column<int32_t>(cols.num), cols.num);
+
+          cols.edges_beg.attach(reader.read_column<uint64_t>(cols.num), cols.num);
+          cols.edges_len.attach(reader.read_column<int32_t>(cols.num), cols.num);
+
+          columns[cols.flvr] = cols;
+        }
+
+      std::size_t num_chars = reader.read_value<uint64_t>();
+      const char* chars_heap = reader.read_column<char>(num_chars);
+
+      std::size_t num_hashes = reader.read_value<uint64_t>();
+      const hash_type* hashes_heap = reader.read_column<hash_type>(num_hashes);
+
+      if(not reader.good())
+        {
+          LOG_S(ERROR) << "corrupt node columns";
+
+          columns.clear();
+          return false;
+        }
+
+      for(auto itr=columns.begin(); itr!=columns.end(); itr++)
+        {
+          (itr->second).chars_heap.attach(chars_heap, num_chars);
+          (itr->second).hashes_heap.attach(hashes_heap, num_hashes);
+        }
+
+      return true;
+    }
+
+    void glm_node_columns::pack(flvr_type flvr, const node_coll_type& coll, glm_node_columns& cols)
+    {
+      cols = glm_node_columns();
+
+      cols.flvr = flvr;
+      cols.num = coll.size();
+
+      {
+        std::vector<hash_type> hashes(coll.size());
+        for(std::size_t l=0; l<coll.size(); l++)
+          {
+            hashes[l] = coll[l].hash;
+          }
+        cols.hash.assign(std::move(hashes));
+      }
+
+      std::vector<cnt_type> vals(coll.size());
+      for(std::size_t k=0; k<NUM_CNTS; k++)
+        {
+          for(std::size_t l=0; l<coll.size(); l++)
+            {
+              const node_type& node = coll[l];
+              switch(k)
+                {
+                case 0: { vals[l] = node.word_cnt; } break;
+                case 1: { vals[l] = node.sent_cnt; } break;
+                case 2: { vals[l] = node.text_cnt; } break;
+                case 3: { vals[l] = node.tabl_cnt; } break;
+                default: { vals[l] = node.fdoc_cnt; }
+                }
+            }
+          cols.cnts[k].assign(vals);
+        }
+
+      std::vector<char> chars={};
+      std::vector<hash_type> hashes={};
+
+      std::vector<uint64_t> begs(coll.size());
+      std::vector<int32_t>  lens(coll.size());
+
+      for(std::size_t l=0; l<coll.size(); l++)
+        {
+          const node_type& node = coll[l];
+
+          begs[l] = chars.size();
+          lens[l] = (node.has_text()? node.text_len: -1);
+
+          if(node.has_text())
+            {
+              chars.insert(chars.end(), node.text_ptr, node.text_ptr+node.text_len);
+            }
+        }
+      cols.text_beg.assign(begs);
+      cols.text_len.assign(std::vector<int32_t>(lens));
+
+      for(std::size_t l=0; l<coll.size(); l++)
+        {
+          const node_type& node = coll[l];
+
+          begs[l] = hashes.size();
+          lens[l] = (node.has_nodes()? node.nodes_len: -1);
+
+          if(node.has_nodes())
+            {
+              hashes.insert(hashes.end(), node.nodes_ptr, node.nodes_ptr+node.nodes_len);
+            }
+        }
+      cols.nodes_beg.assign(begs);
+      cols.nodes_len.assign(std::vector<int32_t>(lens));
+
+      for(std::size_t l=0; l<coll.size(); l++)
+        {
+          const node_type& node = coll[l];
+
+          begs[l] = hashes.size();
+          lens[l] = (node.has_edges()? node.edges_len: -1);
+
+          if(node.has_edges())
+            {
+              hashes.insert(hashes.end(), node.edges_ptr, node.edges_ptr+node.edges_len);
+            }
+        }
+      cols.edges_beg.assign(begs);
+      cols.edges_len.assign(std::move(lens));
+
+      chars.shrink_to_fit();
+      hashes.shrink_to_fit();
+
+      cols.chars_heap.assign(std::move(chars));
+      cols.hashes_heap.assign(std::move(hashes));
+    }
+
+    void glm_node_columns::write_compressed(std::ofstream& ofs, flvr_map_type& flvr_colls)
+    {
+      for(auto itr=flvr_colls.begin(); itr!=flvr_colls.end(); itr++)
+        {
+          const node_coll_type& coll = itr->second;
+
+          glm_binary::write_value(ofs, uint64_t(itr->first));
+          glm_binary::write_value(ofs, uint64_t(coll.size()));
+
+          glm_binary::write_blocks(ofs, coll.size(), [&coll](std::size_t beg, std::size_t end,
+                                                             std::vector<uint8_t>& buffer)
+          {
+            cnt_type prev_cnt=0;
+
+            for(std::size_t ind=beg; ind<end; ind++)
+              {
+                const node_type& node = coll[ind];
+
+                glm_binary::write_values(buffer, &node.hash, 1);
+
+                glm_binary::write_signed(buffer, int64_t(prev_cnt)-int64_t(node.word_cnt));
+                prev_cnt = node.word_cnt;
+
+                glm_binary::write_varint(buffer, node.sent_cnt);
+                glm_binary::write_varint(buffer, node.text_cnt);
+                glm_binary::write_varint(buffer, node.tabl_cnt);
+                glm_binary::write_varint(buffer, node.fdoc_cnt);
+
+                write_payload(buffer, node.text_len, node.text_ptr, sizeof(char));
+                write_payload(buffer, node.nodes_len, node.nodes_ptr, sizeof(hash_type));
+                write_payload(buffer, node.edges_len, node.edges_ptr, sizeof(hash_type));
+              }
+          });
+        }
+    }
+
+    bool glm_node_columns::read_compressed(glm_binary::reader_type& reader, flvr_type& flvr,
+                                           std::vector<glm_binary::block_type>& blocks)
+    {
+      flvr = reader.read_value<uint64_t>();
+      std::size_t num = reader.read_value<uint64_t>();
+
+      if(not reader.good())
+        {
+          LOG_S(ERROR) << "corrupt compressed node columns";
+          return false;
+        }
+
+      return glm_binary::read_blocks(reader, num, blocks);
+    }
+
+    bool glm_node_columns::decode(const glm_binary::block_type& block, flvr_type flvr,
+                                  node_coll_type& coll, glm_node_heap& heap)
+    {
+      if(coll.size()<block.end)
+        {
+          LOG_S(ERROR) << "node collection is too small for compressed block";
+          return false;
+        }
+
+      glm_binary::decoder_type decoder(block);
+
+      std::vector<uint8_t> text, nodes, edges;
+
+      cnt_type word_cnt=0;
+      for(std::size_t ind=block.beg; ind<block.end; ind++)
+        {
+          node_type& node = coll[ind];
+
+          node.flvr = flvr;
+          decoder.read_values(&node.hash, 1);
+
+          word_cnt = cnt_type(int64_t(word_cnt)-decoder.read_signed());
+          node.word_cnt = word_cnt;
+
+          node.sent_cnt = decoder.read_varint();
+          node.text_cnt = decoder.read_varint();
+          node.tabl_cnt = decoder.read_varint();
+          node.fdoc_cnt = decoder.read_varint();
+
+          uint32_t text_len = read_payload(decoder, text, sizeof(char));
+          uint32_t nodes_len = read_payload(decoder, nodes, sizeof(hash_type));
+          uint32_t edges_len = read_payload(decoder, edges, sizeof(hash_type));
+
+          if(not decoder.good())
+            {
+              break;
+            }
+
+          node.set_payload((const char*)text.data(), text_len,
+                           (const hash_type*)nodes.data(), nodes_len,
+                           (const hash_type*)edges.data(), edges_len, &heap);
+        }
+
+      if(not decoder.good())
+        {
+          LOG_S(ERROR) << "corrupt compressed node block";
+          return false;
+        }
+
+      return true;
+    }
+
+    void glm_node_columns::write_payload(std::vector<uint8_t>& buffer, uint32_t len,
+                                         const void* data, std::size_t size)
+    {
+      if(len==node_type::ABSENT)
+        {
+          glm_binary::write_varint(buffer, 0);
+          return;
+        }
+
+      glm_binary::write_varint(buffer, uint64_t(len)+1);
+      glm_binary::write_values(buffer, (const uint8_t*)data, len*size);
+    }
+
+    uint32_t glm_node_columns::read_payload(glm_binary::decoder_type& decoder, std::vector<uint8_t>& data,
+                                            std::size_t size)
+    {
+      uint64_t len = decoder.read_varint();
+      if(len==0)
+        {
+          return node_type::ABSENT;
+        }
+
+      if((len-1)>decoder.remaining()/size)
+        {
+          decoder.invalidate();
+          return node_type::ABSENT;
+        }
+
+      // hashes are copied into an aligned buffer
+      data.resize(std::max(std::size_t(1), (len-1)*size));
+      decoder.read_values(data.data(), (len-1)*size);
+
+      return uint32_t(len-1);
+    }
+
+  }
+
+}
+
+#endif
@@ -0,0 +1,145 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_GLM_MODEL_NODES_NODE_HEAP_H
+#define ANDROMEDA_GLM_MODEL_NODES_NODE_HEAP_H
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Append-only arena for the payload (text, node-path and edge-path) of
+     * the nodes in a `glm_nodes`. Memory is handed out from large blocks
+     * that never move, so nodes can keep plain pointers into the arena. The
+     * memory is only released when the arena itself is cleared. A `reset`
+     * invalidates all payloads but keeps the blocks for reuse.
+     */
+    class glm_node_heap
+    {
+    public:
+
+      typedef uint64_t word_type;
+
+      const static inline std::size_t BLOCK_SIZE = 1<<17; // #-words (1 MB)
+
+    public:
+
+      glm_node_heap();
+
+      std::size_t memory_size() const { return num_words*sizeof(word_type); }
+
+      word_type* allocate(std::size_t num_bytes);
+
+      void clear();
+      void reset();
+
+      void adopt(glm_node_heap& other);
+
+    private:
+
+      std::vector<std::unique_ptr<word_type[]> > blocks;
+
+      // payloads larger than a block, these are not reused
+      std::vector<std::unique_ptr<word_type[]> > large_blocks;
+
+      // the block that is currently filled and the #-words used in it
+      std::size_t curr, used;
+
+      std::size_t num_words;
+    };
+
+    glm_node_heap::glm_node_heap():
+      blocks(),
+      large_blocks(),
+
+      curr(0),
+      used(BLOCK_SIZE),
+
+      num_words(0)
+    {}
+
+    typename glm_node_heap::word_type* glm_node_heap::allocate(std::size_t num_bytes)
+    {
+      std::size_t len = (num_bytes+sizeof(word_type)-1)/sizeof(word_type);
+
+      if(len>BLOCK_SIZE)
+        {
+          large_blocks.push_back(std::unique_ptr<word_type[]>(new word_type[len]));
+          num_words += len;
+
+          return large_blocks.back().get();
+        }
+
+      if(used+len>BLOCK_SIZE)
+        {
+          curr = (blocks.size()==0? 0: curr+1);
+          used = 0;
+
+          // blocks kept by `reset` are filled again before new ones are added
+          if(curr==blocks.size())
+            {
+              blocks.push_back(std::unique_ptr<word_type[]>(new word_type[BLOCK_SIZE]));
+              num_words += BLOCK_SIZE;
+            }
+        }
+
+      word_type* ptr = blocks.at(curr).get()+used;
+      used += len;
+
+      return ptr;
+    }
+
+    void glm_node_heap::clear()
+    {
+      blocks.clear();
+      large_blocks.clear();
+
+      curr = 0;
+      used = BLOCK_SIZE;
+
+      num_words = 0;
+    }
+
+    void glm_node_heap::reset()
+    {
+      large_blocks.clear();
+
+      // blocks that were not needed since the last reset are released
+      if(blocks.size()>curr+1)
+        {
+          blocks.resize(curr+1);
+        }
+
+      curr = 0;
+      used = (blocks.size()==0? BLOCK_SIZE: 0);
+
+      num_words = blocks.size()*BLOCK_SIZE;
+    }
+
+    /*
+     * Takes over the memory of `other` (eg an arena that was filled by
+     * another thread), so the payloads in it stay valid. The adopted
+     * blocks are not reused after a `reset`.
+     */
+    void glm_node_heap::adopt(glm_node_heap& other)
+    {
+      for(auto& block:other.blocks)
+        {
+          large_blocks.push_back(std::move(block));
+        }
+
+      for(auto& block:other.large_blocks)
+        {
+          large_blocks.push_back(std::move(block));
+        }
+
+      num_words += other.num_words;
+
+      other.clear();
+    }
+
+  }
+
+}
+
+#endif
@@ -0,0 +1,587 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_BINARY_H_
+#define ANDROMEDA_MODELS_GLM_BINARY_H_
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Versioned on-disk layout (v2) of `nodes.bin` and `edges.bin`. A file
+     * starts with a fixed header, followed by flat columns. Every column is
+     * padded to a multiple of 8 bytes, so that all columns are properly
+     * aligned when the file is memory-mapped and can be used in place.
+     *
+     * Files without the magic number are v1 files, which are read element
+     * by element.
+     *
+     * The compressed layout (v3) shares the header, but the items are
+     * encoded with varints in blocks of (at most) BLOCK_SIZE items. Every
+     * block can be decoded on its own, so blocks are decoded in parallel.
+     * A v3 file can not be memory-mapped in place, it is always decoded.
+     */
+    class glm_binary: public base_types
+    {
+    public:
+
+      const static inline uint64_t MAGIC = 0x32564d4c47444e41; // "ANDGLMV2"
+      const static inline uint32_t VERSION = 2;
+      const static inline uint32_t COMPRESSED_VERSION = 3;
+
+      const static inline std::size_t ALIGNMENT = 8;
+
+      const static inline std::size_t BLOCK_SIZE = 1<<16; // #-items per compressed block
+
+      enum section_name
+        {
+         NODES_SECTION=1,
+         EDGES_SECTION=2
+        };
+
+      struct header_type
+      {
+        uint64_t magic;
+
+        uint32_t version;
+        uint32_t section;
+
+        uint64_t num_flavors;
+        uint64_t num_items;
+      };
+
+      /* encoded items [beg, end) of a compressed block */
+      struct block_type
+      {
+        std::size_t beg, end;
+
+        const uint8_t* data;
+        std::size_t len;
+      };
+
+      /*
+       * Cursor over the bytes of a compressed block. Reading past the end
+       * of the block invalidates the cursor.
+       */
+      class decoder_type
+      {
+      public:
+
+        decoder_type(const block_type& block):
+          ptr(block.data), end(block.data+block.len), valid(block.data!=NULL or block.len==0)
+        {}
+
+        bool good() const { return valid; }
+
+        std::size_t remaining() const { return end-ptr; }
+        void invalidate() { valid = false; }
+
+        uint64_t read_varint()
+        {
+          uint64_t val=0;
+          for(int shift=0; shift<64; shift+=7)
+            {
+              if(ptr==end)
+                {
+                  valid = false;
+                  return 0;
+                }
+
+              uint8_t byte = *(ptr++);
+              val |= (uint64_t(byte & 0x7f) << shift);
+
+              if((byte & 0x80)==0)
+                {
+                  return val;
+                }
+            }
+
+          valid = false;
+          return 0;
+        }
+
+        int64_t read_signed() { return from_zigzag(read_varint()); }
+
+        template<typename value_type>
+        void read_values(value_type* vals, std::size_t num)
+        {
+          // `num` comes from the file, so it is checked before it is multiplied
+          if((not valid) or num>std::size_t(end-ptr)/sizeof(value_type))
+            {
+              valid = false;
+              return;
+            }
+
+          std::size_t num_bytes = num*sizeof(value_type);
+
+          std::memcpy(vals, ptr, num_bytes);
+          ptr += num_bytes;
+        }
+
+      private:
+
+        const uint8_t* ptr;
+        const uint8_t* end;
+
+        bool valid;
+      };
+
+      /*
+       * Cursor over a (mapped) binary buffer. Columns are returned as
+       * pointers into the buffer, nothing is copied.
+       */
+      class reader_type
+      {
+      public:
+
+        reader_type(const char* beg, const char* end):
+          ptr(beg), end(end), valid(beg!=NULL)
+        {}
+
+        bool good() const { return valid; }
+
+        template<typename value_type>
+        value_type read_value()
+        {
+          const value_type* val = read_column<value_type>(1);
+          return (val==NULL? value_type(): *val);
+        }
+
+        template<typename value_type>
+        const value_type* read_column(std::size_t num)
+        {
+          // `num` comes from the file, so it is checked before it is multiplied
+          if((not valid) or num>std::size_t(end-ptr)/sizeof(value_type))
+            {
+              valid = false;
+              return NULL;
+            }
+
+          std::size_t num_bytes = padded_size(num*sizeof(value_type));
+
+          if(std::size_t(end-ptr)<num_bytes)
+            {
+              valid = false;
+              return NULL;
+            }
+
+          const value_type* result = reinterpret_cast<const value_type*>(ptr);
+          ptr += num_bytes;
+
+          return result;
+        }
+
+      private:
+
+        const char* ptr;
+        const char* end;
+
+        bool valid;
+      };
+
+    public:
+
+      static std::size_t padded_size(std::size_t num_bytes)
+      {
+        return ((num_bytes+ALIGNMENT-1)/ALIGNMENT)*ALIGNMENT;
+      }
+
+      static bool is_binary(const std::filesystem::path& path);
+
+      // 0 for files without header (v1)
+      static uint32_t get_version(const std::filesystem::path& path);
+
+      static void write_header(std::ofstream& ofs, section_name section,
+                               std::size_t num_flavors, std::size_t num_items,
+                               uint32_t version=VERSION);
+
+      static bool read_header(reader_type& reader, section_name section,
+                              header_type& header, uint32_t version=VERSION);
+
+      static uint64_t to_zigzag(int64_t val) { return (uint64_t(val) << 1) ^ uint64_t(val >> 63); }
+      static int64_t from_zigzag(uint64_t val) { return int64_t(val >> 1) ^ -int64_t(val & 1); }
+
+      static void write_varint(std::vector<uint8_t>& buffer, uint64_t val);
+      static void write_signed(std::vector<uint8_t>& buffer, int64_t val) { write_varint(buffer, to_zigzag(val)); }
+
+      template<typename value_type>
+      static void write_values(std::vector<uint8_t>& buffer, const value_type* vals, std::size_t num)
+      {
+        const uint8_t* ptr = reinterpret_cast<const uint8_t*>(vals);
+        buffer.insert(buffer.end(), ptr, ptr+num*sizeof(value_type));
+      }
+
+      template<typename encode_type>
+      static void write_blocks(std::ofstream& ofs, std::size_t num_items, encode_type encode);
+
+      static bool read_blocks(reader_type& reader, std::size_t num_items,
+                              std::vector<block_type>& blocks);
+
+      template<typename value_type>
+      static void write_value(std::ofstream& ofs, value_type val)
+      {
+        write_column(ofs, &val, 1);
+      }
+
+      template<typename value_type>
+      static void write_column(std::ofstream& ofs, const value_type* vals, std::size_t num)
+      {
+        std::size_t num_bytes = num*sizeof(value_type);
+        if(num_bytes>0)
+          {
+            ofs.write((const char*)vals, num_bytes);
+          }
+
+        const static char padding[ALIGNMENT] = {0};
+        ofs.write(padding, padded_size(num_bytes)-num_bytes);
+      }
+
+      template<typename value_type>
+      static void write_column(std::ofstream& ofs, const std::vector<value_type>& vals)
+      {
+        write_column(ofs, vals.data(), vals.size());
+      }
+    };
+
+    /*
+     * Column that either owns its values or is a read-only view into a
+     * mapped binary. Copies of a view share the underlying memory.
+     */
+    template<typename value_type>
+    class glm_column
+    {
+    public:
+
+      glm_column():
+        values({}),
+        view(NULL),
+        num(0)
+      {}
+
+      std::size_t size() const { return (view==NULL? values.size(): num); }
+      std::size_t memory_size() const { return values.capacity()*sizeof(value_type); }
+
+      bool is_view() const { return (view!=NULL); }
+
+      const value_type* data() const { return (view==NULL? values.data(): view); }
+      const value_type& operator[](std::size_t ind) const { return data()[ind]; }
+
+      void clear() { values.clear(); view=NULL; num=0; }
+
+      void assign(std::vector<value_type>&& vals) { values = std::move(vals); view=NULL; num=0; }
+      void attach(const value_type* ptr, std::size_t len) { values.clear(); view=ptr; num=len; }
+
+    private:
+
+      std::vector<value_type> values;
+
+      const value_type* view;
+      std::size_t num;
+    };
+
+    /*
+     * Read-only column of unsigned integers. Owned values are stored in the
+     * smallest width (1, 2, 4 or 8 bytes) that fits their maximum, which is
+     * chosen once in `assign`. The values are returned exactly, in their
+     * full type. A view into a mapped binary keeps the full width, a view
+     * on another packed column shares its width.
+     */
+    template<typename value_type>
+    class glm_packed_column
+    {
+      typedef uint64_t word_type;
+
+    public:
+
+      glm_packed_column():
+        words({}),
+        ptr(NULL),
+        width(sizeof(value_type)),
+        num(0)
+      {}
+
+      // a copy of owned values points into its own words
+      glm_packed_column(const glm_packed_column& other):
+        words(other.words),
+        ptr(other.words.empty()? other.ptr: words.data()),
+        width(other.width),
+        num(other.num)
+      {}
+
+      glm_packed_column& operator=(const glm_packed_column& other)
+      {
+        words = other.words;
+        ptr = (other.words.empty()? other.ptr: words.data());
+        width = other.width;
+        num = other.num;
+
+        return *this;
+      }
+
+      std::size_t size() const { return num; }
+      std::size_t memory_size() const { return words.capacity()*sizeof(word_type); }
+
+      std::size_t get_width() const { return width; }
+
+      bool is_view() const { return (ptr!=NULL and words.empty()); }
+
+      value_type operator[](std::size_t ind) const
+      {
+        switch(width)
+          {
+          case 1: { return static_cast<const uint8_t*>(ptr)[ind]; }
+          case 2: { return static_cast<const uint16_t*>(ptr)[ind]; }
+          case 4: { return static_cast<const uint32_t*>(ptr)[ind]; }
+          default: { return static_cast<const value_type*>(ptr)[ind]; }
+          }
+      }
+
+      void clear() { std::vector<word_type>().swap(words); ptr=NULL; width=sizeof(value_type); num=0; }
+
+      void assign(const std::vector<value_type>& vals);
+      void attach(const value_type* vals, std::size_t len) { clear(); ptr=vals; num=len; }
+      void attach(const glm_packed_column& other) { clear(); ptr=other.ptr; width=other.width; num=other.num; }
+
+      // the values in full width
+      void get(std::vector<value_type>& vals) const;
+
+      void write(std::ofstream& ofs) const;
+
+    private:
+
+      template<typename packed_type>
+      void pack(const std::vector<value_type>& vals);
+
+    private:
+
+      std::vector<word_type> words;
+
+      const void* ptr;
+      std::size_t width, num;
+    };
+
+    template<typename value_type>
+    void glm_packed_column<value_type>::assign(const std::vector<value_type>& vals)
+    {
+      static_assert(std::is_unsigned<value_type>::value);
+
+      clear();
+
+      value_type max_val=0;
+      for(value_type val:vals)
+        {
+          max_val = std::max(max_val, val);
+        }
+
+      if(max_val<=std::numeric_limits<uint8_t>::max())
+        {
+          pack<uint8_t>(vals);
+        }
+      else if(max_val<=std::numeric_limits<uint16_t>::max())
+        {
+          pack<uint16_t>(vals);
+        }
+      else if(max_val<=std::numeric_limits<uint32_t>::max())
+        {
+          pack<uint32_t>(vals);
+        }
+      else
+        {
+          pack<value_type>(vals);
+        }
+    }
+
+    template<typename value_type>
+    template<typename packed_type>
+    void glm_packed_column<value_type>::pack(const std::vector<value_type>& vals)
+    {
+      words.resize((vals.size()*sizeof(packed_type)+sizeof(word_type)-1)/sizeof(word_type));
+
+      packed_type* packed = reinterpret_cast<packed_type*>(words.data());
+      for(std::size_t ind=0; ind<vals.size(); ind++)
+        {
+          packed[ind] = vals[ind];
+        }
+
+      ptr = words.data();
+      width = sizeof(packed_type);
+      num = vals.size();
+    }
+
+    template<typename value_type>
+    void glm_packed_column<value_type>::get(std::vector<value_type>& vals) const
+    {
+      vals.resize(num);
+      for(std::size_t ind=0; ind<num; ind++)
+        {
+          vals[ind] = (*this)[ind];
+        }
+    }
+
+    /* always written in the full width, so the binary can be mapped */
+    template<typename value_type>
+    void glm_packed_column<value_type>::write(std::ofstream& ofs) const
+    {
+      if(width==sizeof(value_type))
+        {
+          glm_binary::write_column(ofs, static_cast<const value_type*>(ptr), num);
+          return;
+        }
+
+      std::vector<value_type> vals;
+      get(vals);
+
+      glm_binary::write_column(ofs, vals);
+    }
+
+    bool glm_binary::is_binary(const std::filesystem::path& path)
+    {
+      std::ifstream ifs(path.c_str(), std::ios::binary);
+
+      uint64_t magic=0;
+      ifs.read((char*)&magic, sizeof(magic));
+
+      return (ifs.good() and magic==MAGIC);
+    }
+
+    uint32_t glm_binary::get_version(const std::filesystem::path& path)
+    {
+      std::ifstream ifs(path.c_str(), std::ios::binary);
+
+      header_type header;
+      ifs.read((char*)&header, sizeof(header));
+
+      return ((ifs.good() and header.magic==MAGIC)? header.version: 0);
+    }
+
+    void glm_binary::write_header(std::ofstream& ofs, section_name section,
+                                  std::size_t num_flavors, std::size_t num_items,
+                                  uint32_t version)
+    {
+      header_type header;
+      {
+        header.magic = MAGIC;
+
+        header.version = version;
+        header.section = section;
+
+        header.num_flavors = num_flavors;
+        header.num_items = num_items;
+      }
+
+      write_value(ofs, header);
+    }
+
+    bool glm_binary::read_header(reader_type& reader, section_name section,
+                                 header_type& header, uint32_t version)
+    {
+      header = reader.read_value<header_type>();
+
+      if(not reader.good() or header.magic!=MAGIC)
+        {
+          LOG_S(ERROR) << "no GLM binary header found";
+          return false;
+        }
+
+      if(header.version!=version or header.section!=section)
+        {
+          LOG_S(ERROR) << "unsupported GLM binary (version: " << header.version
+                       << ", section: " << header.section << ")";
+          return false;
+        }
+
+      return true;
+    }
+
+    void glm_binary::write_varint(std::vector<uint8_t>& buffer, uint64_t val)
+    {
+      while(val>=0x80)
+        {
+          buffer.push_back(uint8_t(val) | 0x80);
+          val >>= 7;
+        }
+
+      buffer.push_back(uint8_t(val));
+    }
+
+    /*
+     * Writes the items [0, num_items) as a sequence of blocks, for which
+     * `encode(beg, end, buffer)` appends the encoded items [beg, end) to the
+     * buffer. The byte-lengths of the blocks precede the blocks: the blocks
+     * are streamed one by one, and the lengths are filled in afterwards, so
+     * only one encoded block is in memory at a time.
+     */
+    template<typename encode_type>
+    void glm_binary::write_blocks(std::ofstream& ofs, std::size_t num_items, encode_type encode)
+    {
+      std::size_t num_blocks = (num_items+BLOCK_SIZE-1)/BLOCK_SIZE;
+
+      std::vector<uint64_t> lengths(num_blocks, 0);
+
+      write_value(ofs, uint64_t(BLOCK_SIZE));
+      write_value(ofs, uint64_t(num_blocks));
+
+      std::streampos lengths_pos = ofs.tellp();
+      write_column(ofs, lengths);
+
+      std::vector<uint8_t> buffer={};
+      for(std::size_t l=0; l<num_blocks; l++)
+        {
+          buffer.clear();
+          encode(l*BLOCK_SIZE, std::min((l+1)*BLOCK_SIZE, num_items), buffer);
+
+          lengths[l] = buffer.size();
+          write_column(ofs, buffer);
+        }
+
+      std::streampos end_pos = ofs.tellp();
+
+      ofs.seekp(lengths_pos);
+      write_column(ofs, lengths);
+      ofs.seekp(end_pos);
+    }
+
+    bool glm_binary::read_blocks(reader_type& reader, std::size_t num_items,
+                                 std::vector<block_type>& blocks)
+    {
+      std::size_t block_size = reader.read_value<uint64_t>();
+      std::size_t num_blocks = reader.read_value<uint64_t>();
+
+      const uint64_t* lengths = reader.read_column<uint64_t>(num_blocks);
+
+      if((not reader.good()) or block_size==0 or
+         num_blocks!=(num_items/block_size + (num_items%block_size==0? 0:1)))
+        {
+          LOG_S(ERROR) << "corrupt compressed blocks";
+          return false;
+        }
+
+      blocks.clear();
+      for(std::size_t l=0; l<num_blocks; l++)
+        {
+          block_type block;
+          {
+            block.beg = l*block_size;
+            block.end = std::min((l+1)*block_size, num_items);
+
+            block.len = lengths[l];
+            block.data = reader.read_column<uint8_t>(block.len);
+          }
+
+          if(not reader.good())
+            {
+              LOG_S(ERROR) << "corrupt compressed blocks";
+              return false;
+            }
+
+          blocks.push_back(block);
+        }
+
+      return true;
+    }
+
+  }
+
+}
+
+#endif
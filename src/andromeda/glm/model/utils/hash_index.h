@@ -0,0 +1,621 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_HASH_INDEX_H_
+#define ANDROMEDA_MODELS_GLM_HASH_INDEX_H_
+
+#include <bit>
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Open-addressing (linear probing) index from an already mixed 64-bit
+     * node/edge hash to a packed (flavor, index) key. Every slot is 16 bytes
+     * (hash + packed key), so a probe touches a single cache-line in the
+     * common case and there is no per-entry heap allocation.
+     *
+     * The slot-table can be written to disk and attached again as a
+     * read-only view (eg into a memory-mapped file). The first mutation of
+     * an attached index copies the view into owned memory.
+     */
+    class glm_hash_index: public base_types
+    {
+    public:
+
+      typedef std::pair<flvr_type, ind_type> key_type;
+
+      const static inline hash_type EMPTY_HASH = 0;
+
+      const static inline int FLVR_SHIFT = 48;
+      const static inline uint64_t IND_MASK = (uint64_t(1) << FLVR_SHIFT) - 1;
+
+      const static inline std::size_t MIN_BUCKETS = 16;
+
+      struct slot_type
+      {
+        hash_type hash;
+        uint64_t  value;
+      };
+
+    public:
+
+      glm_hash_index();
+      ~glm_hash_index();
+
+      std::size_t size() const { return num_items; }
+      std::size_t bucket_count() const { return num_slots; }
+
+      bool is_view() const { return (view!=NULL); }
+
+      double load_factor() const;
+
+      double max_load_factor() const { return max_load; }
+      void max_load_factor(double mlf);
+
+      std::size_t memory_size() const;
+
+      void clear();
+      void reserve(std::size_t N);
+
+      void reset(std::size_t N);
+
+      std::size_t count(hash_type hash) const;
+
+      bool find(hash_type hash, key_type& key) const;
+      key_type at(hash_type hash) const;
+
+      bool insert(hash_type hash, key_type key);
+      void assign(hash_type hash, key_type key);
+
+      bool update(hash_type hash, key_type key);
+
+      template<typename hash_func_type>
+      void build(const std::vector<std::pair<flvr_type, std::size_t> >& sizes,
+                 hash_func_type hash_of, std::size_t num_threads);
+
+      std::size_t probe_length(std::size_t bucket) const;
+
+      void write(std::ofstream& ofs) const;
+      bool attach(glm_binary::reader_type& reader);
+
+      void detach();
+
+      static uint64_t pack(key_type key) { return (uint64_t(key.first) << FLVR_SHIFT) | (key.second & IND_MASK); }
+      static key_type unpack(uint64_t val) { return key_type(flvr_type(val >> FLVR_SHIFT), val & IND_MASK); }
+
+    private:
+
+      std::size_t to_bucket(hash_type hash) const { return (hash*0x9e3779b97f4a7c15ULL) >> shift; }
+
+      std::size_t lookup(hash_type hash) const;
+
+      void rehash(std::size_t num_buckets);
+
+      const slot_type* table() const { return (view==NULL? slots.data(): view); }
+
+      void set_table(const slot_type* ptr, std::size_t num_buckets);
+
+    private:
+
+      double max_load;
+
+      std::size_t num_items, shift, mask;
+      std::vector<slot_type> slots;
+
+      // read-only slot-table (see `attach`), NULL if the slots are owned
+      const slot_type* view;
+      std::size_t num_slots;
+
+      // the EMPTY_HASH can not live in the table itself
+      bool     has_empty;
+      uint64_t empty_value;
+    };
+
+    glm_hash_index::glm_hash_index():
+      max_load(0.75),
+
+      num_items(0),
+      shift(64),
+      mask(0),
+      slots({}),
+
+      view(NULL),
+      num_slots(0),
+
+      has_empty(false),
+      empty_value(0)
+    {}
+
+    glm_hash_index::~glm_hash_index()
+    {}
+
+    double glm_hash_index::load_factor() const
+    {
+      return (num_slots==0? 0.0: double(num_items)/double(num_slots));
+    }
+
+    void glm_hash_index::max_load_factor(double mlf)
+    {
+      max_load = std::clamp(mlf, 0.1, 0.95);
+    }
+
+    std::size_t glm_hash_index::memory_size() const
+    {
+      return sizeof(*this) + slots.capacity()*sizeof(slot_type);
+    }
+
+    void glm_hash_index::clear()
+    {
+      num_items = 0;
+      shift = 64;
+      mask = 0;
+
+      slots.clear();
+      slots.shrink_to_fit();
+
+      view = NULL;
+      num_slots = 0;
+
+      has_empty = false;
+      empty_value = 0;
+    }
+
+    void glm_hash_index::reserve(std::size_t N)
+    {
+      std::size_t num_buckets = MIN_BUCKETS;
+      while(num_buckets*max_load < N)
+        {
+          num_buckets *= 2;
+        }
+
+      if(num_buckets>num_slots)
+        {
+          rehash(num_buckets);
+        }
+    }
+
+    /*
+     * Removes all items, but keeps the slot-table for the next N items as
+     * long as it is not far larger than needed. This avoids reallocating
+     * (and faulting in) the table when an index is refilled over and over.
+     */
+    void glm_hash_index::reset(std::size_t N)
+    {
+      std::size_t num_buckets = MIN_BUCKETS;
+      while(num_buckets*max_load < N)
+        {
+          num_buckets *= 2;
+        }
+
+      if(is_view() or num_slots>4*num_buckets)
+        {
+          clear();
+        }
+      else
+        {
+          std::fill(slots.begin(), slots.end(), slot_type({EMPTY_HASH, 0}));
+
+          num_items = 0;
+
+          has_empty = false;
+          empty_value = 0;
+        }
+
+      reserve(N);
+    }
+
+    std::size_t glm_hash_index::count(hash_type hash) const
+    {
+      if(hash==EMPTY_HASH)
+        {
+          return (has_empty? 1:0);
+        }
+
+      return (lookup(hash)<num_slots? 1:0);
+    }
+
+    bool glm_hash_index::find(hash_type hash, key_type& key) const
+    {
+      if(hash==EMPTY_HASH)
+        {
+          if(has_empty)
+            {
+              key = unpack(empty_value);
+            }
+
+          return has_empty;
+        }
+
+      std::size_t ind = lookup(hash);
+      if(ind<num_slots)
+        {
+          key = unpack(table()[ind].value);
+          return true;
+        }
+
+      return false;
+    }
+
+    typename glm_hash_index::key_type glm_hash_index::at(hash_type hash) const
+    {
+      key_type key;
+      if(not find(hash, key))
+        {
+          throw std::out_of_range("glm_hash_index::at: unknown hash");
+        }
+
+      return key;
+    }
+
+    bool glm_hash_index::insert(hash_type hash, key_type key)
+    {
+      detach();
+
+      if(hash==EMPTY_HASH)
+        {
+          if(has_empty)
+            {
+              return false;
+            }
+
+          has_empty = true;
+          empty_value = pack(key);
+
+          num_items += 1;
+          return true;
+        }
+
+      if((num_items+1) > max_load*num_slots)
+        {
+          rehash(std::max(MIN_BUCKETS, 2*num_slots));
+        }
+
+      std::size_t ind = to_bucket(hash);
+      while(true)
+        {
+          slot_type& slot = slots[ind];
+
+          if(slot.hash==hash)
+            {
+              return false;
+            }
+          else if(slot.hash==EMPTY_HASH)
+            {
+              slot.hash = hash;
+              slot.value = pack(key);
+
+              num_items += 1;
+              return true;
+            }
+
+          ind = (ind+1) & mask;
+        }
+
+      return false;
+    }
+
+    void glm_hash_index::assign(hash_type hash, key_type key)
+    {
+      detach();
+
+      if(hash==EMPTY_HASH and has_empty)
+        {
+          empty_value = pack(key);
+          return;
+        }
+
+      std::size_t ind = (hash==EMPTY_HASH? num_slots: lookup(hash));
+      if(ind<num_slots)
+        {
+          slots[ind].value = pack(key);
+        }
+      else
+        {
+          insert(hash, key);
+        }
+    }
+
+    /*
+     * Only changes the key of an existing hash and never touches the layout
+     * of the table, hence concurrent updates of different hashes are safe
+     * (as long as the index is not a view, see `detach`).
+     */
+    bool glm_hash_index::update(hash_type hash, key_type key)
+    {
+      if(hash==EMPTY_HASH)
+        {
+          if(has_empty)
+            {
+              empty_value = pack(key);
+            }
+
+          return has_empty;
+        }
+
+      std::size_t ind = lookup(hash);
+      if(ind<num_slots and view==NULL)
+        {
+          slots[ind].value = pack(key);
+          return true;
+        }
+
+      return false;
+    }
+
+    /*
+     * Rebuilds the index for the keys (flvr, ind) with ind<size for every
+     * flavor in `sizes`, where `hash_of(flvr, ind)` returns their hash. The
+     * table is split in contiguous bucket-ranges (shards) that are filled
+     * concurrently: a thread only inserts the hashes that start in its own
+     * shard. Hashes whose probe runs past the end of their shard are
+     * inserted afterwards, so the probe sequences are the same as if the
+     * hashes were inserted one by one.
+     */
+    template<typename hash_func_type>
+    void glm_hash_index::build(const std::vector<std::pair<flvr_type, std::size_t> >& sizes,
+                               hash_func_type hash_of, std::size_t num_threads)
+    {
+      typedef std::pair<hash_type, key_type> item_type;
+
+      clear();
+
+      std::vector<std::size_t> offsets={0};
+      for(auto& item:sizes)
+        {
+          offsets.push_back(offsets.back()+item.second);
+        }
+
+      reserve(offsets.back());
+
+      // the hashes are computed once, every shard scans all of them
+      std::vector<hash_type> hashes(offsets.back());
+      glm_parallel::for_each(sizes.size(), num_threads, [&](std::size_t l)
+      {
+        for(std::size_t ind=0; ind<sizes[l].second; ind++)
+          {
+            hashes[offsets[l]+ind] = hash_of(sizes[l].first, ind);
+          }
+      });
+
+      std::size_t num_shards = std::min(glm_parallel::number_of_threads(num_threads),
+                                        num_slots/MIN_BUCKETS);
+
+      std::vector<std::vector<item_type> > deferred(num_shards);
+      std::vector<std::size_t> counts(num_shards, 0);
+
+      glm_parallel::for_each(num_shards, num_threads, [&](std::size_t shard)
+      {
+        std::size_t beg = (shard*num_slots)/num_shards;
+        std::size_t end = ((shard+1)*num_slots)/num_shards;
+
+        for(std::size_t l=0; l<sizes.size(); l++)
+          {
+            for(std::size_t ind=0; ind<sizes[l].second; ind++)
+              {
+                hash_type hash = hashes[offsets[l]+ind];
+                key_type key(sizes[l].first, ind);
+
+                if(hash==EMPTY_HASH)
+                  {
+                    if(shard==0)
+                      {
+                        deferred[shard].emplace_back(hash, key);
+                      }
+
+                    continue;
+                  }
+
+                std::size_t bucket = to_bucket(hash);
+                if(bucket<beg or end<=bucket)
+                  {
+                    continue;
+                  }
+
+                while(true)
+                  {
+                    if(bucket==end)
+                      {
+                        deferred[shard].emplace_back(hash, key);
+                        break;
+                      }
+
+                    slot_type& slot = slots[bucket];
+
+                    if(slot.hash==hash)
+                      {
+                        break;
+                      }
+                    else if(slot.hash==EMPTY_HASH)
+                      {
+                        slot.hash = hash;
+                        slot.value = pack(key);
+
+                        counts[shard] += 1;
+                        break;
+                      }
+
+                    bucket += 1;
+                  }
+              }
+          }
+      });
+
+      for(std::size_t cnt:counts)
+        {
+          num_items += cnt;
+        }
+
+      for(auto& items:deferred)
+        {
+          for(auto& item:items)
+            {
+              insert(item.first, item.second);
+            }
+        }
+    }
+
+    std::size_t glm_hash_index::probe_length(std::size_t bucket) const
+    {
+      const slot_type& slot = table()[bucket];
+      if(slot.hash==EMPTY_HASH)
+        {
+          return 0;
+        }
+
+      return ((bucket-to_bucket(slot.hash)) & mask)+1;
+    }
+
+    std::size_t glm_hash_index::lookup(hash_type hash) const
+    {
+      if(num_slots==0)
+        {
+          return num_slots;
+        }
+
+      std::size_t ind = to_bucket(hash);
+      while(true)
+        {
+          const slot_type& slot = table()[ind];
+
+          if(slot.hash==hash)
+            {
+              return ind;
+            }
+          else if(slot.hash==EMPTY_HASH)
+            {
+              return num_slots;
+            }
+
+          ind = (ind+1) & mask;
+        }
+
+      return num_slots;
+    }
+
+    void glm_hash_index::set_table(const slot_type* ptr, std::size_t num_buckets)
+    {
+      view = ptr;
+      num_slots = num_buckets;
+
+      mask = (num_buckets==0? 0: num_buckets-1);
+      shift = (num_buckets==0? 64: 64-std::countr_zero(num_buckets));
+    }
+
+    void glm_hash_index::rehash(std::size_t num_buckets)
+    {
+      detach();
+
+      std::vector<slot_type> old_slots(num_buckets, slot_type({EMPTY_HASH, 0}));
+      old_slots.swap(slots);
+
+      set_table(NULL, slots.size());
+
+      for(const slot_type& old_slot:old_slots)
+        {
+          if(old_slot.hash==EMPTY_HASH)
+            {
+              continue;
+            }
+
+          std::size_t ind = to_bucket(old_slot.hash);
+          while(slots[ind].hash!=EMPTY_HASH)
+            {
+              ind = (ind+1) & mask;
+            }
+
+          slots[ind] = old_slot;
+        }
+    }
+
+    void glm_hash_index::write(std::ofstream& ofs) const
+    {
+      // the table is often reserved far beyond its content (e.g. during
+      // create), so we write a right-sized copy
+      std::size_t num_buckets = MIN_BUCKETS;
+      while(num_buckets*max_load < num_items)
+        {
+          num_buckets *= 2;
+        }
+
+      if(num_buckets>=num_slots)
+        {
+          glm_binary::write_value(ofs, uint64_t(num_items));
+          glm_binary::write_value(ofs, uint64_t(num_slots));
+
+          glm_binary::write_value(ofs, uint64_t(has_empty? 1:0));
+          glm_binary::write_value(ofs, empty_value);
+
+          glm_binary::write_column(ofs, table(), num_slots);
+          return;
+        }
+
+      glm_hash_index compact;
+      {
+        compact.max_load = max_load;
+        compact.rehash(num_buckets);
+
+        const slot_type* old_slots = table();
+        for(std::size_t l=0; l<num_slots; l++)
+          {
+            if(old_slots[l].hash==EMPTY_HASH)
+              {
+                continue;
+              }
+
+            std::size_t ind = compact.to_bucket(old_slots[l].hash);
+            while(compact.slots[ind].hash!=EMPTY_HASH)
+              {
+                ind = (ind+1) & compact.mask;
+              }
+
+            compact.slots[ind] = old_slots[l];
+          }
+
+        compact.num_items = num_items;
+
+        compact.has_empty = has_empty;
+        compact.empty_value = empty_value;
+      }
+
+      compact.write(ofs);
+    }
+
+    bool glm_hash_index::attach(glm_binary::reader_type& reader)
+    {
+      clear();
+
+      num_items = reader.read_value<uint64_t>();
+      std::size_t num_buckets = reader.read_value<uint64_t>();
+
+      has_empty = (reader.read_value<uint64_t>()==1);
+      empty_value = reader.read_value<uint64_t>();
+
+      const slot_type* ptr = reader.read_column<slot_type>(num_buckets);
+
+      if((not reader.good()) or (num_buckets & (num_buckets-1))!=0)
+        {
+          LOG_S(ERROR) << "corrupt hash-index section";
+
+          clear();
+          return false;
+        }
+
+      set_table(ptr, num_buckets);
+      return true;
+    }
+
+    void glm_hash_index::detach()
+    {
+      if(is_view())
+        {
+          slots.assign(view, view+num_slots);
+          set_table(NULL, slots.size());
+        }
+    }
+
+  }
+
+}
+
+#endif
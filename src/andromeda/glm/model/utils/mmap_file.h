@@ -0,0 +1,142 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_MMAP_FILE_H_
+#define ANDROMEDA_MODELS_GLM_MMAP_FILE_H_
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Read-only mapping of a complete file. On POSIX systems the file is
+     * mapped shared, so that processes loading the same model share the
+     * page-cache. On Windows we fall back to reading the file into an
+     * (8-byte aligned) buffer.
+     */
+    class glm_mmap_file
+    {
+    public:
+
+      glm_mmap_file();
+      ~glm_mmap_file();
+
+      glm_mmap_file(const glm_mmap_file&) = delete;
+      glm_mmap_file& operator=(const glm_mmap_file&) = delete;
+
+      bool is_open() const { return (ptr!=NULL); }
+
+      const char* data() const { return ptr; }
+      std::size_t size() const { return len; }
+
+      std::filesystem::path get_path() const { return path; }
+
+      bool open(std::filesystem::path path);
+      void close();
+
+    private:
+
+      std::filesystem::path path;
+
+      const char* ptr;
+      std::size_t len;
+
+      std::vector<uint64_t> buffer; // only used without mmap
+    };
+
+    glm_mmap_file::glm_mmap_file():
+      path(),
+
+      ptr(NULL),
+      len(0),
+
+      buffer({})
+    {}
+
+    glm_mmap_file::~glm_mmap_file()
+    {
+      close();
+    }
+
+    bool glm_mmap_file::open(std::filesystem::path path_)
+    {
+      close();
+
+      path = path_;
+
+      std::error_code ec;
+      std::size_t num_bytes = std::filesystem::file_size(path, ec);
+
+      if(ec or num_bytes==0)
+        {
+          LOG_S(ERROR) << "can not map file " << path << ": " << ec.message();
+          return false;
+        }
+
+#ifndef _WIN32
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if(fd<0)
+        {
+          LOG_S(ERROR) << "can not open file " << path;
+          return false;
+        }
+
+      void* addr = ::mmap(NULL, num_bytes, PROT_READ, MAP_SHARED, fd, 0);
+      ::close(fd);
+
+      if(addr==MAP_FAILED)
+        {
+          LOG_S(ERROR) << "mmap failed for file " << path;
+          return false;
+        }
+
+      ptr = static_cast<const char*>(addr);
+      len = num_bytes;
+#else
+      std::ifstream ifs(path, std::ios::binary);
+
+      buffer.resize((num_bytes+sizeof(uint64_t)-1)/sizeof(uint64_t), 0);
+      ifs.read((char*)buffer.data(), num_bytes);
+
+      if(not ifs.good())
+        {
+          LOG_S(ERROR) << "can not read file " << path;
+
+          buffer.clear();
+          return false;
+        }
+
+      ptr = (const char*)buffer.data();
+      len = num_bytes;
+#endif
+
+      return true;
+    }
+
+    void glm_mmap_file::close()
+    {
+#ifndef _WIN32
+      if(ptr!=NULL)
+        {
+          ::munmap((void*)ptr, len);
+        }
+#else
+      buffer.clear();
+      buffer.shrink_to_fit();
+#endif
+
+      ptr = NULL;
+      len = 0;
+    }
+
+  }
+
+}
+
+#endif
@@ -0,0 +1,139 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_PARALLEL_H_
+#define ANDROMEDA_MODELS_GLM_PARALLEL_H_
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Minimal task-parallel helpers. `for_each` is meant for work that
+     * splits naturally in a few independent and unevenly sized items (eg
+     * the flavors of the nodes or edges): items are handed out one at a
+     * time, so a large item does not hold up the others. The calling thread
+     * takes part in the work.
+     */
+    class glm_parallel
+    {
+    public:
+
+      // below this size, a range is not split any further
+      const static inline std::size_t MIN_CHUNK_SIZE = 1<<16;
+
+      static std::size_t number_of_threads(std::size_t num_threads);
+
+      template<typename func_type>
+      static void for_each(std::size_t num_items, std::size_t num_threads, func_type func);
+
+      static std::vector<std::size_t> split(std::size_t len, std::size_t num_threads);
+
+      template<typename itr_type, typename comp_type>
+      static void sort(itr_type beg, itr_type end, comp_type comp, std::size_t num_threads);
+    };
+
+    std::size_t glm_parallel::number_of_threads(std::size_t num_threads)
+    {
+      if(num_threads>0)
+        {
+          return num_threads;
+        }
+
+      return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    template<typename func_type>
+    void glm_parallel::for_each(std::size_t num_items, std::size_t num_threads, func_type func)
+    {
+      std::atomic<std::size_t> next=0;
+
+      auto task = [&next, &func, num_items]()
+      {
+        for(std::size_t ind=next++; ind<num_items; ind=next++)
+          {
+            func(ind);
+          }
+      };
+
+      std::size_t num_workers = std::min(number_of_threads(num_threads), num_items);
+
+      std::vector<std::future<void> > workers={};
+      for(std::size_t l=1; l<num_workers; l++)
+        {
+          workers.push_back(std::async(std::launch::async, task));
+        }
+
+      task();
+
+      for(auto& worker:workers)
+        {
+          worker.get();
+        }
+    }
+
+    std::vector<std::size_t> glm_parallel::split(std::size_t len, std::size_t num_threads)
+    {
+      std::size_t num_chunks = std::min(number_of_threads(num_threads), len/MIN_CHUNK_SIZE+1);
+
+      std::vector<std::size_t> bounds={};
+      for(std::size_t l=0; l<num_chunks; l++)
+        {
+          bounds.push_back((l*len)/num_chunks);
+        }
+      bounds.push_back(len);
+
+      return bounds;
+    }
+
+    /*
+     * Sorts the chunks in parallel, followed by rounds of pairwise merges.
+     * As with `std::sort`, the order of equivalent elements is unspecified.
+     */
+    template<typename itr_type, typename comp_type>
+    void glm_parallel::sort(itr_type beg, itr_type end, comp_type comp, std::size_t num_threads)
+    {
+      std::size_t len = end-beg;
+      std::vector<std::size_t> bounds = split(len, num_threads);
+
+      if(bounds.size()<=2)
+        {
+          std::sort(beg, end, comp);
+          return;
+        }
+
+      for_each(bounds.size()-1, num_threads, [&](std::size_t l)
+      {
+        std::sort(beg+bounds[l], beg+bounds[l+1], comp);
+      });
+
+      while(bounds.size()>2)
+        {
+          for_each((bounds.size()-1)/2, num_threads, [&](std::size_t l)
+          {
+            std::inplace_merge(beg+bounds[2*l], beg+bounds[2*l+1], beg+bounds[2*l+2], comp);
+          });
+
+          std::vector<std::size_t> merged={};
+          for(std::size_t l=0; l<bounds.size(); l+=2)
+            {
+              merged.push_back(bounds[l]);
+            }
+
+          if(merged.back()!=len)
+            {
+              merged.push_back(len);
+            }
+
+          bounds.swap(merged);
+        }
+    }
+
+  }
+
+}
+
+#endif
@@ -0,0 +1,379 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_TERM_INDEX_H_
+#define ANDROMEDA_MODELS_GLM_TERM_INDEX_H_
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Optional lookup index over the texts of the TOKEN and TERM nodes, for
+     * prefix, case-folded and fuzzy (bounded Levenshtein) selection. The
+     * texts are kept sorted in a single character pool, once as-is and once
+     * case-folded. A prefix is a binary search, while a fuzzy lookup walks
+     * the sorted texts as an implicit trie and prunes the branches whose
+     * edit distance already exceeds the bound. Like `glm_text_index`, it is
+     * built after the model is loaded and is read-only afterwards.
+     */
+    class glm_term_index: public base_types
+    {
+    public:
+
+      typedef glm_nodes nodes_type;
+      typedef typename nodes_type::node_type node_type;
+
+      // node-hash and edit distance
+      typedef std::pair<hash_type, std::size_t> match_type;
+
+    private:
+
+      // sorted texts in a single pool, the text of item l is chars[offsets[l], offsets[l+1])
+      class column_type
+      {
+      public:
+
+        void clear();
+
+        std::size_t size() const { return hashes.size(); }
+        std::size_t memory_size() const;
+
+        std::string_view text(std::size_t ind) const;
+        hash_type hash(std::size_t ind) const { return hashes[ind]; }
+
+        void assign(std::vector<std::pair<std::string, hash_type> >& items, std::size_t num_threads);
+
+        // the range of the texts that start with `prefix`
+        std::pair<std::size_t, std::size_t> find_prefix(std::string_view prefix) const;
+
+      private:
+
+        std::vector<char> chars;
+        std::vector<uint64_t> offsets;
+        std::vector<hash_type> hashes;
+      };
+
+    public:
+
+      glm_term_index();
+
+      void clear();
+
+      bool is_built() const { return built; }
+
+      // the index is stale if nodes were added after it was built
+      bool is_valid(const nodes_type& nodes) const { return (built and nodes.size()==num_nodes); }
+
+      std::size_t memory_size() const { return (exact.memory_size()+folded.memory_size()); }
+
+      void build(const nodes_type& nodes, std::size_t num_threads);
+
+      std::size_t find_prefix(const std::string& prefix, bool caseless, std::size_t max_results,
+                              std::vector<match_type>& matches) const;
+
+      std::size_t find_caseless(const std::string& word, std::size_t max_results,
+                                std::vector<match_type>& matches) const;
+
+      std::size_t find_fuzzy(const std::string& word, bool caseless, std::size_t max_dist,
+                             std::size_t max_results, std::vector<match_type>& matches) const;
+
+    private:
+
+      static bool is_indexed(flvr_type flvr);
+
+      void find_fuzzy(const column_type& coll, const std::string& word, std::size_t max_dist,
+                      std::size_t beg, std::size_t end, std::size_t depth,
+                      const std::vector<std::size_t>& row, std::vector<match_type>& matches) const;
+
+    private:
+
+      bool built;
+      std::size_t num_nodes;
+
+      column_type exact, folded;
+    };
+
+    void glm_term_index::column_type::clear()
+    {
+      chars.clear();
+      offsets.clear();
+      hashes.clear();
+    }
+
+    std::size_t glm_term_index::column_type::memory_size() const
+    {
+      return (chars.size()*sizeof(char) +
+              offsets.size()*sizeof(uint64_t) +
+              hashes.size()*sizeof(hash_type));
+    }
+
+    std::string_view glm_term_index::column_type::text(std::size_t ind) const
+    {
+      return std::string_view(chars.data()+offsets[ind], offsets[ind+1]-offsets[ind]);
+    }
+
+    void glm_term_index::column_type::assign(std::vector<std::pair<std::string, hash_type> >& items,
+                                              std::size_t num_threads)
+    {
+      clear();
+
+      glm_parallel::sort(items.begin(), items.end(), std::less<std::pair<std::string, hash_type> >(),
+                         num_threads);
+
+      std::size_t num_chars=0;
+      for(auto& item:items)
+        {
+          num_chars += item.first.size();
+        }
+
+      chars.reserve(num_chars);
+      offsets.reserve(items.size()+1);
+      hashes.reserve(items.size());
+
+      for(auto& item:items)
+        {
+          offsets.push_back(chars.size());
+          chars.insert(chars.end(), item.first.begin(), item.first.end());
+
+          hashes.push_back(item.second);
+        }
+      offsets.push_back(chars.size());
+    }
+
+    std::pair<std::size_t, std::size_t> glm_term_index::column_type::find_prefix(std::string_view prefix) const
+    {
+      std::size_t beg=0, end=size();
+
+      // first text that is not smaller than the prefix
+      while(beg<end)
+        {
+          std::size_t mid = beg+(end-beg)/2;
+
+          if(text(mid)<prefix) { beg = mid+1; }
+          else { end = mid; }
+        }
+
+      // the texts with the prefix follow contiguously
+      std::size_t lhs=beg;
+      end=size();
+
+      while(beg<end)
+        {
+          std::size_t mid = beg+(end-beg)/2;
+
+          if(text(mid).substr(0, prefix.size())==prefix) { beg = mid+1; }
+          else { end = mid; }
+        }
+
+      return std::pair<std::size_t, std::size_t>(lhs, beg);
+    }
+
+    glm_term_index::glm_term_index():
+      built(false),
+      num_nodes(0),
+
+      exact(),
+      folded()
+    {}
+
+    void glm_term_index::clear()
+    {
+      built = false;
+      num_nodes = 0;
+
+      exact.clear();
+      folded.clear();
+    }
+
+    bool glm_term_index::is_indexed(flvr_type flvr)
+    {
+      return (flvr==node_names::WORD_TOKEN or flvr==node_names::TERM);
+    }
+
+    void glm_term_index::build(const nodes_type& nodes, std::size_t num_threads)
+    {
+      LOG_S(INFO) << __FUNCTION__;
+
+      clear();
+
+      typedef std::pair<std::string, hash_type> item_type;
+
+      std::vector<std::pair<typename nodes_type::key_type, std::size_t> > chunks={};
+      for(auto& item:nodes.get_sizes())
+        {
+          if(not is_indexed(item.first))
+            {
+              continue;
+            }
+
+          std::vector<std::size_t> bounds = glm_parallel::split(item.second, num_threads);
+
+          for(std::size_t l=0; l+1<bounds.size(); l++)
+            {
+              chunks.emplace_back(typename nodes_type::key_type(item.first, bounds[l]), bounds[l+1]);
+            }
+        }
+
+      std::vector<std::vector<item_type> > items(chunks.size());
+
+      glm_parallel::for_each(chunks.size(), num_threads, [&](std::size_t l)
+      {
+        auto& key = chunks[l].first;
+
+        node_type node;
+        for(ind_type ind=key.second; ind<chunks[l].second; ind++)
+          {
+            if(nodes.view(typename nodes_type::key_type(key.first, ind), node))
+              {
+                items[l].emplace_back(node.get_text(nodes, false), node.get_hash());
+              }
+          }
+      });
+
+      std::vector<item_type> all={};
+      for(auto& chunk:items)
+        {
+          all.insert(all.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+          std::vector<item_type>().swap(chunk);
+        }
+
+      exact.assign(all, num_threads);
+
+      glm_parallel::for_each(all.size(), num_threads, [&](std::size_t l)
+      {
+        all[l].first = utils::to_lower(all[l].first);
+      });
+
+      folded.assign(all, num_threads);
+
+      num_nodes = nodes.size();
+      built = true;
+
+      LOG_S(INFO) << "indexed terms: " << exact.size() << " (" << memory_size()/1.e6 << " MB)";
+    }
+
+    std::size_t glm_term_index::find_prefix(const std::string& prefix, bool caseless,
+                                            std::size_t max_results,
+                                            std::vector<match_type>& matches) const
+    {
+      const column_type& coll = (caseless? folded:exact);
+      auto range = coll.find_prefix(caseless? utils::to_lower(prefix):prefix);
+
+      for(std::size_t ind=range.first; ind<range.second and matches.size()<max_results; ind++)
+        {
+          matches.emplace_back(coll.hash(ind), 0);
+        }
+
+      return matches.size();
+    }
+
+    std::size_t glm_term_index::find_caseless(const std::string& word, std::size_t max_results,
+                                              std::vector<match_type>& matches) const
+    {
+      std::string key = utils::to_lower(word);
+      auto range = folded.find_prefix(key);
+
+      for(std::size_t ind=range.first; ind<range.second and matches.size()<max_results; ind++)
+        {
+          if(folded.text(ind).size()==key.size())
+            {
+              matches.emplace_back(folded.hash(ind), 0);
+            }
+        }
+
+      return matches.size();
+    }
+
+    /*
+     * The closest matches come first. All matches within `max_dist` are
+     * collected before they are truncated to `max_results`.
+     */
+    std::size_t glm_term_index::find_fuzzy(const std::string& word, bool caseless, std::size_t max_dist,
+                                           std::size_t max_results, std::vector<match_type>& matches) const
+    {
+      const column_type& coll = (caseless? folded:exact);
+      std::string key = (caseless? utils::to_lower(word):word);
+
+      std::vector<std::size_t> row(key.size()+1, 0);
+      for(std::size_t j=0; j<row.size(); j++)
+        {
+          row[j] = j;
+        }
+
+      std::vector<match_type> found={};
+      find_fuzzy(coll, key, max_dist, 0, coll.size(), 0, row, found);
+
+      std::stable_sort(found.begin(), found.end(), [](const match_type& lhs, const match_type& rhs)
+      {
+        return (lhs.second<rhs.second);
+      });
+
+      for(std::size_t l=0; l<found.size() and matches.size()<max_results; l++)
+        {
+          matches.push_back(found[l]);
+        }
+
+      return matches.size();
+    }
+
+    /*
+     * The texts in [beg, end) share their first `depth` bytes, and `row` is
+     * the Levenshtein row of that common prefix against `word`. The texts
+     * that end at `depth` come first, the others are split by their next
+     * byte into the children of the trie-node.
+     */
+    void glm_term_index::find_fuzzy(const column_type& coll, const std::string& word, std::size_t max_dist,
+                                    std::size_t beg, std::size_t end, std::size_t depth,
+                                    const std::vector<std::size_t>& row,
+                                    std::vector<match_type>& matches) const
+    {
+      while(beg<end and coll.text(beg).size()==depth)
+        {
+          if(row.back()<=max_dist)
+            {
+              matches.emplace_back(coll.hash(beg), row.back());
+            }
+
+          beg += 1;
+        }
+
+      std::vector<std::size_t> next(row.size(), 0);
+      while(beg<end)
+        {
+          uint8_t c = coll.text(beg)[depth];
+
+          // end of the child with byte `c`
+          std::size_t lhs=beg, rhs=end;
+          while(lhs<rhs)
+            {
+              std::size_t mid = lhs+(rhs-lhs)/2;
+
+              if(uint8_t(coll.text(mid)[depth])<=c) { lhs = mid+1; }
+              else { rhs = mid; }
+            }
+
+          next[0] = row[0]+1;
+
+          std::size_t min_dist=next[0];
+          for(std::size_t j=1; j<row.size(); j++)
+            {
+              std::size_t cost = (uint8_t(word[j-1])==c? 0:1);
+
+              next[j] = std::min({row[j]+1, next[j-1]+1, row[j-1]+cost});
+              min_dist = std::min(min_dist, next[j]);
+            }
+
+          if(min_dist<=max_dist)
+            {
+              find_fuzzy(coll, word, max_dist, beg, lhs, depth+1, next, matches);
+            }
+
+          beg = lhs;
+        }
+    }
+
+  }
+
+}
+
+#endif
@@ -0,0 +1,502 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_TEXT_INDEX_H_
+#define ANDROMEDA_MODELS_GLM_TEXT_INDEX_H_
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Optional inverted index from the trigrams (3 consecutive bytes) of
+     * the node texts to the hashes of the nodes that contain them. The
+     * index is not saved with the model, it is built after the model is
+     * loaded. A regex is pre-filtered with the trigrams of the literals it
+     * requires (see `get_trigrams`): only the nodes that contain all of them
+     * can match, and PCRE2 is only run on those. The index is read-only
+     * once built, so it can be queried concurrently.
+     */
+    class glm_text_index: public base_types
+    {
+    public:
+
+      typedef uint32_t trigram_type;
+
+      typedef glm_nodes nodes_type;
+      typedef typename nodes_type::node_type node_type;
+
+    public:
+
+      glm_text_index();
+
+      void clear();
+
+      bool is_built() const { return built; }
+
+      // the index is stale if nodes were added after it was built
+      bool is_valid(const nodes_type& nodes) const { return (built and nodes.size()==num_nodes); }
+
+      std::size_t memory_size() const;
+
+      void build(const nodes_type& nodes, std::size_t num_threads);
+
+      // the sorted hashes of the nodes that contain all `trigrams`
+      void find(const std::vector<trigram_type>& trigrams, std::vector<hash_type>& hashes) const;
+
+      // the trigrams of the literals that any match of `regex` must contain
+      static bool get_trigrams(const std::string& regex, std::vector<trigram_type>& trigrams);
+
+    private:
+
+      static void add_trigrams(const std::string& text, std::vector<trigram_type>& trigrams);
+
+      static bool skip_class(const std::string& regex, std::size_t& ind);
+      static bool skip_group(const std::string& regex, std::size_t& ind);
+
+    private:
+
+      bool built;
+      std::size_t num_nodes;
+
+      // posting lists in CSR layout: the nodes with keys[l] are hashes[offsets[l], offsets[l+1])
+      std::vector<trigram_type> keys;
+      std::vector<uint64_t> offsets;
+      std::vector<hash_type> hashes;
+    };
+
+    glm_text_index::glm_text_index():
+      built(false),
+      num_nodes(0),
+
+      keys({}),
+      offsets({}),
+      hashes({})
+    {}
+
+    void glm_text_index::clear()
+    {
+      built = false;
+      num_nodes = 0;
+
+      keys.clear();
+      offsets.clear();
+      hashes.clear();
+    }
+
+    std::size_t glm_text_index::memory_size() const
+    {
+      return (keys.size()*sizeof(trigram_type) +
+              offsets.size()*sizeof(uint64_t) +
+              hashes.size()*sizeof(hash_type));
+    }
+
+    /*
+     * The (trigram, hash) pairs are collected concurrently in chunks of the
+     * flavors, sorted and compacted into the posting lists.
+     */
+    void glm_text_index::build(const nodes_type& nodes, std::size_t num_threads)
+    {
+      LOG_S(INFO) << __FUNCTION__;
+
+      clear();
+
+      typedef std::pair<trigram_type, hash_type> item_type;
+
+      std::vector<std::pair<typename nodes_type::key_type, std::size_t> > chunks={};
+      for(auto& item:nodes.get_sizes())
+        {
+          std::vector<std::size_t> bounds = glm_parallel::split(item.second, num_threads);
+
+          for(std::size_t l=0; l+1<bounds.size(); l++)
+            {
+              chunks.emplace_back(typename nodes_type::key_type(item.first, bounds[l]), bounds[l+1]);
+            }
+        }
+
+      std::vector<std::vector<item_type> > items(chunks.size());
+
+      glm_parallel::for_each(chunks.size(), num_threads, [&](std::size_t l)
+      {
+        auto& key = chunks[l].first;
+
+        node_type node;
+        std::vector<trigram_type> trigrams={};
+
+        for(ind_type ind=key.second; ind<chunks[l].second; ind++)
+          {
+            if(not nodes.view(typename nodes_type::key_type(key.first, ind), node))
+              {
+                continue;
+              }
+
+            std::string text = node.get_text(nodes, false);
+
+            trigrams.clear();
+            add_trigrams(text, trigrams);
+
+            std::sort(trigrams.begin(), trigrams.end());
+            trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+            for(auto trigram:trigrams)
+              {
+                items[l].emplace_back(trigram, node.get_hash());
+              }
+          }
+      });
+
+      std::vector<item_type> all={};
+      for(auto& chunk:items)
+        {
+          all.insert(all.end(), chunk.begin(), chunk.end());
+          std::vector<item_type>().swap(chunk);
+        }
+
+      glm_parallel::sort(all.begin(), all.end(), std::less<item_type>(), num_threads);
+
+      hashes.reserve(all.size());
+      for(auto& item:all)
+        {
+          if(keys.size()==0 or keys.back()!=item.first)
+            {
+              keys.push_back(item.first);
+              offsets.push_back(hashes.size());
+            }
+
+          hashes.push_back(item.second);
+        }
+      offsets.push_back(hashes.size());
+
+      num_nodes = nodes.size();
+      built = true;
+
+      LOG_S(INFO) << "indexed node-texts: " << keys.size() << " trigrams, "
+                  << hashes.size() << " postings (" << memory_size()/1.e6 << " MB)";
+    }
+
+    /*
+     * Intersects the posting lists, starting with the shortest one.
+     */
+    void glm_text_index::find(const std::vector<trigram_type>& trigrams,
+                              std::vector<hash_type>& result) const
+    {
+      result.clear();
+
+      std::vector<std::pair<std::size_t, std::size_t> > ranges={};
+      for(auto trigram:trigrams)
+        {
+          auto itr = std::lower_bound(keys.begin(), keys.end(), trigram);
+
+          if(itr==keys.end() or *itr!=trigram)
+            {
+              return;
+            }
+
+          std::size_t ind = itr-keys.begin();
+          ranges.emplace_back(offsets[ind], offsets[ind+1]);
+        }
+
+      if(ranges.size()==0)
+        {
+          return;
+        }
+
+      std::sort(ranges.begin(), ranges.end(), [](const std::pair<std::size_t, std::size_t>& lhs,
+                                                 const std::pair<std::size_t, std::size_t>& rhs)
+      {
+        return ((lhs.second-lhs.first)<(rhs.second-rhs.first));
+      });
+
+      result.assign(hashes.begin()+ranges[0].first, hashes.begin()+ranges[0].second);
+
+      std::vector<hash_type> tmp={};
+      for(std::size_t l=1; l<ranges.size() and result.size()>0; l++)
+        {
+          tmp.clear();
+          std::set_intersection(result.begin(), result.end(),
+                                hashes.begin()+ranges[l].first, hashes.begin()+ranges[l].second,
+                                std::back_inserter(tmp));
+          result.swap(tmp);
+        }
+    }
+
+    void glm_text_index::add_trigrams(const std::string& text, std::vector<trigram_type>& trigrams)
+    {
+      for(std::size_t ind=0; ind+3<=text.size(); ind++)
+        {
+          trigrams.push_back((trigram_type(uint8_t(text[ind  ]))<<16) |
+                             (trigram_type(uint8_t(text[ind+1]))<< 8) |
+                             (trigram_type(uint8_t(text[ind+2]))    ));
+        }
+    }
+
+    /*
+     * Conservative scan of the pattern (compiled without options, so byte
+     * semantics) for runs of literal bytes that every match contains.
+     * Classes, groups, escapes and optional bytes end a run. Patterns with
+     * a top-level alternation, inline options or verbs yield no trigrams,
+     * in which case the pattern can not be pre-filtered.
+     */
+    bool glm_text_index::get_trigrams(const std::string& regex, std::vector<trigram_type>& trigrams)
+    {
+      trigrams.clear();
+
+      // escapes that match a class or position, and do not consume the next bytes
+      const static std::string simple_escapes = "sSdDwWbBAZzGhHvVRXKntrfea";
+
+      std::vector<std::string> literals={};
+
+      std::string run="";
+      bool last_literal=false;
+
+      auto flush = [&]()
+      {
+        if(run.size()>=3)
+          {
+            literals.push_back(run);
+          }
+
+        run.clear();
+        last_literal=false;
+      };
+
+      std::size_t ind=0;
+      while(ind<regex.size())
+        {
+          char c = regex[ind];
+
+          switch(c)
+            {
+            case '\\':
+              {
+                if(ind+1>=regex.size())
+                  {
+                    return false;
+                  }
+
+                char next = regex[ind+1];
+                if(std::isalnum(uint8_t(next)))
+                  {
+                    if(simple_escapes.find(next)==std::string::npos)
+                      {
+                        return false;
+                      }
+
+                    flush();
+                  }
+                else
+                  {
+                    run.push_back(next);
+                    last_literal=true;
+                  }
+
+                ind += 2;
+              }
+              break;
+
+            case '[':
+              {
+                flush();
+
+                if(not skip_class(regex, ind))
+                  {
+                    return false;
+                  }
+              }
+              break;
+
+            case '(':
+              {
+                flush();
+
+                if(not skip_group(regex, ind))
+                  {
+                    return false;
+                  }
+              }
+              break;
+
+            case ')':
+            case '|':
+              {
+                return false;
+              }
+              break;
+
+            case '*':
+            case '?':
+            case '+':
+            case '{':
+              {
+                std::size_t min_rep=(c=='+'? 1:0);
+                ind += 1;
+
+                if(c=='{')
+                  {
+                    std::size_t end = regex.find('}', ind);
+                    if(end==std::string::npos)
+                      {
+                        return false;
+                      }
+
+                    std::string quant = regex.substr(ind, end-ind);
+                    if(quant.size()==0 or quant.find_first_not_of("0123456789,")!=std::string::npos)
+                      {
+                        return false;
+                      }
+
+                    min_rep = std::atoi(quant.c_str());
+                    ind = end+1;
+                  }
+
+                // lazy or possessive quantifier
+                if(ind<regex.size() and (regex[ind]=='?' or regex[ind]=='+'))
+                  {
+                    ind += 1;
+                  }
+
+                if(last_literal and min_rep==0)
+                  {
+                    run.pop_back();
+                  }
+
+                flush();
+              }
+              break;
+
+            case '.':
+            case '^':
+            case '$':
+              {
+                flush();
+                ind += 1;
+              }
+              break;
+
+            default:
+              {
+                run.push_back(c);
+                last_literal=true;
+
+                ind += 1;
+              }
+            }
+        }
+
+      flush();
+
+      for(auto& literal:literals)
+        {
+          add_trigrams(literal, trigrams);
+        }
+
+      std::sort(trigrams.begin(), trigrams.end());
+      trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+      return (trigrams.size()>0);
+    }
+
+    // moves `ind` past the class that starts at `ind`
+    bool glm_text_index::skip_class(const std::string& regex, std::size_t& ind)
+    {
+      ind += 1;
+
+      if(ind<regex.size() and regex[ind]=='^')
+        {
+          ind += 1;
+        }
+
+      // a leading `]` is a literal
+      if(ind<regex.size() and regex[ind]==']')
+        {
+          ind += 1;
+        }
+
+      while(ind<regex.size() and regex[ind]!=']')
+        {
+          if(regex[ind]=='\\')
+            {
+              ind += 2;
+            }
+          else if(regex.compare(ind, 2, "[:")==0)
+            {
+              std::size_t end = regex.find(":]", ind+2);
+              if(end==std::string::npos)
+                {
+                  return false;
+                }
+
+              ind = end+2;
+            }
+          else
+            {
+              ind += 1;
+            }
+        }
+
+      if(ind>=regex.size())
+        {
+          return false;
+        }
+
+      ind += 1;
+      return true;
+    }
+
+    // moves `ind` past the group that starts at `ind`, inline options and verbs are rejected
+    bool glm_text_index::skip_group(const std::string& regex, std::size_t& ind)
+    {
+      if(regex.compare(ind, 2, "(*")==0)
+        {
+          return false;
+        }
+
+      if(regex.compare(ind, 2, "(?")==0 and
+         (ind+2>=regex.size() or std::string(":=!<>#|").find(regex[ind+2])==std::string::npos))
+        {
+          return false;
+        }
+
+      std::size_t depth=0;
+      while(ind<regex.size())
+        {
+          char c = regex[ind];
+
+          if(c=='\\')
+            {
+              ind += 2;
+              continue;
+            }
+          else if(c=='[')
+            {
+              if(not skip_class(regex, ind))
+                {
+                  return false;
+                }
+              continue;
+            }
+          else if(c=='(')
+            {
+              depth += 1;
+            }
+          else if(c==')')
+            {
+              depth -= 1;
+
+              if(depth==0)
+                {
+                  ind += 1;
+                  return true;
+                }
+            }
+
+          ind += 1;
+        }
+
+      return false;
+    }
+
+  }
+
+}
+
+#endif
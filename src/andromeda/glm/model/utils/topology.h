@@ -35,6 +35,12 @@ namespace andromeda
       template<typename model_type>
       void compute(model_type& model);
 
+      // incremental statistics (after `initialise`), eg while streaming a model
+      template<typename node_type>
+      cnt_type add_node(const node_type& node);
+
+      cnt_type add_edges(short flvr, const std::vector<cnt_type>& counts);
+
     private:
 
       template<typename tmp_type>
@@ -505,20 +511,7 @@ namespace andromeda
         {
           for(auto& node:flvr_coll.second)
             {
-	      cnt_type cnt = node.get_text_cnt()+node.get_tabl_cnt()+node.get_fdoc_cnt();	      
-
-              max_text_cnt = std::max(max_text_cnt, cnt);
-
-              {
-                node_counts.at(node.get_flvr()) += 1;
-              }
-
-              {
-                update_statistics(node.get_flvr(), node.get_word_cnt(), node_word_stats);
-                update_statistics(node.get_flvr(), node.get_sent_cnt(), node_sent_stats);
-                //update_statistics(node.get_flvr(), node.get_text_cnt(), node_text_stats);
-		update_statistics(node.get_flvr(), cnt, node_text_stats);
-              }
+              max_text_cnt = std::max(max_text_cnt, add_node(node));
             }
         }
 
@@ -535,27 +528,57 @@ namespace andromeda
       auto& edges = model.get_edges();
       for(auto& flvr_coll:edges)
         {
-          for(auto& edge:flvr_coll.second)
-            {
-              max_cnt = std::max(max_cnt, edge.get_count());
+          // only the count-column is scanned
+          max_cnt = std::max(max_cnt, add_edges(flvr_coll.first, (flvr_coll.second).get_count_column()));
+        }
 
-              if(edge_counts.count(edge.get_flvr())==1)
-                {
-                  edge_counts.at(edge.get_flvr()) += 1;
-                }
-              else
-                {
-                  LOG_S(WARNING) << "new edge-flavor: " << edge.get_flvr();
+      return max_cnt;
+    }
 
-                  edge_counts[edge.get_flvr()] = 1;
-                  initialise(edge.get_flvr(), edge_count_stats);
-                }
+    /* returns the text-count of the node */
+    template<typename node_type>
+    typename glm_topology::cnt_type glm_topology::add_node(const node_type& node)
+    {
+      cnt_type cnt = node.get_text_cnt()+node.get_tabl_cnt()+node.get_fdoc_cnt();
 
-              update_statistics(edge.get_flvr(), edge.get_count(), edge_count_stats);
-            }
+      {
+        node_counts.at(node.get_flvr()) += 1;
+      }
+
+      {
+        update_statistics(node.get_flvr(), node.get_word_cnt(), node_word_stats);
+        update_statistics(node.get_flvr(), node.get_sent_cnt(), node_sent_stats);
+        //update_statistics(node.get_flvr(), node.get_text_cnt(), node_text_stats);
+        update_statistics(node.get_flvr(), cnt, node_text_stats);
+      }
+
+      return cnt;
+    }
+
+    /* returns the maximum count of the edges */
+    typename glm_topology::cnt_type glm_topology::add_edges(short flvr, const std::vector<cnt_type>& counts)
+    {
+      if(counts.size()==0)
+        {
+          return 0;
         }
 
-      return max_cnt;
+      if(edge_counts.count(flvr)==0)
+        {
+          LOG_S(WARNING) << "new edge-flavor: " << flvr;
+
+          edge_counts[flvr] = 0;
+          initialise(flvr, edge_count_stats);
+        }
+
+      edge_counts.at(flvr) += counts.size();
+
+      for(cnt_type cnt:counts)
+        {
+          update_statistics(flvr, cnt, edge_count_stats);
+        }
+
+      return *std::max_element(counts.begin(), counts.end());
     }
 
     /*
@@ -13,7 +13,8 @@ namespace andromeda
        CREATE_CONFIGS,
        CREATE,
        AUGMENT, DISTILL,
-       QUERY, EXPLORE
+       QUERY, EXPLORE,
+       SERVE
       };
     
     std::string to_string(model_cli_name name)
@@ -29,6 +30,8 @@ namespace andromeda
 
 	  case QUERY: return "query";
 	  case EXPLORE: return "explore";
+
+	  case SERVE: return "serve";
 	  }
 
 	return "undefined";
@@ -60,6 +63,10 @@ namespace andromeda
 	{
 	  return EXPLORE;
 	}
+      else if(text==to_string(SERVE))
+	{
+	  return SERVE;
+	}
       else
 	{
 	  return UNDEF;
@@ -134,4 +141,6 @@ namespace andromeda
 #include <andromeda/glm/model_cli/query.h>
 #include <andromeda/glm/model_cli/explore.h>
 
+#include <andromeda/glm/model_cli/serve.h>
+
 #endif
@@ -72,14 +72,14 @@ namespace andromeda
 
               for(std::size_t i=0; i<term_hashes_i.size()-1; i++)
                 {
-                  edges.insert(edge_names::tax_dn, term_hashes_i.at(i), term_hashes_i.at(i+1), cnt, false);
-		  edges.insert(edge_names::to_root, term_hashes_i.at(i), root.get_hash(), cnt, false);
+                  edges.insert(edge_names::tax_dn, term_hashes_i[i], term_hashes_i[i+1], cnt, false);
+		  edges.insert(edge_names::to_root, term_hashes_i[i], root.get_hash(), cnt, false);
                 }
 
               for(std::size_t i=1; i<term_hashes_i.size(); i++)
                 {
-                  edges.insert(edge_names::tax_up, term_hashes_i.at(i), term_hashes_i.at(i-1), cnt, false);
-		  edges.insert(edge_names::from_root, root.get_hash(), term_hashes_i.at(i), cnt, false);
+                  edges.insert(edge_names::tax_up, term_hashes_i[i], term_hashes_i[i-1], cnt, false);
+		  edges.insert(edge_names::from_root, root.get_hash(), term_hashes_i[i], cnt, false);
                 }
 	      	      
 	      edges.insert(edge_names::from_root, root.get_hash(), term_i.get_hash(), cnt, false);	      
@@ -90,7 +90,7 @@ namespace andromeda
               std::vector<hash_type> term_hashes_j={};
               for(std::size_t j=i+1; j<term_hashes_i.size(); j++)
                 {
-                  term_hashes_j.push_back(term_hashes_i.at(j));
+                  term_hashes_j.push_back(term_hashes_i[j]);
                 }
 
               if(term_hashes_j.size()==0) // skip
@@ -8,9 +8,15 @@
 #include <mutex>
 
 #include <andromeda/glm/model_cli/create/config.h>
+#include <andromeda/glm/model_cli/create/model_shards.h>
+#include <andromeda/glm/model_cli/create/model_spiller.h>
 #include <andromeda/glm/model_cli/create/logger.h>
+#include <andromeda/glm/model_cli/create/model_admission.h>
 #include <andromeda/glm/model_cli/create/model_merger.h>
 #include <andromeda/glm/model_cli/create/model_creator.h>
+#include <andromeda/glm/model_cli/create/merge_scheduler.h>
+#include <andromeda/glm/model_cli/create/model_checkpoint.h>
+#include <andromeda/glm/model_cli/create/work_queue.h>
 
 namespace andromeda
 {
@@ -28,6 +34,16 @@ namespace andromeda
       typedef typename model_type::nodes_type nodes_type;
       typedef typename model_type::edges_type edges_type;
 
+      typedef model_shards<model_type> shards_type;
+      typedef model_spiller<model_type> spiller_type;
+      typedef model_admission<model_type> admission_type;
+      typedef merge_scheduler<model_type> scheduler_type;
+      typedef model_checkpoint<model_type> checkpoint_type;
+
+      // queue between two stages of the pipeline
+      template<typename producer_type>
+      using queue_ptr_type = std::shared_ptr<work_queue<std::shared_ptr<typename producer_type::subject_type> > >;
+
     public:
 
       model_cli(std::shared_ptr<model_type> model);
@@ -52,11 +68,33 @@ namespace andromeda
       template<typename producer_type>
       std::size_t update_task(std::size_t thread_id,
 			      std::mutex& read_mtx, std::mutex& update_mtx,			      
-			      std::size_t& line_count, std::atomic<std::size_t>& merge_count,
+			      std::size_t& line_count,
 			      nlohmann::json& config, std::shared_ptr<producer_type>& reader,
 			      std::shared_ptr<create_log> log,
-			      std::shared_ptr<model_type> loc_model,
-			      std::shared_ptr<model_type> fin_model);
+			      std::shared_ptr<scheduler_type> scheduler,
+			      std::shared_ptr<checkpoint_type> checkpoint,
+			      std::shared_ptr<model_type> fin_model,
+			      std::shared_ptr<shards_type> fin_shards,
+			      std::shared_ptr<spiller_type> spiller,
+			      std::shared_ptr<admission_type> admission,
+			      queue_ptr_type<producer_type> annotated);
+
+      template<typename producer_type>
+      void read_task(std::size_t thread_id, std::mutex& read_mtx, std::size_t& line_count,
+		     std::atomic<std::size_t>& num_active,
+		     std::shared_ptr<producer_type>& reader,
+		     queue_ptr_type<producer_type> parsed);
+
+      template<typename producer_type>
+      void nlp_task(std::size_t thread_id, nlohmann::json& config,
+		    std::atomic<std::size_t>& num_active,
+		    queue_ptr_type<producer_type> parsed,
+		    queue_ptr_type<producer_type> annotated);
+
+      template<typename producer_type>
+      void set_nlp_output(std::size_t thread_id, producer_type& nlp);
+
+      std::size_t get_number_of_shards();
       
     private:
 
@@ -168,6 +206,19 @@ namespace andromeda
       augmenter.augment();
     }
 
+    template<typename model_type>
+    std::size_t model_cli<CREATE, model_type>::get_number_of_shards()
+    {
+      if(configuration.num_shards>0)
+	{
+	  return std::bit_ceil(configuration.num_shards);
+	}
+
+      // twice the number of threads keeps collisions between concurrent
+      // merges rare, while the gather at the end stays cheap
+      return std::min(std::size_t(64), std::bit_ceil(2*configuration.num_threads));
+    }
+
     template<typename model_type>
     template<typename producer_type>
     void model_cli<CREATE, model_type>::update_mt(std::shared_ptr<producer_type>& producer)
@@ -179,19 +230,9 @@ namespace andromeda
 	reader->reset_pointer();
       }
 
-      std::vector<std::shared_ptr<model_type> > models;
-      {
-	for(std::size_t id=0; id<configuration.num_threads; id++)
-	  {
-	    auto model_ptr = std::make_shared<model_type>();
-	    models.push_back(model_ptr);
-	  }
-      }
-
       std::mutex read_mtx, update_mtx;
 
       std::size_t line_count=0;
-      std::atomic<std::size_t> merge_count=0;
       
       nlohmann::json config = (model_ptr->get_parameters()).to_json();
       std::vector<std::future<std::size_t> > results(configuration.num_threads);
@@ -204,18 +245,125 @@ namespace andromeda
       auto& edges = model_ptr->get_edges();
       
       edges.show_bucket_distribution();
+
+      std::shared_ptr<spiller_type> spiller = NULL;
+      if(configuration.spill_runs)
+	{
+	  LOG_S(INFO) << "spilling edges to " << configuration.spill_dir << " ...";
+	  spiller = std::make_shared<spiller_type>(configuration.spill_dir);
+	}
+
+      std::shared_ptr<admission_type> admission = NULL;
+      if(configuration.heavy_hitters)
+	{
+	  if(spiller!=NULL)
+	    {
+	      LOG_S(WARNING) << "spilled edges bypass the heavy-hitter admission";
+	    }
+
+	  admission = std::make_shared<admission_type>(configuration.heavy_hitter_min_count,
+						       configuration.heavy_hitter_epsilon,
+						       configuration.heavy_hitter_delta);
+	}
+
+      std::shared_ptr<checkpoint_type> checkpoint = NULL;
+      if(configuration.checkpoint_interval>0 or configuration.resume)
+	{
+	  if(configuration.pipeline or spiller!=NULL)
+	    {
+	      LOG_S(WARNING) << "checkpoints are not supported with the pipeline or spill-runs";
+	    }
+	  else
+	    {
+	      LOG_S(INFO) << "checkpointing to " << configuration.checkpoint_dir
+			  << " (every " << configuration.checkpoint_interval << " documents) ...";
+	      
+	      checkpoint = std::make_shared<checkpoint_type>(configuration.checkpoint_dir,
+							     configuration.checkpoint_interval,
+							     config, reader, line_count);
+	    }
+	}
+
+      if(checkpoint!=NULL and configuration.resume)
+	{
+	  model_merger<model_type> merger(model_ptr, configuration.enforce_max_size);
+	  merger.set_admission(admission);
+
+	  checkpoint->resume([&merger](std::shared_ptr<model_type> segment) { merger.merge(segment); });
+	}
+
+      if(checkpoint!=NULL)
+	{
+	  checkpoint->start(configuration.num_threads);
+	}
+
+      typedef typename producer_type::subject_type subject_type;
+      typedef work_queue<std::shared_ptr<subject_type> > queue_type;
+
+      // pipelined: reader- and NLP-stages feed the update-tasks through bounded queues
+      std::shared_ptr<queue_type> parsed=NULL, annotated=NULL;
+
+      std::atomic<std::size_t> active_readers=0, active_nlp_workers=0;
+      std::vector<std::future<void> > stages={};
+
+      nlohmann::json loc_config = config;
+      if(configuration.pipeline)
+	{
+	  std::size_t num_readers = std::max(std::size_t(1), configuration.num_reader_threads);
+	  std::size_t num_nlp_workers = (configuration.num_nlp_threads>0? configuration.num_nlp_threads: configuration.num_threads);
+
+	  LOG_S(INFO) << "launching pipeline (#-readers: " << num_readers << ", "
+		      << "#-nlp-workers: " << num_nlp_workers << ", "
+		      << "#-update-workers: " << configuration.num_threads << ") ...";
+
+	  parsed = std::make_shared<queue_type>("parsed", configuration.queue_size);
+	  annotated = std::make_shared<queue_type>("annotated", configuration.queue_size);
+
+	  // the NLP is done upstream, so the update-tasks do not load the NLP-models
+	  loc_config.erase(glm_parameters::nlp_models_lbl);
+
+	  active_readers = num_readers;
+	  for(std::size_t id=0; id<num_readers; id++)
+	    {
+	      stages.push_back(std::async(std::launch::async,
+					  &model_cli<CREATE, model_type>::read_task<producer_type>,
+					  this, id, std::ref(read_mtx), std::ref(line_count),
+					  std::ref(active_readers), std::ref(reader), parsed));
+	    }
+
+	  active_nlp_workers = num_nlp_workers;
+	  for(std::size_t id=0; id<num_nlp_workers; id++)
+	    {
+	      stages.push_back(std::async(std::launch::async,
+					  &model_cli<CREATE, model_type>::nlp_task<producer_type>,
+					  this, id, std::ref(config),
+					  std::ref(active_nlp_workers), parsed, annotated));
+	    }
+	}
       
-      if(configuration.num_threads==1)
+      std::size_t max_pending = (configuration.max_pending_merges>0? configuration.max_pending_merges: configuration.num_threads);
+      std::shared_ptr<scheduler_type> scheduler = std::make_shared<scheduler_type>(config, configuration.num_threads, max_pending,
+										    configuration.max_local_edges);
+
+      if(configuration.num_threads==1 and annotated==NULL)
 	{
 	  LOG_S(INFO) << "launching single threaded mode ...";
 	  
 	  update_task(0, read_mtx, update_mtx,
-		      line_count, merge_count,
-		      config, reader, log,
-		      models.at(0), model_ptr);
+		      line_count, config, reader, log,
+		      scheduler, checkpoint, model_ptr, NULL, spiller, admission, NULL);
 	}
       else
 	{
+	  std::shared_ptr<shards_type> shards = NULL;
+	  if(get_number_of_shards()>1)
+	    {
+	      LOG_S(INFO) << "sharding final glm (#-shards: " << get_number_of_shards() << ") ...";
+
+	      shards = std::make_shared<shards_type>(get_number_of_shards());
+	      shards->initialise(config, configuration.max_total_nodes, configuration.max_total_edges);
+	    }
+
 	  LOG_S(INFO) << "launching " << results.size() << " threads ...";	    
 	  for(std::size_t id=0; id<results.size(); id++)
 	    {
@@ -223,9 +371,9 @@ namespace andromeda
 					  &model_cli<CREATE, model_type>::update_task<producer_type>,
 					  this, id,
 					  std::ref(read_mtx), std::ref(update_mtx),
-					  std::ref(line_count), std::ref(merge_count), 
-					  std::ref(config), std::ref(reader),
-					  log, models.at(id), model_ptr);
+					  std::ref(line_count),
+					  std::ref(loc_config), std::ref(reader),
+					  log, scheduler, checkpoint, model_ptr, shards, spiller, admission, annotated);
 	      
 	      if(not results.at(id).valid())
 		{
@@ -251,8 +399,54 @@ namespace andromeda
 			       << e.what();
 		}
 	    }
+
+	  if(annotated!=NULL)
+	    {
+	      // the stages close their queues when done, unless the update-tasks stopped early
+	      parsed->close();
+	      annotated->close();
+
+	      for(auto& stage:stages)
+		{
+		  try
+		    {
+		      stage.get();
+		    }
+		  catch(const std::exception& e)
+		    {
+		      LOG_S(ERROR) << "error from pipeline stage: " << e.what();
+		    }
+		}
+
+	      parsed->log_statistics();
+	      annotated->log_statistics();
+	    }
+
+	  if(shards!=NULL)
+	    {
+	      shards->gather(model_ptr);
+
+	      // the shards could not check the nodes of the edges they admitted
+	      if(admission!=NULL)
+		{
+		  admission->prune(*model_ptr, configuration.num_threads);
+		}
+	    }
+	}
+
+      if(spiller!=NULL)
+	{
+	  LOG_S(INFO) << "merging " << spiller->number_of_runs() << " spill-runs ...";
+	  spiller->gather(model_ptr);
 	}
 
+      if(admission!=NULL)
+	{
+	  admission->log_statistics();
+	}
+
+      scheduler->log_statistics();
+
       log->save();
       
       LOG_S(INFO) << "total text read: " << total_text_read;
@@ -271,75 +465,159 @@ namespace andromeda
 							   std::mutex& read_mtx,
 							   std::mutex& update_mtx,
 							   std::size_t& tot_line_count,
-							   std::atomic<std::size_t>& merge_count,
 							   nlohmann::json& config,
 							   std::shared_ptr<producer_type>& reader,
 							   std::shared_ptr<create_log> log,
-							   std::shared_ptr<model_type> loc_model,
-							   std::shared_ptr<model_type> fin_model)
+							   std::shared_ptr<scheduler_type> scheduler,
+							   std::shared_ptr<checkpoint_type> checkpoint,
+							   std::shared_ptr<model_type> fin_model,
+							   std::shared_ptr<shards_type> fin_shards,
+							   std::shared_ptr<spiller_type> spiller,
+							   std::shared_ptr<admission_type> admission,
+							   queue_ptr_type<producer_type> annotated)
     {
       std::size_t loc_line_count=0, curr_line_count=0;
 
       typedef typename producer_type::subject_type subject_type;
-      subject_type subj;
+      std::shared_ptr<subject_type> subj = std::make_shared<subject_type>();
+
+      typedef typename scheduler_type::job_type job_type;
       
-      // initialise local models
+      std::shared_ptr<model_merger<model_type> > merger = NULL;
+      if(fin_shards==NULL)
+	{
+	  merger = std::make_shared<model_merger<model_type> >(fin_model, configuration.enforce_max_size);
+	}
+      else
+	{
+	  merger = std::make_shared<model_merger<model_type> >(fin_shards, configuration.enforce_max_size,
+								thread_id*fin_shards->size()/configuration.num_threads);
+	}
+      merger->set_admission(admission);
+
+      // time spent waiting for the final model or a free local model
+      double wait_time=0.0;
+
+      // merges the pending local models into the final model. Unless
+      // `blocking`, we stop when the final model is busy (after combining
+      // the pending models pairwise, if possible) and go back to reading
+      auto merge_pending = [&](bool blocking)
       {
-	loc_model->configure(config, false);
-	
-	loc_model->initialise((1.1*configuration.max_local_nodes),
-			      (1.1*configuration.max_local_edges));
-      }
-      
-      model_merger<model_type> merger(fin_model, configuration.enforce_max_size);
+	job_type job;
+	while(scheduler->pop(job))
+	  {
+	    // spilling the edges only touches the local model and its own run-files
+	    double spill_time = (spiller==NULL? 0.0: spiller->spill(job.model));
+
+	    if(fin_shards==NULL)
+	      {
+		std::unique_lock<std::mutex> lock(update_mtx, std::defer_lock);
+
+		if(not lock.try_lock())
+		  {
+		    if(not blocking)
+		      {
+			if(scheduler->combine(job))
+			  {
+			    continue;
+			  }
+
+			break;
+		      }
+
+		    auto start = std::chrono::system_clock::now();
+		    lock.lock();
+
+		    std::chrono::duration<double, std::milli> delta = std::chrono::system_clock::now()-start;
+		    wait_time += delta.count();
+		  }
+
+		double merge_time = spill_time + merger->merge(job.model);
+
+		log->log(thread_id, tot_line_count, job.num_lines, merge_time, wait_time, fin_model);
+	      }
+	    else
+	      {
+		// the shards have their own locks, `update_mtx` only guards the log
+		double merge_time = spill_time + merger->merge(job.model);
+
+		std::scoped_lock lock(update_mtx);
+		log->log(thread_id, tot_line_count, job.num_lines, merge_time, wait_time, fin_shards);
+	      }
+
+	    wait_time = 0.0;
+
+	    if(checkpoint!=NULL)
+	      {
+		checkpoint->record(job.model);
+	      }
+
+	    scheduler->release(job.model);
+	  }
+      };
+
+      auto acquire = [&]()
+      {
+	std::shared_ptr<model_type> model = NULL;
+	while((model=scheduler->acquire(wait_time))==NULL)
+	  {
+	    merge_pending(true);
+	  }
+
+	return model;
+      };
+
+      std::shared_ptr<model_type> loc_model = acquire();
+
       model_creator creator(loc_model);
-      
-      auto& nlp_models = (loc_model->get_parameters()).models;
-      producer_type nlp(nlp_models);
 
-      if(configuration.write_nlp_output)
+      // every worker has its own instances of the NLP-models
+      glm_parameters parameters(config, false);
+      producer_type nlp(parameters.models);
+
+      if(configuration.write_nlp_output and annotated==NULL)
 	{
-	  if(nlp.get_subject_name()==TEXT)
-	    {
-	      std::filesystem::path file = "nlp-"+std::to_string(thread_id) + ".jsonl";	  
-	      std::filesystem::path path = configuration.nlp_output_dir / file;
-	      
-	      LOG_S(WARNING) << "writing NLP to: " << path;
-	      configuration.write_nlp_output = nlp.set_ofs(path);
-	    }
-	  else if(nlp.get_subject_name()==DOCUMENT)
-	    {
-	      std::filesystem::path odir = configuration.nlp_output_dir;
-	      
-	      LOG_S(WARNING) << "writing NLP to: " << odir;
-	      configuration.write_nlp_output = nlp.set_ofs(odir);
-	    }
-	  else
-	    {}
+	  set_nlp_output(thread_id, nlp);
 	}
       
       while(true)
 	{
 	  bool read=true;
-	  {
-	    std::scoped_lock lock(read_mtx);
-	    read = reader->read(subj, tot_line_count);
-	  }
+	  if(annotated==NULL)
+	    {
+	      {
+		std::scoped_lock lock(read_mtx);
+		read = reader->read(*subj, tot_line_count);
+
+		if(read and checkpoint!=NULL)
+		  {
+		    checkpoint->update(tot_line_count);
+		  }
+	      }
+
+	      if(read)
+		{
+		  nlp.apply(*subj);
+
+		  if(configuration.write_nlp_output)
+		    {
+		      nlp.write(*subj);
+		    }
+		}
+	    }
+	  else
+	    {
+	      // reading and NLP are done upstream in the pipeline
+	      read = annotated->pop(subj);
+	    }
 	  
 	  if(read)
 	    {
 	      loc_line_count += 1;
 	      curr_line_count += 1;
 	      
-	      nlp.apply(subj);
-	      
-	      if(configuration.write_nlp_output)
-		{
-		  nlp.write(subj);
-		}
-
 	      std::set<hash_type> doc_ents={};
-	      creator.update(subj, doc_ents);
+	      creator.update(*subj, doc_ents);
 	    }
 	  else	    
 	    {
@@ -347,31 +625,44 @@ namespace andromeda
 	      break;
 	    }
 
-	  bool my_turn = ((merge_count)%(configuration.num_threads)==thread_id);
 	  bool read_enough = (curr_line_count >= configuration.min_local_line_count);
 	  bool forced_merge = (curr_line_count >= configuration.max_local_line_count or
 			       ((loc_model->get_nodes()).size() > configuration.max_local_nodes) or
 			       ((loc_model->get_edges()).size() > configuration.max_local_edges)
 			       );
 
-	  if((my_turn and read_enough) or forced_merge)
+	  if(read_enough or forced_merge)
 	    {
-	      {
-		std::scoped_lock lock(update_mtx);
+	      // hand the local model over and continue on a fresh one
+	      scheduler->submit({loc_model, curr_line_count});
 
-		double merge_time = merger.merge(loc_model);
+	      merge_pending(false);
+	      
+	      curr_line_count = 0;
 
-		log->log(thread_id, tot_line_count, curr_line_count, merge_time, fin_model);
+	      loc_model = acquire();
+	      creator.set_model(loc_model);
+	    }
 
-		merge_count += 1;
+	  if(checkpoint!=NULL and checkpoint->is_due())
+	    {
+	      // all documents read so far need to be in the checkpoint
+	      if(curr_line_count>0)
+		{
+		  scheduler->submit({loc_model, curr_line_count});
+		  merge_pending(true);
 
-		curr_line_count = 0;
-	      }
-	      
-	      {
-		loc_model->initialise(1.1*configuration.max_local_nodes,
-				      1.1*configuration.max_local_edges);		
-	      }
+		  curr_line_count = 0;
+
+		  loc_model = acquire();
+		  creator.set_model(loc_model);
+		}
+	      else
+		{
+		  merge_pending(true);
+		}
+
+	      checkpoint->wait();
 	    }
 	  
 	  if(forced_merge and configuration.local_reading_break)
@@ -383,19 +674,142 @@ namespace andromeda
 	    }
 	}
 
-      {
-	std::scoped_lock lock(update_mtx);
-	
-	double merge_time = merger.merge(loc_model);
+      scheduler->submit({loc_model, curr_line_count});
 
-	log->log(thread_id, tot_line_count, curr_line_count, merge_time, fin_model);
-      }
-      
-      loc_model->initialise();
+      merge_pending(true);
+
+      if(checkpoint!=NULL)
+	{
+	  checkpoint->leave();
+	}
       
       return loc_line_count;
     }
 
+    template<typename model_type>
+    template<typename producer_type>
+    void model_cli<CREATE, model_type>::read_task(std::size_t thread_id,
+						  std::mutex& read_mtx,
+						  std::size_t& tot_line_count,
+						  std::atomic<std::size_t>& num_active,
+						  std::shared_ptr<producer_type>& reader,
+						  queue_ptr_type<producer_type> parsed)
+    {
+      typedef typename producer_type::subject_type subject_type;
+
+      std::string raw="";
+      std::filesystem::path path;
+
+      while(true)
+	{
+	  bool read=true;
+	  {
+	    std::scoped_lock lock(read_mtx);
+	    read = reader->fetch(raw, path, tot_line_count);
+	  }
+
+	  if(not read)
+	    {
+	      break;
+	    }
+
+	  // the (json-)parsing is done outside of the lock
+	  auto subj = std::make_shared<subject_type>();
+
+	  bool valid=false;
+	  try
+	    {
+	      valid = reader->parse(*subj, raw, path);
+	    }
+	  catch(const std::exception& e)
+	    {
+	      LOG_S(ERROR) << "could not parse " << path.string() << ": " << e.what();
+	    }
+
+	  if(valid and (not parsed->push(subj)))
+	    {
+	      break;
+	    }
+	}
+
+      if((--num_active)==0)
+	{
+	  parsed->close();
+	}
+    }
+
+    template<typename model_type>
+    template<typename producer_type>
+    void model_cli<CREATE, model_type>::nlp_task(std::size_t thread_id,
+						 nlohmann::json& config,
+						 std::atomic<std::size_t>& num_active,
+						 queue_ptr_type<producer_type> parsed,
+						 queue_ptr_type<producer_type> annotated)
+    {
+      typedef typename producer_type::subject_type subject_type;
+
+      // every worker has its own instances of the NLP-models
+      glm_parameters parameters(config, false);
+      producer_type nlp(parameters.models);
+
+      if(configuration.write_nlp_output)
+	{
+	  set_nlp_output(thread_id, nlp);
+	}
+
+      std::shared_ptr<subject_type> subj=NULL;
+      while(parsed->pop(subj))
+	{
+	  try
+	    {
+	      nlp.apply(*subj);
+	    }
+	  catch(const std::exception& e)
+	    {
+	      LOG_S(ERROR) << "could not apply NLP: " << e.what();
+	      continue;
+	    }
+
+	  if(configuration.write_nlp_output)
+	    {
+	      nlp.write(*subj);
+	    }
+
+	  if(not annotated->push(subj))
+	    {
+	      break;
+	    }
+	}
+
+      if((--num_active)==0)
+	{
+	  annotated->close();
+	}
+    }
+
+    template<typename model_type>
+    template<typename producer_type>
+    void model_cli<CREATE, model_type>::set_nlp_output(std::size_t thread_id, producer_type& nlp)
+    {
+      if(nlp.get_subject_name()==TEXT)
+	{
+	  std::filesystem::path file = "nlp-"+std::to_string(thread_id) + ".jsonl";	  
+	  std::filesystem::path path = configuration.nlp_output_dir / file;
+	  
+	  LOG_S(WARNING) << "writing NLP to: " << path;
+	  configuration.write_nlp_output = nlp.set_ofs(path);
+	}
+      else if(nlp.get_subject_name()==DOCUMENT)
+	{
+	  std::filesystem::path odir = configuration.nlp_output_dir;
+	  
+	  LOG_S(WARNING) << "writing NLP to: " << odir;
+	  configuration.write_nlp_output = nlp.set_ofs(odir);
+	}
+      else
+	{}
+    }
+
   }
 
 }
@@ -19,9 +19,28 @@ namespace andromeda
       const static inline std::string model_dir_lbl = io_base::root_lbl;
 
       const static inline std::string num_threads_lbl = "number-of-threads";
+      const static inline std::string num_shards_lbl = "number-of-shards"; // 0: derived from #-threads
       const static inline std::string enforce_max_size_lbl = "enforce-max-size";
+      const static inline std::string max_pending_merges_lbl = "max-pending-merges"; // 0: #-threads
 
       const static inline std::string write_nlp_output_lbl = "write-nlp-output";
+
+      const static inline std::string pipeline_lbl = "pipeline"; // staged reading, NLP and insertion
+      const static inline std::string num_reader_threads_lbl = "number-of-reader-threads";
+      const static inline std::string num_nlp_threads_lbl = "number-of-nlp-threads"; // 0: #-threads
+      const static inline std::string queue_size_lbl = "pipeline-queue-size";
+
+      const static inline std::string spill_runs_lbl = "spill-runs"; // out-of-core edges
+      const static inline std::string spill_dir_lbl = "spill-directory";
+
+      const static inline std::string checkpoint_interval_lbl = "checkpoint-interval"; // #-documents, 0: off
+      const static inline std::string checkpoint_dir_lbl = "checkpoint-directory";
+      const static inline std::string resume_lbl = "resume"; // from the last checkpoint
+
+      const static inline std::string heavy_hitters_lbl = "heavy-hitters"; // approximate admission
+      const static inline std::string heavy_hitter_min_count_lbl = "heavy-hitter-min-count";
+      const static inline std::string heavy_hitter_epsilon_lbl = "heavy-hitter-epsilon";
+      const static inline std::string heavy_hitter_delta_lbl = "heavy-hitter-delta";
       
       const static inline std::string model_lbl = "model";
       const static inline std::string worker_lbl = "worker";
@@ -49,11 +68,28 @@ namespace andromeda
       std::string model_dir;
 
       std::size_t num_threads;
+      std::size_t num_shards;
+      std::size_t max_pending_merges;
 
       bool enforce_max_size, local_reading_break;
 
       bool write_nlp_output;
       std::string nlp_output_dir;
+
+      bool pipeline;
+      std::size_t num_reader_threads, num_nlp_threads;
+      std::size_t queue_size;
+
+      bool spill_runs;
+      std::string spill_dir;
+
+      std::size_t checkpoint_interval;
+      std::string checkpoint_dir;
+      bool resume;
+
+      bool heavy_hitters;
+      std::size_t heavy_hitter_min_count;
+      double heavy_hitter_epsilon, heavy_hitter_delta;
       
       std::size_t min_local_line_count;
       std::size_t max_local_line_count;
@@ -71,12 +107,31 @@ namespace andromeda
       model_dir("./glm-model"),
 
       num_threads(4),
+      num_shards(0),
+      max_pending_merges(0),
 
       enforce_max_size(false),
       local_reading_break(true),
 
       write_nlp_output(false),
       nlp_output_dir(model_dir+"/nlp-output"),
+
+      pipeline(false),
+      num_reader_threads(1),
+      num_nlp_threads(0),
+      queue_size(64),
+
+      spill_runs(false),
+      spill_dir(""),
+
+      checkpoint_interval(0),
+      checkpoint_dir(""),
+      resume(false),
+
+      heavy_hitters(false),
+      heavy_hitter_min_count(2),
+      heavy_hitter_epsilon(1.e-6),
+      heavy_hitter_delta(0.01),
       
       min_local_line_count(256),
       max_local_line_count(10*min_local_line_count),
@@ -94,12 +149,31 @@ namespace andromeda
       model_dir("./glm-model"),
 
       num_threads(1),
+      num_shards(0),
+      max_pending_merges(0),
 
       enforce_max_size(false),
       local_reading_break(true),
 
       write_nlp_output(false),
       nlp_output_dir(model_dir+"/nlp-output"),
+
+      pipeline(false),
+      num_reader_threads(1),
+      num_nlp_threads(0),
+      queue_size(64),
+
+      spill_runs(false),
+      spill_dir(""),
+
+      checkpoint_interval(0),
+      checkpoint_dir(""),
+      resume(false),
+
+      heavy_hitters(false),
+      heavy_hitter_min_count(2),
+      heavy_hitter_epsilon(1.e-6),
+      heavy_hitter_delta(0.01),
       
       min_local_line_count(256),
       max_local_line_count(10*min_local_line_count),
@@ -120,9 +194,28 @@ namespace andromeda
           nlohmann::json& create = config[create_lbl];
 
           num_threads = create.value(num_threads_lbl, num_threads);
+          num_shards = create.value(num_shards_lbl, num_shards);
           enforce_max_size = create.value(enforce_max_size_lbl, enforce_max_size);
+          max_pending_merges = create.value(max_pending_merges_lbl, max_pending_merges);
 
           write_nlp_output = create.value(write_nlp_output_lbl, write_nlp_output);
+
+          pipeline = create.value(pipeline_lbl, pipeline);
+          num_reader_threads = create.value(num_reader_threads_lbl, num_reader_threads);
+          num_nlp_threads = create.value(num_nlp_threads_lbl, num_nlp_threads);
+          queue_size = create.value(queue_size_lbl, queue_size);
+
+          spill_runs = create.value(spill_runs_lbl, spill_runs);
+          spill_dir = create.value(spill_dir_lbl, spill_dir);
+
+          checkpoint_interval = create.value(checkpoint_interval_lbl, checkpoint_interval);
+          checkpoint_dir = create.value(checkpoint_dir_lbl, checkpoint_dir);
+          resume = create.value(resume_lbl, resume);
+
+          heavy_hitters = create.value(heavy_hitters_lbl, heavy_hitters);
+          heavy_hitter_min_count = create.value(heavy_hitter_min_count_lbl, heavy_hitter_min_count);
+          heavy_hitter_epsilon = create.value(heavy_hitter_epsilon_lbl, heavy_hitter_epsilon);
+          heavy_hitter_delta = create.value(heavy_hitter_delta_lbl, heavy_hitter_delta);
 	  
 	  nlohmann::json& model = create[model_lbl];
 	  {
@@ -153,6 +246,16 @@ namespace andromeda
 	  nlp_output_dir = model_dir + "/" + "nlp-output";
         }
 
+      if(spill_dir=="")
+	{
+	  spill_dir = model_dir + "/" + "spill-runs";
+	}
+
+      if(checkpoint_dir=="")
+	{
+	  checkpoint_dir = model_dir + "/" + "checkpoint";
+	}
+
       if(not std::filesystem::exists(model_dir))
 	{
 	  std::filesystem::create_directory(model_dir);
@@ -173,9 +276,28 @@ namespace andromeda
       auto& create = result[create_lbl];
       {
 	create[num_threads_lbl] = num_threads;
+	create[num_shards_lbl] = num_shards;
 	create[enforce_max_size_lbl] = enforce_max_size;
+	create[max_pending_merges_lbl] = max_pending_merges;
 
 	create[write_nlp_output_lbl] = write_nlp_output;
+
+	create[pipeline_lbl] = pipeline;
+	create[num_reader_threads_lbl] = num_reader_threads;
+	create[num_nlp_threads_lbl] = num_nlp_threads;
+	create[queue_size_lbl] = queue_size;
+
+	create[spill_runs_lbl] = spill_runs;
+	create[spill_dir_lbl] = spill_dir;
+
+	create[checkpoint_interval_lbl] = checkpoint_interval;
+	create[checkpoint_dir_lbl] = checkpoint_dir;
+	create[resume_lbl] = resume;
+
+	create[heavy_hitters_lbl] = heavy_hitters;
+	create[heavy_hitter_min_count_lbl] = heavy_hitter_min_count;
+	create[heavy_hitter_epsilon_lbl] = heavy_hitter_epsilon;
+	create[heavy_hitter_delta_lbl] = heavy_hitter_delta;
 	
 	nlohmann::json& model = create[model_lbl];
 	{
@@ -17,7 +17,7 @@ namespace andromeda
 			 std::size_t, // incr line-count
 			 std::size_t, std::size_t, std::size_t, std::size_t,// total count
                          double, double, double, double, // % increase 
-			 double, double, double, double,// timings [msec]
+			 double, double, double, double, double,// timings [msec]
 			 double, double, double, double// max-load-factor                        
 			 > row_type;
 
@@ -27,10 +27,22 @@ namespace andromeda
 
       template<typename glm_model_type>
       void log(std::size_t id, std::size_t line, std::size_t loc_lines,
-	       double merge_time, std::shared_ptr<glm_model_type> model);
+	       double merge_time, double wait_time, std::shared_ptr<glm_model_type> model);
+
+      template<typename glm_model_type>
+      void log(std::size_t id, std::size_t line, std::size_t loc_lines,
+	       double merge_time, double wait_time, std::shared_ptr<model_shards<glm_model_type> > shards);
       
       void save();
       
+    private:
+
+      void log(std::size_t id, std::size_t line, std::size_t loc_lines,
+	       double merge_time, double wait_time,
+	       std::size_t curr_nodes, std::size_t curr_edges,
+	       std::size_t curr_tokens, std::size_t curr_concepts,
+	       double lf_nodes, double lf_edges, double mlf_nodes, double mlf_edges);
+
     private:
 
       std::filesystem::path log_dir;
@@ -70,7 +82,7 @@ namespace andromeda
       header({"id", "total-lines", "local-lines", "cumulative-lines",
               "nodes", "edges", "tokens", "concepts", 
 	      "new-nodes [%]", "new-edges [%]", "new-tokens [%]", "new-concepts [%]", 
-	      "time [msec]", "delta [msec]", "delta-id [msec]",  "merge [msec]",
+	      "time [msec]", "delta [msec]", "delta-id [msec]",  "merge [msec]", "wait [msec]",
 	      "load-factor nodes", "load-factor edges", "max-load-factor nodes", "max-load-factor edges"
 	}),
       data({})
@@ -83,7 +95,38 @@ namespace andromeda
 
     template<typename glm_model_type>
     void create_log::log(std::size_t id, std::size_t tot_lines, std::size_t loc_lines,
-			 double merge_time, std::shared_ptr<glm_model_type> model)
+			 double merge_time, double wait_time, std::shared_ptr<glm_model_type> model)
+    {
+      auto& nodes = model->get_nodes();
+      auto& edges = model->get_edges();
+
+      log(id, tot_lines, loc_lines, merge_time, wait_time,
+	  nodes.size(), edges.size(),
+	  nodes.size(node_names::WORD_TOKEN), nodes.size(node_names::TERM),
+	  nodes.load_factor(), edges.load_factor(),
+	  nodes.max_load_factor(), edges.max_load_factor());
+    }
+
+    template<typename glm_model_type>
+    void create_log::log(std::size_t id, std::size_t tot_lines, std::size_t loc_lines,
+			 double merge_time, double wait_time, std::shared_ptr<model_shards<glm_model_type> > shards)
+    {
+      // the load-factors are the maximum over all shards
+      auto& nodes = (shards->at(0))->get_nodes();
+      auto& edges = (shards->at(0))->get_edges();
+
+      log(id, tot_lines, loc_lines, merge_time, wait_time,
+	  shards->number_of_nodes(), shards->number_of_edges(),
+	  shards->number_of_nodes(node_names::WORD_TOKEN), shards->number_of_nodes(node_names::TERM),
+	  shards->node_load_factor(), shards->edge_load_factor(),
+	  nodes.max_load_factor(), edges.max_load_factor());
+    }
+
+    void create_log::log(std::size_t id, std::size_t tot_lines, std::size_t loc_lines,
+			 double merge_time, double wait_time,
+			 std::size_t curr_nodes, std::size_t curr_edges,
+			 std::size_t curr_tokens, std::size_t curr_concepts,
+			 double lf_nodes, double lf_edges, double mlf_nodes, double mlf_edges)
     {
       auto now = std::chrono::system_clock::now();
 
@@ -105,21 +148,6 @@ namespace andromeda
 
       std::size_t cum_lines = loc_lines;
 
-      auto& nodes = model->get_nodes();
-      auto& edges = model->get_edges();
-
-      auto curr_nodes = nodes.size();
-      auto curr_edges = edges.size();
-
-      auto curr_tokens   = nodes.size(node_names::WORD_TOKEN);
-      auto curr_concepts = nodes.size(node_names::TERM);
-      
-      double lf_nodes = nodes.load_factor();
-      double lf_edges = edges.load_factor();
-
-      double mlf_nodes = nodes.max_load_factor();
-      double mlf_edges = edges.max_load_factor();
-      
       double perc_nodes = 100.0;
       double perc_edges = 100.0;
 
@@ -132,7 +160,7 @@ namespace andromeda
             = std::make_tuple(id, tot_lines, loc_lines, cum_lines,
 			      curr_nodes, curr_edges, curr_tokens, curr_concepts,
 			      perc_nodes, perc_edges, perc_tokens, perc_concepts,
-                              (total_t).count(), (delta_t).count(), (delta_id).count(), merge_time,
+                              (total_t).count(), (delta_t).count(), (delta_id).count(), merge_time, wait_time,
 			      lf_nodes, lf_edges, mlf_nodes, mlf_edges);
 	  
 	  data.push_back(row);
@@ -157,7 +185,7 @@ namespace andromeda
             = std::make_tuple(id, tot_lines, loc_lines, cum_lines, // 1-3
 			      curr_nodes, curr_edges, curr_tokens, curr_concepts,
 			      perc_nodes, perc_edges, perc_tokens, perc_concepts,			      
-			      (total_t).count(), (delta_t).count(), (delta_id).count(), merge_time, 
+			      (total_t).count(), (delta_t).count(), (delta_id).count(), merge_time, wait_time, 
 			      lf_nodes, lf_edges, mlf_nodes, mlf_edges); 
 
 	  data.push_back(row);
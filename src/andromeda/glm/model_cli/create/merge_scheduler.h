@@ -0,0 +1,234 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_MODEL_CLI_CREATE_MERGE_SCHEDULER_H_
+#define ANDROMEDA_MODELS_GLM_MODEL_CLI_CREATE_MERGE_SCHEDULER_H_
+
+#include <condition_variable>
+#include <deque>
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Schedules the merges of local models into the final model during
+     * create. A worker hands its full local model to the scheduler and
+     * continues with a fresh one from the pool, the pending models are
+     * merged by whichever worker is free. Hence, a slow worker does not
+     * hold up the merge cadence of the others.
+     *
+     * While the final model is busy, two pending models can be combined
+     * (pairwise, without touching the final model), so that fewer and
+     * larger merges hit the final model. The pool has a model per worker
+     * plus `max_pending` models, which bounds the memory.
+     */
+    template<typename model_type>
+    class merge_scheduler
+    {
+    public:
+
+      struct job_type
+      {
+        std::shared_ptr<model_type> model;
+
+        std::size_t num_lines; // #-lines read into the model
+      };
+
+    public:
+
+      merge_scheduler(nlohmann::json& config,
+                      std::size_t num_workers, std::size_t max_pending,
+                      std::size_t max_local_edges);
+
+      std::shared_ptr<model_type> acquire(double& wait_time);
+      void release(std::shared_ptr<model_type> model);
+
+      void submit(job_type job);
+      bool pop(job_type& job);
+
+      bool combine(job_type& job);
+
+      void log_statistics();
+
+    private:
+
+      std::size_t max_local_edges;
+
+      std::mutex mtx;
+      std::condition_variable changed;
+
+      std::vector<std::shared_ptr<model_type> > free_models;
+      std::deque<job_type> pending;
+
+      std::size_t num_submitted, num_combined;
+      double acquire_wait; // in ms
+    };
+
+    template<typename model_type>
+    merge_scheduler<model_type>::merge_scheduler(nlohmann::json& config,
+                                                 std::size_t num_workers, std::size_t max_pending,
+                                                 std::size_t max_local_edges):
+      max_local_edges(max_local_edges),
+
+      mtx(),
+      changed(),
+
+      free_models({}),
+      pending({}),
+
+      num_submitted(0),
+      num_combined(0),
+
+      acquire_wait(0.0)
+    {
+      // the NLP is done by the workers, the local models do not need the NLP-models
+      nlohmann::json loc_config = config;
+      loc_config.erase(glm_parameters::nlp_models_lbl);
+
+      // local models grow on demand and keep their memory between merges
+      // (see `reset`), so nothing is reserved upfront
+      for(std::size_t l=0; l<num_workers+std::max(std::size_t(1), max_pending); l++)
+        {
+          auto model = std::make_shared<model_type>();
+
+          model->configure(loc_config, false);
+          model->initialise();
+
+          free_models.push_back(model);
+        }
+    }
+
+    /*
+     * Returns a free local model, or NULL if all models are pending or
+     * being merged. In the latter case, the caller is expected to help
+     * with the pending merges before it tries again.
+     */
+    template<typename model_type>
+    std::shared_ptr<model_type> merge_scheduler<model_type>::acquire(double& wait_time)
+    {
+      auto start = std::chrono::system_clock::now();
+
+      std::unique_lock<std::mutex> lock(mtx);
+
+      // nothing pending, so a model that is being merged comes back soon
+      changed.wait(lock, [this] { return ((not free_models.empty()) or (not pending.empty())); });
+
+      std::chrono::duration<double, std::milli> delta = std::chrono::system_clock::now()-start;
+
+      wait_time += delta.count();
+      acquire_wait += delta.count();
+
+      if(free_models.empty())
+        {
+          return NULL;
+        }
+
+      auto model = free_models.back();
+      free_models.pop_back();
+
+      return model;
+    }
+
+    template<typename model_type>
+    void merge_scheduler<model_type>::release(std::shared_ptr<model_type> model)
+    {
+      model->reset();
+
+      {
+        std::scoped_lock lock(mtx);
+        free_models.push_back(model);
+      }
+
+      changed.notify_all();
+    }
+
+    template<typename model_type>
+    void merge_scheduler<model_type>::submit(job_type job)
+    {
+      {
+        std::scoped_lock lock(mtx);
+
+        pending.push_back(job);
+        num_submitted += 1;
+      }
+
+      changed.notify_all();
+    }
+
+    template<typename model_type>
+    bool merge_scheduler<model_type>::pop(job_type& job)
+    {
+      std::scoped_lock lock(mtx);
+
+      if(pending.empty())
+        {
+          return false;
+        }
+
+      job = pending.front();
+      pending.pop_front();
+
+      return true;
+    }
+
+    /*
+     * Combines `job` with another pending model (if there is one and the
+     * result stays within the local limits), the combined job is pending
+     * again afterwards. Returns false if `job` was put back as is.
+     */
+    template<typename model_type>
+    bool merge_scheduler<model_type>::combine(job_type& job)
+    {
+      job_type other;
+      {
+        std::scoped_lock lock(mtx);
+
+        std::size_t num_edges = (job.model->get_edges()).size();
+        if(pending.empty() or
+           num_edges+(pending.front().model->get_edges()).size() > max_local_edges)
+          {
+            pending.push_front(job);
+            return false;
+          }
+
+        other = pending.front();
+        pending.pop_front();
+      }
+
+      // without admission or size limits, these are applied when merging
+      // into the final model
+      model_merger<model_type> merger(job.model, false);
+      merger.merge(other.model);
+
+      job.num_lines += other.num_lines;
+
+      release(other.model);
+
+      {
+        std::scoped_lock lock(mtx);
+
+        pending.push_back(job);
+        num_combined += 1;
+      }
+
+      changed.notify_all();
+
+      return true;
+    }
+
+    template<typename model_type>
+    void merge_scheduler<model_type>::log_statistics()
+    {
+      std::scoped_lock lock(mtx);
+
+      LOG_S(INFO) << "merge-scheduler: " << num_submitted << " local models submitted, "
+                  << num_combined << " pairwise combined, "
+                  << "workers waited " << std::fixed << std::setprecision(1)
+                  << acquire_wait/1000.0 << " sec for a free local model";
+    }
+
+  }
+
+}
+
+#endif
@@ -0,0 +1,298 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_MODEL_CLI_CREATE_ADMISSION_H_
+#define ANDROMEDA_MODELS_GLM_MODEL_CLI_CREATE_ADMISSION_H_
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Heavy-hitter admission for the final model during create. Edges and
+     * path nodes (CONN, TERM, VERB, SENT) that are not yet in the final
+     * model are first counted in a count-min sketch, and only enter the
+     * final model once their estimated count reaches `min_count`. They are
+     * admitted with the estimated counts (all five counters of a node), so
+     * that their earlier occurrences are not lost. A new edge is only
+     * admitted if both its nodes are in the final model, otherwise the
+     * edges of a rejected path node would point nowhere.
+     *
+     * The sketch has width e/epsilon and depth ln(1/delta): with
+     * probability 1-delta, an estimate exceeds the true count by at most
+     * epsilon times the total count. We use conservative updates, which
+     * keep the over-estimation well below that bound in practice.
+     *
+     * The counters are atomic, so that concurrent merges into different
+     * shards can share the sketches.
+     */
+    template<typename model_type>
+    class model_admission: public base_types
+    {
+      typedef typename model_type::node_type node_type;
+      typedef typename model_type::edge_type edge_type;
+
+      typedef typename model_type::nodes_type nodes_type;
+      typedef typename model_type::edges_type edges_type;
+
+      const static inline std::size_t NUM_NODE_CNTS = 5; // word, sent, text, tabl and fdoc
+
+      /*
+       * Every cell holds `num_cnts` counters, which are updated
+       * independently: each of them is a count-min sketch on its own.
+       */
+      class count_min_sketch
+      {
+      public:
+
+        count_min_sketch(double epsilon, double delta, std::size_t num_cnts);
+
+        std::size_t memory_size() const { return counters.size()*sizeof(cnt_type); }
+
+        // adds `cnts` and returns the new estimates in `ests`
+        void add(hash_type hash, const cnt_type* cnts, cnt_type* ests);
+
+      private:
+
+        std::size_t index(std::size_t row, hash_type hash) const;
+
+      private:
+
+        std::size_t depth, width, mask, num_cnts;
+
+        std::vector<std::atomic<cnt_type> > counters;
+      };
+
+    public:
+
+      model_admission(cnt_type min_count, double epsilon, double delta);
+
+      bool is_filtered(const node_type& node) const;
+
+      void insert(nodes_type& nodes, node_type& node, bool check_size);
+
+      void insert(const nodes_type& nodes, edges_type& edges, const edge_type& edge, bool check_size);
+      void insert(edges_type& edges, const edge_type& edge, bool check_size);
+
+      // removes the edges of which a node was not admitted (needed after a sharded merge)
+      void prune(model_type& model, std::size_t num_threads);
+
+      void log_statistics();
+
+    private:
+
+      cnt_type min_count;
+
+      count_min_sketch node_sketch, edge_sketch;
+
+      std::atomic<std::size_t> rejected_nodes, rejected_edges;
+    };
+
+    template<typename model_type>
+    model_admission<model_type>::count_min_sketch::count_min_sketch(double epsilon, double delta, std::size_t num_cnts):
+      depth(std::max(1.0, std::ceil(std::log(1.0/delta)))),
+      width(std::bit_ceil(std::size_t(std::ceil(std::exp(1.0)/epsilon)))),
+      mask(width-1),
+      num_cnts(num_cnts),
+
+      counters(depth*width*num_cnts)
+    {
+      for(auto& counter:counters)
+        {
+          counter.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    template<typename model_type>
+    std::size_t model_admission<model_type>::count_min_sketch::index(std::size_t row, hash_type hash) const
+    {
+      // double hashing: row r uses h1 + r*h2
+      hash_type h1 = utils::murmerhash3(hash);
+      hash_type h2 = utils::murmerhash3(h1) | 1;
+
+      return (row*width + ((h1 + row*h2) & mask))*num_cnts;
+    }
+
+    template<typename model_type>
+    void model_admission<model_type>::count_min_sketch::add(hash_type hash, const cnt_type* cnts, cnt_type* ests)
+    {
+      for(std::size_t k=0; k<num_cnts; k++)
+        {
+          cnt_type est = std::numeric_limits<cnt_type>::max();
+          for(std::size_t row=0; row<depth; row++)
+            {
+              est = std::min(est, counters[index(row, hash)+k].load(std::memory_order_relaxed));
+            }
+
+          cnt_type target = (est > std::numeric_limits<cnt_type>::max()-cnts[k])?
+            std::numeric_limits<cnt_type>::max() : est+cnts[k];
+
+          // conservative update: only raise the counters below the new estimate
+          for(std::size_t row=0; row<depth; row++)
+            {
+              auto& counter = counters[index(row, hash)+k];
+
+              cnt_type curr = counter.load(std::memory_order_relaxed);
+              while(curr<target and
+                    not counter.compare_exchange_weak(curr, target, std::memory_order_relaxed))
+                {}
+            }
+
+          ests[k] = target;
+        }
+    }
+
+    template<typename model_type>
+    model_admission<model_type>::model_admission(cnt_type min_count, double epsilon, double delta):
+      min_count(min_count),
+
+      node_sketch(epsilon, delta, NUM_NODE_CNTS),
+      edge_sketch(epsilon, delta, 1),
+
+      rejected_nodes(0),
+      rejected_edges(0)
+    {
+      LOG_S(INFO) << "heavy-hitter admission (min-count: " << min_count << ", "
+                  << "epsilon: " << epsilon << ", delta: " << delta << ", "
+                  << "sketch-memory: " << (node_sketch.memory_size()+edge_sketch.memory_size())/1e6
+                  << " MB)";
+    }
+
+    template<typename model_type>
+    bool model_admission<model_type>::is_filtered(const node_type& node) const
+    {
+      switch(node.get_flvr())
+        {
+        case node_names::CONN:
+        case node_names::TERM:
+        case node_names::VERB:
+        case node_names::SENT:
+          return true;
+
+        default:
+          return false;
+        }
+    }
+
+    template<typename model_type>
+    void model_admission<model_type>::insert(nodes_type& nodes, node_type& node, bool check_size)
+    {
+      if((not is_filtered(node)) or nodes.has(node.get_hash()))
+        {
+          nodes.insert(node, check_size);
+          return;
+        }
+
+      std::array<cnt_type, NUM_NODE_CNTS> cnts = { node.get_word_cnt(), node.get_sent_cnt(),
+                                                   node.get_text_cnt(), node.get_tabl_cnt(),
+                                                   node.get_fdoc_cnt() };
+
+      std::array<cnt_type, NUM_NODE_CNTS> ests;
+      node_sketch.add(node.get_hash(), cnts.data(), ests.data());
+
+      if(ests[0]>=min_count)
+        {
+          node_type& admitted = nodes.insert(node, check_size);
+
+          admitted.set_word_cnt(std::max(ests[0], cnts[0]));
+          admitted.set_sent_cnt(std::max(ests[1], cnts[1]));
+          admitted.set_text_cnt(std::max(ests[2], cnts[2]));
+          admitted.set_tabl_cnt(std::max(ests[3], cnts[3]));
+          admitted.set_fdoc_cnt(std::max(ests[4], cnts[4]));
+        }
+      else
+        {
+          rejected_nodes += 1;
+        }
+    }
+
+    /*
+     * The nodes of the edge are merged before the edge, so `nodes` tells
+     * whether they were admitted. An edge that is held back still counts
+     * in the sketch, so it gets its earlier occurrences once its nodes are
+     * admitted.
+     */
+    template<typename model_type>
+    void model_admission<model_type>::insert(const nodes_type& nodes, edges_type& edges,
+                                             const edge_type& edge, bool check_size)
+    {
+      if(edges.has(edge))
+        {
+          edges.insert(edge, check_size);
+          return;
+        }
+
+      cnt_type cnt = edge.get_count(), est=0;
+      edge_sketch.add(edge.get_hash(), &cnt, &est);
+
+      if(est>=min_count and nodes.has(edge.get_hash_i()) and nodes.has(edge.get_hash_j()))
+        {
+          edge_type admitted = edge;
+          admitted.set_count(est);
+
+          edges.insert(admitted, check_size);
+        }
+      else
+        {
+          rejected_edges += 1;
+        }
+    }
+
+    /*
+     * In a shard the nodes of an edge can live in other shards, so the
+     * edges are only checked against their nodes in `prune`, once the
+     * shards are gathered.
+     */
+    template<typename model_type>
+    void model_admission<model_type>::insert(edges_type& edges, const edge_type& edge, bool check_size)
+    {
+      if(edges.has(edge))
+        {
+          edges.insert(edge, check_size);
+          return;
+        }
+
+      cnt_type cnt = edge.get_count(), est=0;
+      edge_sketch.add(edge.get_hash(), &cnt, &est);
+
+      if(est>=min_count)
+        {
+          edge_type admitted = edge;
+          admitted.set_count(est);
+
+          edges.insert(admitted, check_size);
+        }
+      else
+        {
+          rejected_edges += 1;
+        }
+    }
+
+    template<typename model_type>
+    void model_admission<model_type>::prune(model_type& model, std::size_t num_threads)
+    {
+      auto& nodes = model.get_nodes();
+      auto& edges = model.get_edges();
+
+      std::size_t num_edges = edges.size();
+
+      edges.compact([&nodes](const edge_type& edge)
+      {
+        return (nodes.has(edge.get_hash_i()) and nodes.has(edge.get_hash_j()));
+      }, num_threads);
+
+      rejected_edges += (num_edges-edges.size());
+    }
+
+    template<typename model_type>
+    void model_admission<model_type>::log_statistics()
+    {
+      LOG_S(INFO) << "heavy-hitter admission rejected "
+                  << rejected_nodes.load() << " path-nodes and "
+                  << rejected_edges.load() << " edges";
+    }
+
+  }
+
+}
+
+#endif
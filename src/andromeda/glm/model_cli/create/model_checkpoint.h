@@ -0,0 +1,298 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_MODEL_CLI_CREATE_CHECKPOINT_H_
+#define ANDROMEDA_MODELS_GLM_MODEL_CLI_CREATE_CHECKPOINT_H_
+
+#include <condition_variable>
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Periodic checkpoints of create. Every local model that is merged into
+     * the final model is also merged into a (small) delta model. Once every
+     * `interval` documents, the workers stop at a barrier after merging
+     * their local models, and the delta is written as a new segment next
+     * to the position of the producer. Hence, a checkpoint only writes what
+     * changed since the previous one.
+     *
+     * A restarted create replays the segments (in order and through the
+     * regular merge) and continues reading after the recorded position, so
+     * no document is processed twice.
+     *
+     * The state of the checkpoint is kept in `checkpoint.json`, which is
+     * only replaced (atomically) after its segment is fully written.
+     */
+    template<typename model_type>
+    class model_checkpoint
+    {
+      const static inline std::string state_file = "checkpoint.json";
+
+      const static inline std::string segments_lbl = "segments";
+      const static inline std::string position_lbl = "position";
+      const static inline std::string line_count_lbl = "line-count";
+
+    public:
+
+      model_checkpoint(std::filesystem::path dir, std::size_t interval,
+                       nlohmann::json& config,
+                       std::shared_ptr<base_producer> reader,
+                       std::size_t& line_count);
+
+      template<typename merge_func_type>
+      bool resume(merge_func_type merge);
+
+      void start(std::size_t num_workers);
+
+      void update(std::size_t line_count);
+      bool is_due() { return due.load(); }
+
+      void record(std::shared_ptr<model_type> model);
+
+      void wait();
+      void leave();
+
+    private:
+
+      void write();
+
+      void new_delta();
+
+    private:
+
+      std::filesystem::path dir;
+      std::size_t interval, next_line;
+
+      std::shared_ptr<base_producer> reader;
+      std::size_t& line_count;
+
+      nlohmann::json delta_config;
+
+      std::mutex delta_mtx;
+      std::shared_ptr<model_type> delta;
+
+      std::vector<std::string> segments;
+
+      std::atomic<bool> due;
+
+      // barrier of the workers
+      std::mutex mtx;
+      std::condition_variable cv;
+
+      std::size_t num_workers, num_arrived, generation;
+    };
+
+    template<typename model_type>
+    model_checkpoint<model_type>::model_checkpoint(std::filesystem::path dir, std::size_t interval,
+                                                   nlohmann::json& config,
+                                                   std::shared_ptr<base_producer> reader,
+                                                   std::size_t& line_count):
+      dir(dir),
+      interval(interval),
+      next_line(interval),
+
+      reader(reader),
+      line_count(line_count),
+
+      delta_config(config),
+
+      delta_mtx(),
+      delta(NULL),
+
+      segments({}),
+
+      due(false),
+
+      mtx(),
+      cv(),
+
+      num_workers(0),
+      num_arrived(0),
+      generation(0)
+    {
+      if(not std::filesystem::exists(dir))
+        {
+          std::filesystem::create_directories(dir);
+        }
+
+      // the delta only collects merged local models, it does not need the NLP-models
+      delta_config.erase(glm_parameters::nlp_models_lbl);
+
+      new_delta();
+    }
+
+    /*
+     * Replays the segments of the last checkpoint (if any) with `merge`
+     * and positions the producer after the documents they contain.
+     */
+    template<typename model_type>
+    template<typename merge_func_type>
+    bool model_checkpoint<model_type>::resume(merge_func_type merge)
+    {
+      std::filesystem::path path = dir / state_file;
+      if(not std::filesystem::exists(path))
+        {
+          LOG_S(WARNING) << "no checkpoint found in " << dir << ", starting from scratch";
+          return false;
+        }
+
+      nlohmann::json state;
+      {
+        std::ifstream ifs(path.c_str());
+        ifs >> state;
+      }
+
+      segments = state.value(segments_lbl, segments);
+
+      for(auto& segment:segments)
+        {
+          LOG_S(INFO) << "replaying checkpoint-segment " << segment;
+
+          auto model = std::make_shared<model_type>();
+
+          model_op<LOAD> loader;
+          if(not loader.load(dir / segment, model))
+            {
+              LOG_S(ERROR) << "could not load checkpoint-segment " << segment;
+              return false;
+            }
+
+          merge(model);
+        }
+
+      if(not reader->set_position(state[position_lbl]))
+        {
+          LOG_S(ERROR) << "could not set the position of the producer to "
+                       << state[position_lbl].dump();
+          return false;
+        }
+
+      line_count = state.value(line_count_lbl, line_count);
+      next_line = line_count + interval;
+
+      LOG_S(INFO) << "resuming create after " << line_count << " documents";
+      return true;
+    }
+
+    template<typename model_type>
+    void model_checkpoint<model_type>::start(std::size_t num_workers_)
+    {
+      std::scoped_lock lock(mtx);
+      num_workers = num_workers_;
+    }
+
+    /* called under the read-lock, after every read */
+    template<typename model_type>
+    void model_checkpoint<model_type>::update(std::size_t line_count)
+    {
+      if(interval>0 and line_count>=next_line)
+        {
+          due = true;
+        }
+    }
+
+    template<typename model_type>
+    void model_checkpoint<model_type>::record(std::shared_ptr<model_type> model)
+    {
+      std::scoped_lock lock(delta_mtx);
+
+      model_merger<model_type> merger(delta, false);
+      merger.merge(model);
+    }
+
+    /*
+     * Barrier for the workers once the checkpoint is due. The workers
+     * arrive after all their documents are merged, and the last one to
+     * arrive writes the checkpoint.
+     */
+    template<typename model_type>
+    void model_checkpoint<model_type>::wait()
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+
+      std::size_t curr = generation;
+      if((++num_arrived)==num_workers)
+        {
+          write();
+        }
+      else
+        {
+          cv.wait(lock, [this, curr] { return (generation!=curr); });
+        }
+    }
+
+    /* a worker that is done, no longer takes part in the barrier */
+    template<typename model_type>
+    void model_checkpoint<model_type>::leave()
+    {
+      std::scoped_lock lock(mtx);
+
+      num_workers -= 1;
+      if(num_arrived>0 and num_arrived==num_workers)
+        {
+          write();
+        }
+    }
+
+    template<typename model_type>
+    void model_checkpoint<model_type>::write()
+    {
+      auto start = std::chrono::system_clock::now();
+
+      std::string segment = "segment-" + std::to_string(segments.size());
+      {
+        std::scoped_lock lock(delta_mtx);
+
+        model_op<SAVE> saver;
+        saver.save(dir / segment, delta);
+
+        // saving sorts and freezes the edges, so we continue with a fresh delta
+        new_delta();
+      }
+      segments.push_back(segment);
+
+      nlohmann::json state = nlohmann::json::object({});
+      {
+        state[segments_lbl] = segments;
+        state[position_lbl] = reader->get_position();
+        state[line_count_lbl] = line_count;
+      }
+
+      std::filesystem::path path = dir / state_file;
+      std::filesystem::path tmp = dir / (state_file+".tmp");
+      {
+        std::ofstream ofs(tmp.c_str());
+        ofs << std::setw(2) << state;
+      }
+      std::filesystem::rename(tmp, path);
+
+      auto end = std::chrono::system_clock::now();
+      std::chrono::duration<double, std::milli> delta_t = (end-start);
+
+      LOG_S(INFO) << "checkpoint " << segment << " after " << line_count << " documents "
+                  << "(" << std::fixed << std::setprecision(1) << delta_t.count()/1000.0 << " sec)";
+
+      next_line = line_count + interval;
+      due = false;
+
+      num_arrived = 0;
+      generation += 1;
+
+      cv.notify_all();
+    }
+
+    template<typename model_type>
+    void model_checkpoint<model_type>::new_delta()
+    {
+      delta = std::make_shared<model_type>();
+
+      delta->configure(delta_config, false);
+      delta->initialise();
+    }
+
+  }
+
+}
+
+#endif
@@ -16,6 +16,9 @@ namespace andromeda
 
       model_creator(std::shared_ptr<model_type> model);
 
+      // continue on another (initialised) model
+      void set_model(std::shared_ptr<model_type> model) { model_ptr = model; }
+
       void update(subject<TEXT>& subj, std::set<hash_type>& docs_inserts);
       void update(subject<TABLE>& subj, std::set<hash_type>& docs_inserts);
       
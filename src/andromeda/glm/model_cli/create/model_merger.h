@@ -9,13 +9,37 @@ namespace andromeda
   namespace glm
   {
 
+    /*
+     * Merges local models into the final model. If the final model is
+     * sharded (see `model_shards`), the local model is first partitioned
+     * by shard, and the partitions are merged shard by shard under the
+     * lock of the shard only. Shards that are busy are skipped and retried
+     * after all others, so that concurrent merges rarely wait.
+     *
+     * With an admission filter (see `model_admission`), new edges and path
+     * nodes only enter the final model once they are frequent enough.
+     */
     template<typename model_type>
     class model_merger
     {
+      typedef typename model_type::node_type node_type;
+      typedef typename model_type::edge_type edge_type;
+
+      typedef model_admission<model_type> admission_type;
+
+      // local models of at least this fraction of the final model are
+      // merged with a bulk sort-merge instead of edge-by-edge inserts
+      const static inline double BULK_MERGE_RATIO = 0.25;
+
     public:
 
       model_merger(std::shared_ptr<model_type> model,
 		   bool enforce_max_size);
+
+      model_merger(std::shared_ptr<model_shards<model_type> > shards,
+		   bool enforce_max_size, std::size_t offset);
+
+      void set_admission(std::shared_ptr<admission_type> admission) { this->admission = admission; }
       
       double merge(std::shared_ptr<model_type> other);
 
@@ -24,29 +48,73 @@ namespace andromeda
       void merge_nodes(std::shared_ptr<model_type> other);
 
       void merge_edges(std::shared_ptr<model_type> other);
+
+      void merge_shards(std::shared_ptr<model_type> other);
+
+      void merge_shard(std::size_t ind);
       
     private:
 
       std::shared_ptr<model_type> model;
+      std::shared_ptr<model_shards<model_type> > shards;
+
+      std::shared_ptr<admission_type> admission;
 
       bool enforce_max_size;
+
+      std::size_t offset;
+
+      std::vector<std::vector<node_type*> > shard_nodes;
+      std::vector<std::vector<edge_type> > shard_edges;
     };
 
     template<typename model_type>
     model_merger<model_type>::model_merger(std::shared_ptr<model_type> model,
 					   bool enforce_max_size):
       model(model),
-      enforce_max_size(enforce_max_size)
+      shards(NULL),
+
+      admission(NULL),
+
+      enforce_max_size(enforce_max_size),
+
+      offset(0),
+
+      shard_nodes({}),
+      shard_edges({})
+    {}
+
+    template<typename model_type>
+    model_merger<model_type>::model_merger(std::shared_ptr<model_shards<model_type> > shards,
+					   bool enforce_max_size, std::size_t offset):
+      model(NULL),
+      shards(shards),
+
+      admission(NULL),
+
+      enforce_max_size(enforce_max_size),
+
+      offset(offset),
+
+      shard_nodes(shards->size()),
+      shard_edges(shards->size())
     {}
 
     template<typename model_type>
     double model_merger<model_type>::merge(std::shared_ptr<model_type> other)
     {
       auto start = std::chrono::system_clock::now();
-      
-      merge_nodes(other);
 
-      merge_edges(other);
+      if(shards==NULL)
+	{
+	  merge_nodes(other);
+
+	  merge_edges(other);
+	}
+      else
+	{
+	  merge_shards(other);
+	}
 
       auto end = std::chrono::system_clock::now();
       std::chrono::duration<double, std::milli> delta = (end-start);
@@ -64,7 +132,14 @@ namespace andromeda
 	{
 	  for(auto& node:itr->second)
 	    {
-	      these_nodes.insert(node, enforce_max_size);
+	      if(admission==NULL)
+		{
+		  these_nodes.insert(node, enforce_max_size);
+		}
+	      else
+		{
+		  admission->insert(these_nodes, node, enforce_max_size);
+		}
 	    }
 	}
     }
@@ -72,20 +147,120 @@ namespace andromeda
     template<typename model_type>
     void model_merger<model_type>::merge_edges(std::shared_ptr<model_type> other)
     {
+      auto& these_nodes = model->get_nodes();
       auto& these_edges = model->get_edges();
       auto& other_edges = other->get_edges();
 
+      if((not enforce_max_size) and (admission==NULL) and
+	 other_edges.size() >= BULK_MERGE_RATIO*these_edges.size())
+	{
+	  these_edges.merge(other_edges);
+	  return;
+	}
+
       for(auto flvr_itr=other_edges.begin(); flvr_itr!=other_edges.end(); flvr_itr++)      
 	{
 	  auto& edge_coll = flvr_itr->second;
 
 	  for(auto edge_itr=edge_coll.begin(); edge_itr!=edge_coll.end(); edge_itr++)
 	    {
-	      these_edges.insert(*edge_itr, enforce_max_size);
+	      if(admission==NULL)
+		{
+		  these_edges.insert(*edge_itr, enforce_max_size);
+		}
+	      else
+		{
+		  admission->insert(these_nodes, these_edges, *edge_itr, enforce_max_size);
+		}
 	    }
 	}	  
     }
 
+    template<typename model_type>
+    void model_merger<model_type>::merge_shards(std::shared_ptr<model_type> other)
+    {
+      for(std::size_t ind=0; ind<shards->size(); ind++)
+	{
+	  shard_nodes.at(ind).clear();
+	  shard_edges.at(ind).clear();
+	}
+
+      // partition the local model (lock-free, it is owned by this worker)
+      {
+	auto& other_nodes = other->get_nodes();
+	for(auto itr=other_nodes.begin(); itr!=other_nodes.end(); itr++)
+	  {
+	    for(auto& node:itr->second)
+	      {
+		shard_nodes.at(shards->to_shard(node.get_hash())).push_back(&node);
+	      }
+	  }
+
+	auto& other_edges = other->get_edges();
+	for(auto itr=other_edges.begin(); itr!=other_edges.end(); itr++)
+	  {
+	    for(const auto& edge:itr->second)
+	      {
+		shard_edges.at(shards->to_shard(edge.get_hash())).push_back(edge);
+	      }
+	  }
+      }
+
+      std::vector<std::size_t> busy={};
+      for(std::size_t l=0; l<shards->size(); l++)
+	{
+	  std::size_t ind = (l+offset)%(shards->size());
+
+	  std::unique_lock<std::mutex> lock(shards->get_mutex(ind), std::try_to_lock);
+	  if(lock.owns_lock())
+	    {
+	      merge_shard(ind);
+	    }
+	  else
+	    {
+	      busy.push_back(ind);
+	    }
+	}
+
+      for(std::size_t ind:busy)
+	{
+	  std::scoped_lock lock(shards->get_mutex(ind));
+	  merge_shard(ind);
+	}
+    }
+
+    template<typename model_type>
+    void model_merger<model_type>::merge_shard(std::size_t ind)
+    {
+      auto shard = shards->at(ind);
+
+      auto& these_nodes = shard->get_nodes();
+      for(node_type* node:shard_nodes.at(ind))
+	{
+	  if(admission==NULL)
+	    {
+	      these_nodes.insert(*node, enforce_max_size);
+	    }
+	  else
+	    {
+	      admission->insert(these_nodes, *node, enforce_max_size);
+	    }
+	}
+
+      auto& these_edges = shard->get_edges();
+      for(const edge_type& edge:shard_edges.at(ind))
+	{
+	  if(admission==NULL)
+	    {
+	      these_edges.insert(edge, enforce_max_size);
+	    }
+	  else
+	    {
+	      admission->insert(these_edges, edge, enforce_max_size);
+	    }
+	}
+    }
+
   }
 
 }
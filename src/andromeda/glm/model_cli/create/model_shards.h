@@ -0,0 +1,213 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_MODEL_CLI_CREATE_SHARDS_H_
+#define ANDROMEDA_MODELS_GLM_MODEL_CLI_CREATE_SHARDS_H_
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Hash-partitioned final model used during create. Every node and edge
+     * lives in the shard given by the high bits of its (re-mixed) hash and
+     * each shard has its own lock, so that workers merging their local
+     * models only contend when they hit the same shard at the same time.
+     *
+     * The hashes are re-mixed before taking the high bits: `combine_hash`
+     * leaves the high bits of short keys poorly distributed, and the hash
+     * index of a shard uses the high bits of the raw hash for its buckets.
+     */
+    template<typename model_type>
+    class model_shards: public base_types
+    {
+      typedef typename model_type::node_type node_type;
+      typedef typename model_type::edge_type edge_type;
+
+    public:
+
+      model_shards(std::size_t num_shards);
+
+      std::size_t size() const { return shards.size(); }
+
+      std::size_t to_shard(hash_type hash) const;
+
+      std::shared_ptr<model_type> at(std::size_t ind) { return shards.at(ind); }
+      std::mutex& get_mutex(std::size_t ind) { return mutexes.at(ind); }
+
+      void initialise(nlohmann::json& config,
+                      std::size_t max_total_nodes,
+                      std::size_t max_total_edges);
+
+      std::size_t number_of_nodes(flvr_type flvr);
+      std::size_t number_of_nodes();
+      std::size_t number_of_edges();
+
+      double node_load_factor();
+      double edge_load_factor();
+
+      void gather(std::shared_ptr<model_type> model);
+
+    private:
+
+      std::size_t shift;
+
+      std::vector<std::shared_ptr<model_type> > shards;
+      std::vector<std::mutex> mutexes;
+    };
+
+    template<typename model_type>
+    model_shards<model_type>::model_shards(std::size_t num_shards):
+      shift(64),
+
+      shards({}),
+      mutexes(std::bit_ceil(std::max(num_shards, std::size_t(1))))
+    {
+      for(std::size_t ind=0; ind<mutexes.size(); ind++)
+        {
+          shards.push_back(std::make_shared<model_type>());
+        }
+
+      shift -= std::countr_zero(shards.size());
+    }
+
+    template<typename model_type>
+    std::size_t model_shards<model_type>::to_shard(hash_type hash) const
+    {
+      return (shift==64? 0: (utils::murmerhash3(hash) >> shift));
+    }
+
+    template<typename model_type>
+    void model_shards<model_type>::initialise(nlohmann::json& config,
+                                              std::size_t max_total_nodes,
+                                              std::size_t max_total_edges)
+    {
+      for(auto& shard:shards)
+        {
+          shard->configure(config, false);
+
+          shard->initialise(max_total_nodes/shards.size(),
+                            max_total_edges/shards.size());
+        }
+    }
+
+    template<typename model_type>
+    std::size_t model_shards<model_type>::number_of_nodes(flvr_type flvr)
+    {
+      std::size_t result=0;
+      for(std::size_t ind=0; ind<shards.size(); ind++)
+        {
+          std::scoped_lock lock(mutexes.at(ind));
+          result += (shards.at(ind)->get_nodes()).size(flvr);
+        }
+
+      return result;
+    }
+
+    template<typename model_type>
+    std::size_t model_shards<model_type>::number_of_nodes()
+    {
+      std::size_t result=0;
+      for(std::size_t ind=0; ind<shards.size(); ind++)
+        {
+          std::scoped_lock lock(mutexes.at(ind));
+          result += (shards.at(ind)->get_nodes()).size();
+        }
+
+      return result;
+    }
+
+    template<typename model_type>
+    std::size_t model_shards<model_type>::number_of_edges()
+    {
+      std::size_t result=0;
+      for(std::size_t ind=0; ind<shards.size(); ind++)
+        {
+          std::scoped_lock lock(mutexes.at(ind));
+          result += (shards.at(ind)->get_edges()).size();
+        }
+
+      return result;
+    }
+
+    template<typename model_type>
+    double model_shards<model_type>::node_load_factor()
+    {
+      double result=0;
+      for(std::size_t ind=0; ind<shards.size(); ind++)
+        {
+          std::scoped_lock lock(mutexes.at(ind));
+          result = std::max(result, (shards.at(ind)->get_nodes()).load_factor());
+        }
+
+      return result;
+    }
+
+    template<typename model_type>
+    double model_shards<model_type>::edge_load_factor()
+    {
+      double result=0;
+      for(std::size_t ind=0; ind<shards.size(); ind++)
+        {
+          std::scoped_lock lock(mutexes.at(ind));
+          result = std::max(result, (shards.at(ind)->get_edges()).load_factor());
+        }
+
+      return result;
+    }
+
+    template<typename model_type>
+    void model_shards<model_type>::gather(std::shared_ptr<model_type> model)
+    {
+      auto& these_nodes = model->get_nodes();
+      auto& these_edges = model->get_edges();
+
+      // the shards are disjoint, so we only need to look up the edges if
+      // the final model was not empty to begin with
+      bool edges_empty = (these_edges.size()==0);
+
+      for(std::size_t ind=0; ind<shards.size(); ind++)
+        {
+          std::scoped_lock lock(mutexes.at(ind));
+
+          auto& shard = shards.at(ind);
+
+          auto& other_nodes = shard->get_nodes();
+          auto& other_edges = shard->get_edges();
+
+          LOG_S(INFO) << "gathering shard " << std::setw(3) << ind << ": "
+                      << "#-nodes: " << std::setw(8) << other_nodes.size() << ", "
+                      << "#-edges: " << std::setw(8) << other_edges.size();
+
+          // every shard holds the initial token/label nodes, hence we insert
+          for(auto itr=other_nodes.begin(); itr!=other_nodes.end(); itr++)
+            {
+              for(auto& node:itr->second)
+                {
+                  these_nodes.insert(node, false);
+                }
+            }
+
+          for(auto itr=other_edges.begin(); itr!=other_edges.end(); itr++)
+            {
+              for(const auto& edge:itr->second)
+                {
+                  if(edges_empty)
+                    {
+                      these_edges.push_back(edge, true);
+                    }
+                  else
+                    {
+                      these_edges.insert(edge, false);
+                    }
+                }
+            }
+
+          shard->initialise();
+        }
+    }
+
+  }
+
+}
+
+#endif
@@ -0,0 +1,354 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_MODEL_CLI_CREATE_SPILL_H_
+#define ANDROMEDA_MODELS_GLM_MODEL_CLI_CREATE_SPILL_H_
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Out-of-core edges for create. Instead of being merged into the final
+     * model, the edges of a local model are written per flavor as a run
+     * file, sorted by (hash_i, hash_j). At the end, the runs of a flavor are
+     * k-way merged (summing the counts of equal edges) into the final model.
+     * If there are more runs than can be opened at once, they are first
+     * merged into intermediate runs.
+     */
+    template<typename model_type>
+    class model_spiller: public base_types
+    {
+      typedef typename model_type::edge_type edge_type;
+      typedef typename model_type::edges_type edges_type;
+
+      typedef typename edges_type::edge_coll_type edge_coll_type;
+
+      const static inline std::size_t MAX_FAN_IN = 256;
+      const static inline std::size_t BUFFER_SIZE = 1<<14; // #-records
+
+      struct record_type
+      {
+        hash_type hash_i;
+        hash_type hash_j;
+
+        uint64_t count;
+      };
+
+      class run_reader
+      {
+      public:
+
+        run_reader(std::filesystem::path path);
+
+        bool next(record_type& record);
+
+      private:
+
+        std::ifstream ifs;
+
+        std::vector<record_type> buffer;
+        std::size_t pos, len;
+      };
+
+    public:
+
+      model_spiller(std::filesystem::path spill_dir);
+      ~model_spiller();
+
+      std::size_t number_of_runs();
+
+      double spill(std::shared_ptr<model_type> model);
+
+      void gather(std::shared_ptr<model_type> model);
+
+    private:
+
+      std::filesystem::path next_run(flvr_type flvr, bool keep);
+
+      static bool less(const record_type& lhs, const record_type& rhs);
+
+      static void write_run(std::filesystem::path path,
+                            const std::vector<record_type>& records);
+
+      template<typename emit_type>
+      static void merge_runs(const std::vector<std::filesystem::path>& paths,
+                             emit_type emit);
+
+    private:
+
+      std::filesystem::path spill_dir;
+
+      std::mutex mtx;
+
+      std::size_t run_count;
+      std::map<flvr_type, std::vector<std::filesystem::path> > runs;
+    };
+
+    template<typename model_type>
+    model_spiller<model_type>::run_reader::run_reader(std::filesystem::path path):
+      ifs(path.c_str(), std::ios::binary),
+
+      buffer(BUFFER_SIZE),
+      pos(0),
+      len(0)
+    {
+      if(not ifs.good())
+        {
+          LOG_S(ERROR) << "can not open spill-run " << path;
+        }
+    }
+
+    template<typename model_type>
+    bool model_spiller<model_type>::run_reader::next(record_type& record)
+    {
+      if(pos==len)
+        {
+          ifs.read((char*)buffer.data(), buffer.size()*sizeof(record_type));
+
+          pos = 0;
+          len = ifs.gcount()/sizeof(record_type);
+
+          if(len==0)
+            {
+              return false;
+            }
+        }
+
+      record = buffer[pos++];
+      return true;
+    }
+
+    template<typename model_type>
+    model_spiller<model_type>::model_spiller(std::filesystem::path spill_dir):
+      spill_dir(spill_dir),
+
+      mtx(),
+
+      run_count(0),
+      runs({})
+    {
+      if(not std::filesystem::exists(spill_dir))
+        {
+          std::filesystem::create_directories(spill_dir);
+        }
+    }
+
+    template<typename model_type>
+    model_spiller<model_type>::~model_spiller()
+    {
+      for(auto& item:runs)
+        {
+          for(auto& path:item.second)
+            {
+              std::filesystem::remove(path);
+            }
+        }
+    }
+
+    template<typename model_type>
+    std::size_t model_spiller<model_type>::number_of_runs()
+    {
+      std::scoped_lock lock(mtx);
+      return run_count;
+    }
+
+    template<typename model_type>
+    std::filesystem::path model_spiller<model_type>::next_run(flvr_type flvr, bool keep)
+    {
+      std::scoped_lock lock(mtx);
+
+      std::string name = "run-" + std::to_string(run_count++) + "-" + std::to_string(flvr) + ".bin";
+      std::filesystem::path path = spill_dir / name;
+
+      if(keep)
+        {
+          runs[flvr].push_back(path);
+        }
+
+      return path;
+    }
+
+    template<typename model_type>
+    bool model_spiller<model_type>::less(const record_type& lhs, const record_type& rhs)
+    {
+      if(lhs.hash_i==rhs.hash_i)
+        {
+          return (lhs.hash_j<rhs.hash_j);
+        }
+
+      return (lhs.hash_i<rhs.hash_i);
+    }
+
+    template<typename model_type>
+    void model_spiller<model_type>::write_run(std::filesystem::path path,
+                                              const std::vector<record_type>& records)
+    {
+      std::ofstream ofs(path.c_str(), std::ios::binary);
+      ofs.write((const char*)records.data(), records.size()*sizeof(record_type));
+
+      if(not ofs.good())
+        {
+          LOG_S(ERROR) << "could not write spill-run " << path;
+        }
+    }
+
+    template<typename model_type>
+    double model_spiller<model_type>::spill(std::shared_ptr<model_type> model)
+    {
+      auto start = std::chrono::system_clock::now();
+
+      auto& edges = model->get_edges();
+
+      std::vector<record_type> records={};
+      for(auto itr=edges.begin(); itr!=edges.end(); itr++)
+        {
+          auto& coll = itr->second;
+          if(coll.size()==0)
+            {
+              continue;
+            }
+
+          records.resize(coll.size());
+
+          for(std::size_t ind=0; ind<coll.size(); ind++)
+            {
+              records[ind] = {coll.get_hash_i(ind), coll.get_hash_j(ind), coll.get_count(ind)};
+            }
+
+          std::sort(records.begin(), records.end(), less);
+
+          write_run(next_run(itr->first, true), records);
+        }
+
+      // the nodes are still merged into the final model
+      edges.reset();
+
+      auto end = std::chrono::system_clock::now();
+      std::chrono::duration<double, std::milli> delta = (end-start);
+
+      return delta.count();
+    }
+
+    template<typename model_type>
+    template<typename emit_type>
+    void model_spiller<model_type>::merge_runs(const std::vector<std::filesystem::path>& paths,
+                                               emit_type emit)
+    {
+      typedef std::pair<record_type, std::size_t> item_type;
+
+      auto greater = [](const item_type& lhs, const item_type& rhs) { return less(rhs.first, lhs.first); };
+      std::priority_queue<item_type, std::vector<item_type>, decltype(greater)> heap(greater);
+
+      std::vector<std::shared_ptr<run_reader> > readers={};
+      for(std::size_t ind=0; ind<paths.size(); ind++)
+        {
+          readers.push_back(std::make_shared<run_reader>(paths.at(ind)));
+
+          record_type record;
+          if(readers.back()->next(record))
+            {
+              heap.push({record, ind});
+            }
+        }
+
+      bool has_curr=false;
+      record_type curr;
+
+      while(not heap.empty())
+        {
+          auto [record, ind] = heap.top();
+          heap.pop();
+
+          if(has_curr and curr.hash_i==record.hash_i and curr.hash_j==record.hash_j)
+            {
+              curr.count += record.count;
+            }
+          else
+            {
+              if(has_curr)
+                {
+                  emit(curr);
+                }
+
+              curr = record;
+              has_curr = true;
+            }
+
+          if(readers.at(ind)->next(record))
+            {
+              heap.push({record, ind});
+            }
+        }
+
+      if(has_curr)
+        {
+          emit(curr);
+        }
+    }
+
+    template<typename model_type>
+    void model_spiller<model_type>::gather(std::shared_ptr<model_type> model)
+    {
+      auto& edges = model->get_edges();
+
+      for(auto& item:runs)
+        {
+          flvr_type flvr = item.first;
+          auto& paths = item.second;
+
+          LOG_S(INFO) << "merging " << paths.size() << " spill-runs of edge ["
+                      << std::setw(20) << edge_names::to_name(flvr) << "]";
+
+          // intermediate passes, so that we never open too many files
+          while(paths.size()>MAX_FAN_IN)
+            {
+              std::vector<std::filesystem::path> merged={};
+
+              for(std::size_t beg=0; beg<paths.size(); beg+=MAX_FAN_IN)
+                {
+                  std::size_t end = std::min(beg+MAX_FAN_IN, paths.size());
+                  std::vector<std::filesystem::path> chunk(paths.begin()+beg, paths.begin()+end);
+
+                  std::filesystem::path path = next_run(flvr, false);
+
+                  std::ofstream ofs(path.c_str(), std::ios::binary);
+                  merge_runs(chunk, [&ofs](const record_type& record)
+                  {
+                    ofs.write((const char*)&record, sizeof(record));
+                  });
+
+                  for(auto& tmp:chunk)
+                    {
+                      std::filesystem::remove(tmp);
+                    }
+
+                  merged.push_back(path);
+                }
+
+              paths.swap(merged);
+            }
+
+          edge_coll_type coll(flvr);
+          merge_runs(paths, [&coll](const record_type& record)
+          {
+            cnt_type count = std::min(record.count, uint64_t(std::numeric_limits<cnt_type>::max()));
+            coll.push_back(record.hash_i, record.hash_j, count);
+          });
+
+          for(auto& path:paths)
+            {
+              std::filesystem::remove(path);
+            }
+          paths.clear();
+
+          edges.merge(flvr, std::move(coll));
+        }
+
+      runs.clear();
+    }
+
+  }
+
+}
+
+#endif
@@ -0,0 +1,159 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_MODEL_CLI_CREATE_WORK_QUEUE_H_
+#define ANDROMEDA_MODELS_GLM_MODEL_CLI_CREATE_WORK_QUEUE_H_
+
+#include <condition_variable>
+#include <deque>
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Bounded multi-producer/multi-consumer queue between two stages of the
+     * create pipeline. A `push` blocks while the queue is full, so a slow
+     * stage throttles the stages in front of it. Once the queue is closed,
+     * `pop` drains the remaining items and then returns false, while `push`
+     * refuses new items (so that producers do not block on a queue that is
+     * no longer consumed).
+     *
+     * The time that producers wait on a full queue and consumers wait on an
+     * empty one is kept, it shows which stage is the bottleneck.
+     */
+    template<typename item_type>
+    class work_queue
+    {
+    public:
+
+      work_queue(std::string name, std::size_t capacity);
+
+      bool push(item_type item);
+      bool pop(item_type& item);
+
+      void close();
+
+      void log_statistics();
+
+    private:
+
+      std::string name;
+      std::size_t capacity;
+
+      std::mutex mtx;
+      std::condition_variable not_full, not_empty;
+
+      std::deque<item_type> items;
+      bool closed;
+
+      std::size_t num_items, max_size;
+      double push_wait, pop_wait; // in ms
+    };
+
+    template<typename item_type>
+    work_queue<item_type>::work_queue(std::string name, std::size_t capacity):
+      name(name),
+      capacity(std::max(std::size_t(1), capacity)),
+
+      mtx(),
+      not_full(),
+      not_empty(),
+
+      items(),
+      closed(false),
+
+      num_items(0),
+      max_size(0),
+
+      push_wait(0.0),
+      pop_wait(0.0)
+    {}
+
+    template<typename item_type>
+    bool work_queue<item_type>::push(item_type item)
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+
+      if(items.size()>=capacity and (not closed))
+        {
+          auto start = std::chrono::system_clock::now();
+          not_full.wait(lock, [this] { return ((items.size()<capacity) or closed); });
+
+          std::chrono::duration<double, std::milli> delta = std::chrono::system_clock::now()-start;
+          push_wait += delta.count();
+        }
+
+      if(closed)
+        {
+          return false;
+        }
+
+      items.push_back(std::move(item));
+
+      num_items += 1;
+      max_size = std::max(max_size, items.size());
+
+      lock.unlock();
+      not_empty.notify_one();
+
+      return true;
+    }
+
+    template<typename item_type>
+    bool work_queue<item_type>::pop(item_type& item)
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+
+      if(items.empty() and (not closed))
+        {
+          auto start = std::chrono::system_clock::now();
+          not_empty.wait(lock, [this] { return ((not items.empty()) or closed); });
+
+          std::chrono::duration<double, std::milli> delta = std::chrono::system_clock::now()-start;
+          pop_wait += delta.count();
+        }
+
+      if(items.empty())
+        {
+          return false;
+        }
+
+      item = std::move(items.front());
+      items.pop_front();
+
+      lock.unlock();
+      not_full.notify_one();
+
+      return true;
+    }
+
+    template<typename item_type>
+    void work_queue<item_type>::close()
+    {
+      {
+        std::scoped_lock lock(mtx);
+        closed = true;
+      }
+
+      not_full.notify_all();
+      not_empty.notify_all();
+    }
+
+    template<typename item_type>
+    void work_queue<item_type>::log_statistics()
+    {
+      std::scoped_lock lock(mtx);
+
+      LOG_S(INFO) << "queue [" << std::setw(10) << name << "]: "
+                  << "#-items: " << num_items << ", "
+                  << "peak-size: " << max_size << "/" << capacity << ", "
+                  << "producers blocked: " << std::fixed << std::setprecision(1)
+                  << push_wait/1000.0 << " sec, "
+                  << "consumers starved: " << pop_wait/1000.0 << " sec";
+    }
+
+  }
+
+}
+
+#endif
@@ -13,6 +13,8 @@ namespace andromeda
     template<typename model_type>
     class model_cli<DISTILL, model_type>
     {
+      typedef typename model_type::flvr_type flvr_type;
+      typedef typename model_type::hash_type hash_type;
       typedef typename model_type::index_type index_type;
 
       typedef typename model_type::node_type node_type;
@@ -31,6 +33,11 @@ namespace andromeda
       
       std::shared_ptr<model_type> distill();
 
+    private:
+
+      std::shared_ptr<model_type> distill_copy();
+      std::shared_ptr<model_type> distill_in_place();
+
     private:
 
       std::shared_ptr<model_type> old_model, new_model;
@@ -83,6 +90,17 @@ namespace andromeda
     
     template<typename model_type>
     std::shared_ptr<model_type> model_cli<DISTILL, model_type>::distill()
+    {
+      if(configuration.is_in_place())
+	{
+	  return distill_in_place();
+	}
+
+      return distill_copy();
+    }
+
+    template<typename model_type>
+    std::shared_ptr<model_type> model_cli<DISTILL, model_type>::distill_copy()
     {
       new_model = std::make_shared<model_type>(old_model->get_parameters());
       new_model->initialise();
@@ -125,7 +143,7 @@ namespace andromeda
 
         for(auto& flvr_coll:old_edges)
           {
-	    for(auto& edge:flvr_coll.second)
+	    for(const auto& edge:flvr_coll.second)
 	      {        
 		if(edge.get_count()>=configuration.get_min_edge_count() and
 		   skipping.count(edge.get_hash_i())==0 and
@@ -170,6 +188,92 @@ namespace andromeda
       return new_model;
     }
 
+    /*
+     * Distills the model without a second copy: the edges are filtered in
+     * place (in parallel over the flavors), every surviving edge marks its
+     * nodes in a bitmap per node-flavor, and the unmarked nodes are removed
+     * afterwards. The token and label nodes are always kept, as in a freshly
+     * initialised model.
+     */
+    template<typename model_type>
+    std::shared_ptr<model_type> model_cli<DISTILL, model_type>::distill_in_place()
+    {
+      typedef typename nodes_type::key_type node_key_type;
+
+      auto& nodes = old_model->get_nodes();
+      auto& edges = old_model->get_edges();
+
+      nodes.materialise();
+      edges.materialise();
+
+      std::size_t num_threads = glm_parallel::number_of_threads(configuration.get_num_threads());
+      LOG_S(INFO) << "distilling in place (#-threads: " << num_threads << ")";
+
+      std::size_t old_num_nodes = nodes.size();
+      std::size_t old_num_edges = edges.size();
+
+      std::map<flvr_type, std::vector<uint64_t> > marked={};
+      for(auto& flvr_coll:nodes)
+	{
+	  marked[flvr_coll.first] = std::vector<uint64_t>(((flvr_coll.second).size()+63)/64, 0);
+	}
+
+      auto mark = [&nodes, &marked](hash_type hash)
+      {
+	node_key_type key;
+	if(nodes.find(hash, key))
+	  {
+	    uint64_t& word = (marked.at(key.first))[key.second/64];
+	    std::atomic_ref<uint64_t>(word).fetch_or(uint64_t(1) << (key.second%64),
+						     std::memory_order_relaxed);
+	  }
+      };
+
+      for(auto name:node_names::TOKEN_NAMES)
+	{
+	  mark(node_type(node_names::WORD_TOKEN, name).get_hash());
+	}
+
+      for(auto name:node_names::LABEL_NAMES)
+	{
+	  mark(node_type(node_names::LABEL, name).get_hash());
+	}
+
+      std::size_t min_edge_count = configuration.get_min_edge_count();
+
+      edges.compact([&mark, min_edge_count](const edge_type& edge)
+      {
+	if(edge.get_count()>=min_edge_count)
+	  {
+	    mark(edge.get_hash_i());
+	    mark(edge.get_hash_j());
+
+	    return true;
+	  }
+
+	return false;
+      }, num_threads);
+
+      nodes.compact([&marked](const node_key_type& key, const node_type& node)
+      {
+	uint64_t word = (marked.at(key.first))[key.second/64];
+	return ((word >> (key.second%64)) & 1)==1;
+      }, num_threads);
+
+      LOG_S(INFO) << "old #-edges: " << old_num_edges;
+      LOG_S(INFO) << "new #-edges: " << edges.size();
+
+      LOG_S(INFO) << "old #-nodes: " << old_num_nodes;
+      LOG_S(INFO) << "new #-nodes: " << nodes.size();
+
+      {
+	old_model->finalise();
+      }
+
+      new_model = old_model;
+      return new_model;
+    }
+
   }
 
 }
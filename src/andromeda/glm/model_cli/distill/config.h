@@ -12,6 +12,9 @@ namespace andromeda
     public:
 
       const static inline std::string min_edge_count_lbl = "min-edge-count";
+
+      const static inline std::string in_place_lbl = "in-place";
+      const static inline std::string num_threads_lbl = "number-of-threads"; // 0: all cores
       
     public:
 
@@ -21,16 +24,25 @@ namespace andromeda
       void set(const nlohmann::json config);
 
       std::size_t get_min_edge_count();
+
+      bool is_in_place() { return IN_PLACE; }
+      std::size_t get_num_threads() { return NUM_THREADS; }
       
     private:
 
       nlohmann::json configuration;
       
       std::size_t MIN_EDGE_COUNT;
+
+      bool IN_PLACE;
+      std::size_t NUM_THREADS;
     };
 
     distill_config::distill_config():
-      MIN_EDGE_COUNT(2)	
+      MIN_EDGE_COUNT(2),
+
+      IN_PLACE(true),
+      NUM_THREADS(0)
     {}
 
     nlohmann::json distill_config::get()
@@ -38,6 +50,9 @@ namespace andromeda
       nlohmann::json config;
       {
 	config[min_edge_count_lbl] = MIN_EDGE_COUNT;
+
+	config[in_place_lbl] = IN_PLACE;
+	config[num_threads_lbl] = NUM_THREADS;
       }
       
       return config;
@@ -48,6 +63,9 @@ namespace andromeda
       configuration = config;
       
       MIN_EDGE_COUNT = config.value(min_edge_count_lbl, MIN_EDGE_COUNT);
+
+      IN_PLACE = config.value(in_place_lbl, IN_PLACE);
+      NUM_THREADS = config.value(num_threads_lbl, NUM_THREADS);
     }
 
     std::size_t distill_config::get_min_edge_count()
@@ -3,6 +3,9 @@
 #ifndef ANDROMEDA_MODELS_GLM_ALGOS_QUERY_FLOW_H_
 #define ANDROMEDA_MODELS_GLM_ALGOS_QUERY_FLOW_H_
 
+#include <condition_variable>
+#include <deque>
+
 namespace andromeda
 {
   namespace glm
@@ -14,6 +17,7 @@ namespace andromeda
 
       const static inline std::string name_lbl = "flow-name";
       const static inline std::string flow_lbl = "flow";
+      const static inline std::string threads_lbl = "num-threads";
 
       const static inline std::string overview_lbl = "overview";
       const static inline std::string result_lbl = "result";
@@ -55,6 +59,9 @@ namespace andromeda
 
       double time() { return delta_t.count(); }
 
+      std::size_t get_num_threads() { return num_threads; }
+      void set_num_threads(std::size_t num) { num_threads = num; }
+
       itr_type begin() { return ops.begin(); }
       itr_type end() { return ops.end(); }
 
@@ -114,6 +121,8 @@ namespace andromeda
 
       std::shared_ptr<model_type> model;
 
+      std::size_t num_threads;
+
       std::chrono::time_point<std::chrono::system_clock> t0, t1;
       std::chrono::duration<double, std::milli> delta_t;
 
@@ -126,6 +135,7 @@ namespace andromeda
     template<typename model_type>
     query_flow<model_type>::query_flow(std::shared_ptr<model_type> model):
       model(model),
+      num_threads(0),
       t0(std::chrono::system_clock::now()),
       t1(std::chrono::system_clock::now()),
       delta_t(t1-t0),
@@ -141,9 +151,10 @@ namespace andromeda
       {
 	auto& overview = result[overview_lbl];
 	overview["time"] = delta_t.count();
+	overview[threads_lbl] = glm_parallel::number_of_threads(num_threads);
 
 	const std::vector<std::string> headers
-	  = { "flid", "flop", "done", "name", "time [msec]",
+	  = { "flid", "flop", "done", "name", "start [msec]", "time [msec]",
 	      "#-nodes", "#-edges",
 	      "prob-avg", "prob-std", "prob-ent"};
 
@@ -159,7 +170,11 @@ namespace andromeda
 	      row.push_back(op->get_flid());
 	      row.push_back(to_string(op->get_flop()));
 	      row.push_back(op->is_done());
-	      row.push_back(result->get_name());	      
+	      row.push_back(result->get_name());
+
+	      // wall-clock offset with the start of the flow, to show which ops overlapped
+	      std::chrono::duration<double, std::milli> start = op->get_t0()-t0;
+	      row.push_back(std::to_string(op->is_done()? start.count(): 0.0));
 	      row.push_back(std::to_string(op->get_time()));
 
 	      row.push_back(result->get_num_nodes());
@@ -225,6 +240,8 @@ namespace andromeda
 	}
 
       this->clear();
+
+      num_threads = config.value(threads_lbl, num_threads);
       
       const nlohmann::json& flow = config[flow_lbl];
       for(std::size_t l=0; l<flow.size(); l++)
@@ -254,6 +271,7 @@ namespace andromeda
       nlohmann::json config = nlohmann::json::object({});
       {
 	config[name_lbl] = "<optional:name>";
+	config[threads_lbl] = num_threads;
 	config[flow_lbl] = nlohmann::json::array({});
       }
 
@@ -386,6 +404,19 @@ namespace andromeda
 
       clear_flow();
 
+      // the ops only use the const lookups, which see the frozen edge-flavors
+      if constexpr (std::is_const_v<model_type>)
+        {
+          if(not model->is_sealed())
+            {
+              LOG_S(WARNING) << "querying a model that is not sealed: unfrozen edges are not traversed";
+            }
+        }
+      else
+        {
+          model->seal();
+        }
+
       execute_flow();
 
       t1 = std::chrono::system_clock::now();
@@ -405,38 +436,107 @@ namespace andromeda
         }
     }
 
+    /*
+     * The ops form a DAG through their dependencies. An op is queued as soon
+     * as all its dependencies are done, and the independent ops (eg the
+     * branches of a flow before they are joined) run concurrently. The
+     * dependents of an op that fails are never executed. If an op throws,
+     * no new ops are started and the first exception is rethrown once all
+     * workers are done.
+     */
     template<typename model_type>
     void query_flow<model_type>::execute_flow()
     {
-      int itr=0, max_itr=32;//, cnt=0;
+      std::vector<std::size_t> num_deps(ops.size(), 0);
+      std::vector<std::vector<std::size_t> > dependents(ops.size());
 
-      while(itr++<max_itr)
+      std::deque<std::size_t> ready={};
+      for(std::size_t ind=0; ind<ops.size(); ind++)
         {
-          bool done = true;
-	  
-	  //LOG_S(INFO) << "itr: " << itr;	  
-	  //cnt=0;
-          for(auto& op:ops)
+          for(auto dep_id:ops.at(ind)->get_dependencies())
             {
-              if(execute_flow(op))
-                {
-                  done = false;
-                }
-
-	      //LOG_S(INFO) << "\t" << cnt++ << ": " << op->is_done();
+              dependents.at(opid_to_index.at(dep_id)).push_back(ind);
+              num_deps.at(ind) += 1;
             }
 
-          if(done)
+          if(num_deps.at(ind)==0)
             {
-              break;
+              ready.push_back(ind);
             }
         }
 
-      if(itr==max_itr)
+      std::mutex mtx;
+      std::condition_variable cv;
+
+      std::size_t running=0;
+      std::exception_ptr error=NULL;
+
+      auto worker = [&](std::size_t)
+      {
+        std::unique_lock<std::mutex> lock(mtx);
+
+        while(true)
+          {
+            cv.wait(lock, [&]() { return (ready.size()>0 or running==0 or error!=NULL); });
+
+            // nothing is queued or running anymore, or an op threw
+            if(ready.size()==0 or error!=NULL)
+              {
+                break;
+              }
+
+            std::size_t ind = ready.front();
+            ready.pop_front();
+
+            running += 1;
+            lock.unlock();
+
+            bool done=false;
+            try
+              {
+                done = execute_flow(ops.at(ind));
+              }
+            catch(...)
+              {
+                lock.lock();
+                running -= 1;
+
+                if(error==NULL)
+                  {
+                    error = std::current_exception();
+                  }
+
+                cv.notify_all();
+                break;
+              }
+
+            lock.lock();
+            running -= 1;
+
+            if(done)
+              {
+                for(std::size_t dep:dependents.at(ind))
+                  {
+                    if(--num_deps.at(dep)==0)
+                      {
+                        ready.push_back(dep);
+                      }
+                  }
+              }
+
+            cv.notify_all();
+          }
+      };
+
+      std::size_t num_workers = std::min(glm_parallel::number_of_threads(num_threads), ops.size());
+      glm_parallel::for_each(num_workers, num_workers, worker);
+
+      if(error!=NULL)
         {
-          LOG_S(WARNING) << "exceeded max iterations in `execute_flow`";
+          std::rethrow_exception(error);
         }
-      else if(not done())
+
+      if(not done())
 	{
           LOG_S(WARNING) << "could not finish executing the flow ...";
 
@@ -446,10 +546,6 @@ namespace andromeda
 	      LOG_S(INFO) << "\t" << cnt++ << ": " << op->is_done();
 	    }
 	}
-      else
-	{
-	  //LOG_S(INFO) << "executed flow!";	  
-	}
     }
 
     template<typename model_type>
@@ -474,6 +570,12 @@ namespace andromeda
 
       bool done = op->execute(nodesets);
 
+      // the dependents only read the nodeset, so it must not be normalised by them
+      if(done)
+        {
+          op->get_nodeset()->normalise(true);
+        }
+
       op->set_t1();
 
       return done;
@@ -44,7 +44,7 @@ namespace andromeda
 
     public:
 
-      query_baseop(std::shared_ptr<model_type> model_ptr,
+      query_baseop(std::shared_ptr<const model_type> model_ptr,
                    flow_op_type flop, flow_id_type flid,
 		   std::set<flow_id_type> dependencies);
 
@@ -65,10 +65,12 @@ namespace andromeda
       cnt_type get_ind_nodes() { return ind_nodes; }
       cnt_type get_ind_edges() { return ind_edges; }
       
-      std::shared_ptr<model_type> get_model() { return model_ptr; }
+      std::shared_ptr<const model_type> get_model() { return model_ptr; }
 
       double get_time() { return delta_t.count(); }
 
+      std::chrono::time_point<std::chrono::system_clock> get_t0() { return t0; }
+
       std::set<flow_id_type> get_dependencies() { return dependencies; }
 
       std::shared_ptr<flow_res_type> get_nodeset() { return nodeset; }
@@ -82,7 +84,7 @@ namespace andromeda
 
       bool done;
 
-      std::shared_ptr<model_type> model_ptr;
+      std::shared_ptr<const model_type> model_ptr;
       
       flow_op_type flop;
       flow_id_type flid;
@@ -97,7 +99,7 @@ namespace andromeda
       std::chrono::duration<double, std::milli> delta_t;
     };
 
-    query_baseop::query_baseop(std::shared_ptr<model_type> model_ptr,
+    query_baseop::query_baseop(std::shared_ptr<const model_type> model_ptr,
                                flow_op_type flop, flow_id_type flid,
 			       std::set<flow_id_type> dependencies):
       done(false),
@@ -20,11 +20,11 @@ namespace andromeda
 
     public:
 
-      query_flowop(std::shared_ptr<model_type> model,
+      query_flowop(std::shared_ptr<const model_type> model,
                    flow_id_type id, std::set<flow_id_type> dependencies,
                    const nlohmann::json& config);
 
-      query_flowop(flow_id_type id, std::shared_ptr<model_type> model,
+      query_flowop(flow_id_type id, std::shared_ptr<const model_type> model,
                    std::set<flow_id_type> source_ids, std::set<flvr_type> flavors);
 
       virtual ~query_flowop();
@@ -51,10 +51,13 @@ namespace andromeda
       std::vector<std::string> regexes;
       std::vector<pcre2_expr> exprs;
 
+      // required trigrams of each expr, empty if it can not be pre-filtered
+      std::vector<std::vector<glm_text_index::trigram_type> > expr_trigrams;
+
       flow_id_type filter_flid;
     };
 
-    query_flowop<FILTER>::query_flowop(std::shared_ptr<model_type> model,
+    query_flowop<FILTER>::query_flowop(std::shared_ptr<const model_type> model,
                                        flow_id_type flid, std::set<flow_id_type> dependencies,
                                        const nlohmann::json& config):
       query_baseop(model, NAME, flid, dependencies)
@@ -67,7 +70,7 @@ namespace andromeda
         }
     }
 
-    query_flowop<FILTER>::query_flowop(flow_id_type flid, std::shared_ptr<model_type> model,
+    query_flowop<FILTER>::query_flowop(flow_id_type flid, std::shared_ptr<const model_type> model,
                                        std::set<flow_id_type> deps,
                                        std::set<flvr_type> flavors):
       query_baseop(model, NAME, flid, deps),
@@ -145,6 +148,11 @@ namespace andromeda
               try
                 {
 		  exprs.emplace_back("filter", "", regex_item);
+
+		  std::vector<glm_text_index::trigram_type> trigrams={};
+		  glm_text_index::get_trigrams(regex_item, trigrams);
+
+		  expr_trigrams.push_back(trigrams);
                 }
               catch(std::exception& exc)
                 {
@@ -202,7 +210,7 @@ namespace andromeda
           auto& source = results.at(sid);
           for(auto itr_i=source->begin(); itr_i!=source->end(); itr_i++)
             {
-              if(nodes.get(itr_i->hash, node))
+              if(nodes.view(itr_i->hash, node))
                 {
                   if(flavors.count(node.get_flvr()))
                     {
@@ -223,6 +231,29 @@ namespace andromeda
       auto& target = results.at(query_baseop::flid);
 
       auto& nodes = query_baseop::model_ptr->get_nodes();
+      auto& index = query_baseop::model_ptr->get_text_index();
+
+      // with a text-index, an expr can only match the nodes that contain its trigrams
+      std::vector<bool> restricted(exprs.size(), false);
+      std::vector<std::vector<hash_type> > candidates(exprs.size());
+
+      if(index.is_valid(nodes))
+	{
+	  for(std::size_t l=0; l<exprs.size(); l++)
+	    {
+	      if(expr_trigrams.at(l).size()>0)
+		{
+		  index.find(expr_trigrams.at(l), candidates.at(l));
+		  restricted.at(l) = true;
+		}
+	    }
+	}
+
+      auto is_candidate = [&](std::size_t l, hash_type hash)
+      {
+	return ((not restricted.at(l)) or
+		std::binary_search(candidates.at(l).begin(), candidates.at(l).end(), hash));
+      };
 
       base_node node;
       for(auto sid:query_baseop::dependencies)
@@ -230,13 +261,24 @@ namespace andromeda
           auto& source = results.at(sid);
           for(auto itr_i=source->begin(); itr_i!=source->end(); itr_i++)
             {
-              if(nodes.get(itr_i->hash, node))
+	      bool skip=true;
+	      for(std::size_t l=0; l<exprs.size() and skip; l++)
+		{
+		  skip = not is_candidate(l, itr_i->hash);
+		}
+
+	      if(skip)
+		{
+		  continue;
+		}
+
+              if(nodes.view(itr_i->hash, node))
                 {
 		  std::string text = node.get_text(nodes, false);
 
-		  for(auto& expr:exprs)
+		  for(std::size_t l=0; l<exprs.size(); l++)
 		    {
-		      if(expr.match(text))
+		      if(is_candidate(l, itr_i->hash) and exprs.at(l).match(text))
 			{
 			  target->set(itr_i->hash, itr_i->count, itr_i->prob);
 			}
@@ -272,7 +314,7 @@ namespace andromeda
           auto& source = results.at(sid);
           for(auto itr_i=source->begin(); itr_i!=source->end(); itr_i++)
             {
-              if(nodes.get(itr_i->hash, node))
+              if(nodes.view(itr_i->hash, node))
                 {
 		  bool contains = filter->has_node(itr_i->hash);
 
@@ -281,7 +323,8 @@ namespace andromeda
 		  
 		  if(not contains)
 		    {
-		      nhashes = node.get_nodes();
+		      auto path = node.get_nodes();
+		      nhashes.assign(path.begin(), path.end());
 		    }
 
 		  if(nhashes.size()>0)
@@ -14,7 +14,7 @@ namespace andromeda
 
     public:
 
-      query_flowop(std::shared_ptr<model_type> model,
+      query_flowop(std::shared_ptr<const model_type> model,
 		   flow_id_type flid, std::set<flow_id_type> dependencies,
 		   const nlohmann::json& config);
       
@@ -31,7 +31,7 @@ namespace andromeda
       //std::set<flow_id_type> sources;
     };
 
-    query_flowop<INTERSECT>::query_flowop(std::shared_ptr<model_type> model,
+    query_flowop<INTERSECT>::query_flowop(std::shared_ptr<const model_type> model,
 					  flow_id_type flid, std::set<flow_id_type> dependencies,
 					  const nlohmann::json& config):
       query_baseop(model, NAME, flid, dependencies),
@@ -93,7 +93,7 @@ namespace andromeda
       for(auto sid:query_baseop::dependencies)
         {
           auto& source = results.at(sid);
-          source->normalise();
+          source->normalise(true);
 
           if(first)
             {
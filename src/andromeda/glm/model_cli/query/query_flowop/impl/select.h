@@ -15,22 +15,34 @@ namespace andromeda
 
       typedef query_baseop baseop_type;
 
+      // select by prefix, case-folded or fuzzy match of the words (needs `IO.load.term-index`)
+      const static inline std::string lookup_lbl = "lookup";
+      const static inline std::string words_lbl = "words";
+
+      const static inline std::string folded_lbl = "case-folded";
+      const static inline std::string distance_lbl = "max-distance";
+      const static inline std::string results_lbl = "max-results";
+
+      const static inline std::string prefix_lbl = "prefix";
+      const static inline std::string caseless_lbl = "caseless";
+      const static inline std::string fuzzy_lbl = "fuzzy";
+
     public:
 
-      query_flowop(std::shared_ptr<model_type> model,
+      query_flowop(std::shared_ptr<const model_type> model,
 		   flow_id_type id, std::set<flow_id_type> dependencies,
 		   const nlohmann::json& config);
       
-      query_flowop(flow_id_type id, std::shared_ptr<model_type> model,
+      query_flowop(flow_id_type id, std::shared_ptr<const model_type> model,
                    const std::vector<std::vector<std::string> >& paths);
 
-      query_flowop(flow_id_type id, std::shared_ptr<model_type> model,
+      query_flowop(flow_id_type id, std::shared_ptr<const model_type> model,
                    const glm_node_type& node);
 
-      query_flowop(flow_id_type id, std::shared_ptr<model_type> model,
+      query_flowop(flow_id_type id, std::shared_ptr<const model_type> model,
                    std::vector<glm_node_type>& nodes);
 
-      query_flowop(flow_id_type id, std::shared_ptr<model_type> model,
+      query_flowop(flow_id_type id, std::shared_ptr<const model_type> model,
                    std::vector<qry_node_type>& nodes);
 
       virtual ~query_flowop();
@@ -43,19 +55,34 @@ namespace andromeda
     private:
       
       bool set_hashes_from_nodes();
+
+      bool set_hashes_from_lookup();
       
     private:
 
       std::vector<std::vector<std::string> > nodes;           
       std::vector<std::pair<hash_type, val_type> > hashes;      
+
+      std::string lookup;
+      std::vector<std::string> words;
+
+      bool case_folded;
+      std::size_t max_distance, max_results;
     };
 
-    query_flowop<SELECT>::query_flowop(std::shared_ptr<model_type> model,
+    query_flowop<SELECT>::query_flowop(std::shared_ptr<const model_type> model,
 				       flow_id_type flid, std::set<flow_id_type> dependencies,
 				       const nlohmann::json& config):
       query_baseop(model, NAME, flid, dependencies),
       nodes({}),
-      hashes({})
+      hashes({}),
+
+      lookup(""),
+      words({}),
+
+      case_folded(false),
+      max_distance(1),
+      max_results(100)
     {
       if((not config.is_null()) and
 	 (not from_config(config)))
@@ -71,7 +98,16 @@ namespace andromeda
 
       nlohmann::json& params = config.at(parameters_lbl);
       {
-	if(nodes.size()>0 or (nodes.size()==0 and hashes.size()==0))
+	if(lookup.size()>0)
+	  {
+	    params[lookup_lbl] = lookup;
+	    params[words_lbl] = words;
+
+	    params[folded_lbl] = case_folded;
+	    params[distance_lbl] = max_distance;
+	    params[results_lbl] = max_results;
+	  }
+	else if(nodes.size()>0 or (nodes.size()==0 and hashes.size()==0))
 	  {
 	    params["nodes"] = nodes;
 	  }
@@ -102,6 +138,35 @@ namespace andromeda
       nodes.clear();
       hashes.clear();
 
+      lookup = "";
+      words.clear();
+
+      if(params.count(lookup_lbl))
+	{
+	  try
+	    {
+	      lookup = params.value(lookup_lbl, lookup);
+	      words = params.value(words_lbl, words);
+
+	      case_folded = params.value(folded_lbl, case_folded);
+	      max_distance = params.value(distance_lbl, max_distance);
+	      max_results = params.value(results_lbl, max_results);
+	    }
+	  catch(std::exception& exc)
+	    {
+	      LOG_S(WARNING) << exc.what();
+	      return false;
+	    }
+
+	  if(lookup!=prefix_lbl and lookup!=caseless_lbl and lookup!=fuzzy_lbl)
+	    {
+	      LOG_S(ERROR) << "unrecognised select lookup: " << lookup;
+	      return false;
+	    }
+
+	  return true;
+	}
+
       try
 	{
 	  hashes = params.value("hashes", hashes);
@@ -129,27 +194,51 @@ namespace andromeda
       return true;
     }
     
-    query_flowop<SELECT>::query_flowop(flow_id_type flid, std::shared_ptr<model_type> model,
+    query_flowop<SELECT>::query_flowop(flow_id_type flid, std::shared_ptr<const model_type> model,
                                        const std::vector<std::vector<std::string> >& nodes):
       query_baseop(model, NAME, flid, {}),
-      nodes(nodes)
+      nodes(nodes),
+      hashes({}),
+
+      lookup(""),
+      words({}),
+
+      case_folded(false),
+      max_distance(1),
+      max_results(100)
     {}
 
     query_flowop<SELECT>::query_flowop(flow_id_type flid,
-                                       std::shared_ptr<model_type> model,
+                                       std::shared_ptr<const model_type> model,
                                        const glm_node_type& node):
       query_baseop(model, NAME, flid, {}),
-      nodes({})
+      nodes({}),
+      hashes({}),
+
+      lookup(""),
+      words({}),
+
+      case_folded(false),
+      max_distance(1),
+      max_results(100)
     {
       hashes.clear();
       hashes.emplace_back(node.get_hash(), 1.0);
     }
 
     query_flowop<SELECT>::query_flowop(flow_id_type flid,
-                                       std::shared_ptr<model_type> model,
+                                       std::shared_ptr<const model_type> model,
                                        std::vector<glm_node_type>& nodes):
       query_baseop(model, NAME, flid, {}),
-      nodes({})
+      nodes({}),
+      hashes({}),
+
+      lookup(""),
+      words({}),
+
+      case_folded(false),
+      max_distance(1),
+      max_results(100)
     {
       hashes.clear();
       for(auto& node:nodes)
@@ -159,10 +248,18 @@ namespace andromeda
     }
 
     query_flowop<SELECT>::query_flowop(flow_id_type flid,
-                                       std::shared_ptr<model_type> model,
+                                       std::shared_ptr<const model_type> model,
                                        std::vector<qry_node_type>& nodes):
       query_baseop(model, NAME, flid, {}),
-      nodes({})
+      nodes({}),
+      hashes({}),
+
+      lookup(""),
+      words({}),
+
+      case_folded(false),
+      max_distance(1),
+      max_results(100)
     {
       hashes.clear();
       for(auto& node:nodes)
@@ -176,7 +273,15 @@ namespace andromeda
     
     bool query_flowop<SELECT>::execute(results_type& results)
     {
-      if(nodes.size()>0 and hashes.size()==0)
+      if(lookup.size()>0 and hashes.size()==0)
+	{
+	  if(not set_hashes_from_lookup())
+	    {
+	      baseop_type::done = false;
+	      return baseop_type::done;
+	    }
+	}
+      else if(nodes.size()>0 and hashes.size()==0)
 	{
 	  if(not set_hashes_from_nodes())
 	    {
@@ -265,6 +370,54 @@ namespace andromeda
       return (hashes.size()>0);
     }
     
+    /*
+     * The matches within an edit distance d get a weight 1/(1+d), so the
+     * closest matches dominate the normalised selection.
+     */
+    bool query_flowop<SELECT>::set_hashes_from_lookup()
+    {
+      if(model_ptr==NULL)
+	{
+	  return false;
+	}
+
+      auto& index = model_ptr->get_term_index();
+      if(not index.is_valid(model_ptr->get_nodes()))
+	{
+	  LOG_S(WARNING) << "no term-index to select by " << lookup
+			 << ": set `IO.load.term-index` to true";
+	  return false;
+	}
+
+      hashes.clear();
+
+      std::vector<glm_term_index::match_type> matches={};
+      for(const std::string& word:words)
+	{
+	  matches.clear();
+
+	  if(lookup==prefix_lbl)
+	    {
+	      index.find_prefix(word, case_folded, max_results, matches);
+	    }
+	  else if(lookup==caseless_lbl)
+	    {
+	      index.find_caseless(word, max_results, matches);
+	    }
+	  else if(lookup==fuzzy_lbl)
+	    {
+	      index.find_fuzzy(word, case_folded, max_distance, max_results, matches);
+	    }
+
+	  for(auto& match:matches)
+	    {
+	      hashes.emplace_back(match.first, 1.0/(1.0+match.second));
+	    }
+	}
+
+      return (hashes.size()>0);
+    }
+
   }
 
 }
@@ -17,12 +17,12 @@ namespace andromeda
 
     public:
 
-      query_flowop(std::shared_ptr<model_type> model,
+      query_flowop(std::shared_ptr<const model_type> model,
                    flow_id_type flid, std::set<flow_id_type> dependencies,
                    const nlohmann::json& config);
 
       query_flowop(flow_id_type flid,
-		   std::shared_ptr<model_type> model,                   
+		   std::shared_ptr<const model_type> model,                   
 		   std::set<flow_id_type> dependencies,
 		   bool dynamic_expansion,
 		   std::set<flvr_type> edge_flvrs);
@@ -40,7 +40,7 @@ namespace andromeda
       std::set<flvr_type> edge_flvrs;      
     };
 
-    query_flowop<SUBGRAPH>::query_flowop(std::shared_ptr<model_type> model,
+    query_flowop<SUBGRAPH>::query_flowop(std::shared_ptr<const model_type> model,
                                          flow_id_type flid,
 					 std::set<flow_id_type> dependencies,
                                          const nlohmann::json& config):
@@ -55,7 +55,7 @@ namespace andromeda
     }
 
     query_flowop<SUBGRAPH>::query_flowop(flow_id_type flid,
-					 std::shared_ptr<model_type> model,
+					 std::shared_ptr<const model_type> model,
 					 std::set<flow_id_type> dependencies,
 					 bool dynamic_expansion,
 					 std::set<flvr_type> edge_flvrs):
@@ -145,10 +145,7 @@ namespace andromeda
 	{
 	  for(flvr_type flvr:edge_flvrs)
 	    {
-	      std::vector<base_edge> bedges={};
-	      edges.traverse(flvr, node_itr->hash, bedges, false);
-	      
-	      for(const auto& bedge:bedges)
+	      for(const auto bedge:edges.traverse(flvr, node_itr->hash))
 		{
 		  if(target->has_node(bedge.get_hash_i())==1 and
 		     target->has_node(bedge.get_hash_j())==1)
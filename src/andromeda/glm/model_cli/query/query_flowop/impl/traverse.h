@@ -19,11 +19,11 @@ namespace andromeda
 
     public:
 
-      query_flowop(std::shared_ptr<model_type> model,
+      query_flowop(std::shared_ptr<const model_type> model,
 		   flow_id_type flid, std::set<flow_id_type> dependencies,
 		   const nlohmann::json& config);
 
-      query_flowop(std::shared_ptr<model_type> model,
+      query_flowop(std::shared_ptr<const model_type> model,
 		   flow_id_type flid, std::set<flow_id_type> dependencies,
 		   flvr_type edge_type);
 
@@ -39,7 +39,7 @@ namespace andromeda
       flvr_type edge_flavor;
     };
 
-    query_flowop<TRAVERSE>::query_flowop(std::shared_ptr<model_type> model,
+    query_flowop<TRAVERSE>::query_flowop(std::shared_ptr<const model_type> model,
 					 flow_id_type flid, std::set<flow_id_type> dependencies,
 					 const nlohmann::json& config):
       query_baseop(model, NAME, flid, dependencies),
@@ -52,7 +52,7 @@ namespace andromeda
 	}
     }
 
-    query_flowop<TRAVERSE>::query_flowop(std::shared_ptr<model_type> model,
+    query_flowop<TRAVERSE>::query_flowop(std::shared_ptr<const model_type> model,
 					 flow_id_type flid, std::set<flow_id_type> dependencies,
 					 flvr_type edge_flavor):
       query_baseop(model, NAME, flid, dependencies),
@@ -109,14 +109,11 @@ namespace andromeda
       for(auto sid:baseop_type::dependencies)
 	{      
 	  auto& source = results.at(sid);	  
-	  source->normalise();
+	  source->normalise(true);
 	  
 	  for(auto itr=source->begin(); itr!=source->end(); itr++)      
 	    {
-	      std::vector<typename model_type::edge_type> _edges;
-	      edges.traverse(edge_flavor, itr->hash, _edges, true);
-	      
-	      for(auto& _edge:_edges)
+	      for(const auto _edge:edges.traverse(edge_flavor, itr->hash))
 		{
 		  target->add(_edge.get_hash_j(), _edge.get_count(), (itr->prob)*_edge.get_prob());
 		}
@@ -18,11 +18,11 @@ namespace andromeda
 
     public:
 
-      query_flowop(std::shared_ptr<model_type> model,
+      query_flowop(std::shared_ptr<const model_type> model,
 		   flow_id_type flid, std::set<flow_id_type> dependencies,
 		   const nlohmann::json& config);
       
-      query_flowop(flow_id_type id, std::shared_ptr<model_type> model,
+      query_flowop(flow_id_type id, std::shared_ptr<const model_type> model,
 		   flow_id_type source_id);
 
       virtual ~query_flowop();
@@ -37,7 +37,7 @@ namespace andromeda
       flow_id_type source_id;
     };
 
-    query_flowop<UNIFORM>::query_flowop(std::shared_ptr<model_type> model,
+    query_flowop<UNIFORM>::query_flowop(std::shared_ptr<const model_type> model,
 					flow_id_type flid, std::set<flow_id_type> dependencies,
 					const nlohmann::json& config):
       query_baseop(model, NAME, flid, dependencies)
@@ -80,7 +80,7 @@ namespace andromeda
       return true;      
     }
     
-    query_flowop<UNIFORM>::query_flowop(flow_id_type flid, std::shared_ptr<model_type> model,
+    query_flowop<UNIFORM>::query_flowop(flow_id_type flid, std::shared_ptr<const model_type> model,
 					flow_id_type source_id):
       query_baseop(model, NAME, flid, {source_id}),
       source_id(source_id)
@@ -7,7 +7,7 @@ namespace andromeda
 {
   namespace glm
   {
-    std::shared_ptr<query_baseop> to_flowop(std::shared_ptr<model> model_ptr,
+    std::shared_ptr<query_baseop> to_flowop(std::shared_ptr<const model> model_ptr,
 					    typename query_baseop::flow_op_type flop,
 					    typename query_baseop::flow_id_type flid,
 					    std::set<typename query_baseop::flow_id_type> deps,
@@ -79,7 +79,7 @@ namespace andromeda
     }
     
     std::shared_ptr<query_baseop> to_flowop(const nlohmann::json& config,
-					    std::shared_ptr<model> model_ptr)
+					    std::shared_ptr<const model> model_ptr)
     {
       typedef query_baseop::flow_op_type flow_op_type;
       typedef query_baseop::flow_id_type flow_id_type;
@@ -38,7 +38,7 @@ namespace andromeda
 
     public:
 
-      query_result(std::shared_ptr<model_type> model);
+      query_result(std::shared_ptr<const model_type> model);
 
       nlohmann::json to_json();
 
@@ -97,7 +97,7 @@ namespace andromeda
 
     private:
 
-      std::shared_ptr<model_type> model;
+      std::shared_ptr<const model_type> model;
 
       std::string name, description;
 
@@ -114,7 +114,7 @@ namespace andromeda
     };
 
     template<typename model_type>
-    query_result<model_type>::query_result(std::shared_ptr<model_type> model):
+    query_result<model_type>::query_result(std::shared_ptr<const model_type> model):
       model(model),
 
       normalised(false),
@@ -181,7 +181,7 @@ namespace andromeda
                 {
                   auto row = nlohmann::json::array();
 
-                  if(nodes.get(qnode.hash, node))
+                  if(nodes.view(qnode.hash, node))
                     {
                       row.push_back(node.get_flvr());
                       row.push_back(node.get_name());
@@ -278,7 +278,7 @@ namespace andromeda
       base_node node;
       for(auto& qnode:query_nodes)
         {
-          if(nodes.get(qnode.hash, node))
+          if(nodes.view(qnode.hash, node))
             {
               std::vector<std::string> row = { "node", node_names::to_name(node.get_flvr()),
                                                std::to_string(qnode.count),
@@ -335,7 +335,7 @@ namespace andromeda
       for(auto& _:this->query_nodes)
         {
           glm_node_type node;
-          if(model_nodes.get(_.hash, node))
+          if(model_nodes.view(_.hash, node))
             {
               new_nodes.push_back(node);
             }
@@ -516,6 +516,7 @@ namespace andromeda
 
       if(query_nodes.size()==0)
         {
+          normalised=true;
           return;
         }
 
@@ -0,0 +1,788 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_MODEL_CLI_SERVE_H_
+#define ANDROMEDA_MODELS_GLM_MODEL_CLI_SERVE_H_
+
+#include <csignal>
+#include <list>
+
+#include <andromeda/glm/model_cli/serve/config.h>
+#include <andromeda/glm/model_cli/serve/socket.h>
+#include <andromeda/glm/model_cli/serve/metrics.h>
+#include <andromeda/glm/model_cli/serve/pool.h>
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Long-running query server. The model is loaded once and shared as a
+     * read-only snapshot by a pool of workers. Every line that a client
+     * sends is a request, and every request gets exactly one line back:
+     *
+     *  - a query-flow (the format of `query_flow::from_config`),
+     *  - a batch of query-flows, as an array or as `{"queries": [...]}`,
+     *    which are executed concurrently against the same snapshot,
+     *  - a command: `{"command": "statistics"|"reload"|"shutdown"}`.
+     *
+     * If a watch-directory is configured, a new model that appears in it
+     * (a sub-directory with the files written by `model_op<SAVE>`) is
+     * loaded in the background and swapped in. Requests in flight finish
+     * on the snapshot they started with, which is released afterwards.
+     * Models must be saved into new directories: a memory-mapped model
+     * can not be overwritten in place while it is served.
+     */
+    template<typename model_type>
+    class model_cli<SERVE, model_type>
+    {
+      typedef model_cli<SERVE, model_type> this_type;
+
+      typedef query_flow<const model_type> qflow_type;
+
+      typedef std::chrono::time_point<std::chrono::system_clock> time_type;
+
+      // the newest write-time and total size of the files of a model
+      typedef std::pair<std::filesystem::file_time_type, std::uintmax_t> signature_type;
+
+      const static inline std::string command_lbl = "command";
+
+      const static inline std::string statistics_cmd = "statistics";
+      const static inline std::string reload_cmd = "reload";
+      const static inline std::string shutdown_cmd = "shutdown";
+
+      const static inline std::string queries_lbl = "queries";
+      const static inline std::string results_lbl = "results";
+
+      const static inline std::string success_lbl = "success";
+      const static inline std::string error_lbl = "error";
+
+      const static inline std::string model_lbl = "model";
+      const static inline std::string root_lbl = io_base::root_lbl;
+      const static inline std::string generation_lbl = "generation";
+
+      const static inline std::string metrics_lbl = "metrics";
+      const static inline std::string threads_lbl = "number-of-threads";
+
+    public:
+
+      model_cli(std::shared_ptr<model_type> model);
+
+      model_cli(std::shared_ptr<model_type> model,
+                nlohmann::json config);
+
+      ~model_cli();
+
+      nlohmann::json to_config();
+
+      void serve();
+
+      // the snapshot and the pool, without a socket (eg to answer requests in-process)
+      bool start();
+      void stop();
+
+      // one request-line in, one response out
+      nlohmann::json execute(const std::string& line);
+
+      // executes `query` with `qflow`, or the ops that are already in `qflow` if `query` is null
+      std::future<nlohmann::json> submit(std::shared_ptr<qflow_type> qflow,
+                                         const nlohmann::json& query);
+
+    private:
+
+      static void on_signal(int signal);
+
+      std::shared_ptr<const model_type> get_snapshot(nlohmann::json& info);
+
+      void handle(int fd);
+
+      nlohmann::json execute_command(const nlohmann::json& request);
+
+      nlohmann::json execute_batch(const nlohmann::json& queries);
+
+      std::future<nlohmann::json> submit(std::shared_ptr<const model_type> snapshot,
+                                         const nlohmann::json& query);
+
+      static nlohmann::json to_error(std::string error);
+
+      void watch();
+
+      bool reload(std::filesystem::path path);
+
+      static bool get_signature(std::filesystem::path path, signature_type& signature);
+
+    private:
+
+      // set by SIGINT and SIGTERM
+      static inline std::atomic<bool> interrupted = false;
+
+      std::shared_ptr<model_type> model_ptr;
+
+      nlohmann::json config;
+      serve_config configuration;
+
+      std::atomic<bool> running;
+
+      std::shared_ptr<serve_pool> pool;
+      serve_metrics metrics;
+
+      std::mutex reload_mtx, snapshot_mtx;
+
+      std::shared_ptr<const model_type> snapshot;
+      std::filesystem::path snapshot_path;
+      std::filesystem::file_time_type snapshot_time;
+      std::size_t generation;
+    };
+
+    template<typename model_type>
+    model_cli<SERVE, model_type>::model_cli(std::shared_ptr<model_type> model_ptr):
+      model_ptr(model_ptr),
+
+      config(nlohmann::json::object({})),
+      configuration(),
+
+      running(false),
+
+      pool(NULL),
+      metrics(),
+
+      snapshot(NULL),
+      snapshot_path(),
+      snapshot_time(std::filesystem::file_time_type::min()),
+      generation(0)
+    {}
+
+    template<typename model_type>
+    model_cli<SERVE, model_type>::model_cli(std::shared_ptr<model_type> model_ptr,
+                                            nlohmann::json config):
+      model_ptr(model_ptr),
+
+      config(config),
+      configuration(config),
+
+      running(false),
+
+      pool(NULL),
+      metrics(),
+
+      snapshot(NULL),
+      snapshot_path(),
+      snapshot_time(std::filesystem::file_time_type::min()),
+      generation(0)
+    {}
+
+    template<typename model_type>
+    model_cli<SERVE, model_type>::~model_cli()
+    {
+      stop();
+    }
+
+    template<typename model_type>
+    nlohmann::json model_cli<SERVE, model_type>::to_config()
+    {
+      nlohmann::json config = configuration.to_json();
+
+      {
+        nlohmann::json item = model_op<LOAD>::to_config();
+        config.merge_patch(item);
+      }
+
+      return config;
+    }
+
+    template<typename model_type>
+    void model_cli<SERVE, model_type>::on_signal(int signal)
+    {
+      interrupted = true;
+    }
+
+    /*
+     * Serves the (loaded) model until a `shutdown` command or a SIGINT or
+     * SIGTERM. Every client connection is read by its own thread, while
+     * the query-flows run on the pool.
+     */
+    template<typename model_type>
+    void model_cli<SERVE, model_type>::serve()
+    {
+      if(not start())
+        {
+          return;
+        }
+
+      serve_socket socket;
+      if(not socket.open(configuration.socket_path, configuration.port))
+        {
+          stop();
+          return;
+        }
+
+      interrupted = false;
+
+      auto sigint = std::signal(SIGINT, &this_type::on_signal);
+      auto sigterm = std::signal(SIGTERM, &this_type::on_signal);
+
+      std::thread watcher;
+      if(configuration.watch_dir!="")
+        {
+          watcher = std::thread(&this_type::watch, this);
+        }
+
+      LOG_S(INFO) << "serving " << snapshot_path << " on " << socket.get_address()
+                  << " with " << pool->size() << " threads";
+
+      // the connections, with a flag that is set once the client is done
+      std::list<std::pair<std::thread, std::shared_ptr<std::atomic<bool> > > > clients={};
+
+      while(running and (not interrupted))
+        {
+          int fd = socket.accept(250);
+
+          for(auto itr=clients.begin(); itr!=clients.end(); )
+            {
+              if(*(itr->second))
+                {
+                  (itr->first).join();
+                  itr = clients.erase(itr);
+                }
+              else
+                {
+                  itr++;
+                }
+            }
+
+          if(fd<0)
+            {
+              continue;
+            }
+
+          auto done = std::make_shared<std::atomic<bool> >(false);
+          clients.emplace_back(std::thread([this, fd, done]()
+          {
+            handle(fd);
+            *done = true;
+          }), done);
+        }
+
+      LOG_S(INFO) << "shutting down the server ...";
+
+      running = false;
+      socket.close();
+
+      for(auto& client:clients)
+        {
+          (client.first).join();
+        }
+
+      if(watcher.joinable())
+        {
+          watcher.join();
+        }
+
+      stop();
+
+      std::signal(SIGINT, sigint);
+      std::signal(SIGTERM, sigterm);
+
+      LOG_S(INFO) << "served requests: " << metrics.to_json().dump();
+    }
+
+    template<typename model_type>
+    bool model_cli<SERVE, model_type>::start()
+    {
+      {
+        std::scoped_lock lock(snapshot_mtx);
+
+        snapshot = model_type::snapshot(model_ptr);
+        model_ptr = NULL;
+
+        if(config.count(io_base::io_lbl) and
+           config[io_base::io_lbl].count(io_base::load_lbl))
+          {
+            std::string root = config[io_base::io_lbl][io_base::load_lbl].value(root_lbl, "");
+            snapshot_path = root;
+          }
+
+        signature_type signature;
+        if(get_signature(snapshot_path, signature))
+          {
+            snapshot_time = signature.first;
+          }
+      }
+
+      if(snapshot==NULL)
+        {
+          LOG_S(ERROR) << "no model to serve ...";
+          return false;
+        }
+
+      std::size_t num_threads = glm_parallel::number_of_threads(configuration.num_threads);
+      std::size_t capacity = std::max(configuration.max_batch_size, 4*num_threads);
+
+      pool = std::make_shared<serve_pool>(num_threads, capacity);
+
+      running = true;
+
+      return true;
+    }
+
+    /*
+     * Finishes the pending query-flows, new requests are answered with an
+     * error afterwards.
+     */
+    template<typename model_type>
+    void model_cli<SERVE, model_type>::stop()
+    {
+      running = false;
+
+      if(pool!=NULL)
+        {
+          pool->stop();
+        }
+    }
+
+    template<typename model_type>
+    std::shared_ptr<const model_type> model_cli<SERVE, model_type>::get_snapshot(nlohmann::json& info)
+    {
+      std::scoped_lock lock(snapshot_mtx);
+
+      info = nlohmann::json::object({});
+      info[root_lbl] = snapshot_path.string();
+      info[generation_lbl] = generation;
+
+      return snapshot;
+    }
+
+    template<typename model_type>
+    void model_cli<SERVE, model_type>::handle(int fd)
+    {
+      serve_connection connection(fd);
+
+      std::string line;
+      while(running and (not interrupted))
+        {
+          int status = connection.read_line(line, 250, configuration.max_request_size);
+
+          if(status<0)
+            {
+              break;
+            }
+          else if(status==0 or line.find_first_not_of(" \t\r")==std::string::npos)
+            {
+              continue;
+            }
+
+          nlohmann::json result = execute(line);
+
+          if(not connection.write_line(result.dump()))
+            {
+              break;
+            }
+        }
+    }
+
+    template<typename model_type>
+    nlohmann::json model_cli<SERVE, model_type>::execute(const std::string& line)
+    {
+      nlohmann::json request = nlohmann::json::parse(line, nullptr, false);
+
+      if(request.is_discarded())
+        {
+          return to_error("could not parse the request as JSON");
+        }
+      else if(request.is_object() and request.count(command_lbl))
+        {
+          return execute_command(request);
+        }
+      else if(request.is_array())
+        {
+          return execute_batch(request);
+        }
+      else if(request.is_object() and request.count(queries_lbl))
+        {
+          return execute_batch(request.at(queries_lbl));
+        }
+      else if(request.is_object() and request.count(qflow_type::flow_lbl))
+        {
+          nlohmann::json info;
+          auto snapshot = get_snapshot(info);
+
+          auto future = submit(snapshot, request);
+          if(not future.valid())
+            {
+              return to_error("the server is shutting down");
+            }
+
+          nlohmann::json result = future.get();
+          result[model_lbl] = info;
+
+          return result;
+        }
+
+      return to_error("the request is neither a query-flow, a batch nor a command");
+    }
+
+    template<typename model_type>
+    nlohmann::json model_cli<SERVE, model_type>::execute_command(const nlohmann::json& request)
+    {
+      std::string command = request.value(command_lbl, "");
+
+      nlohmann::json result = nlohmann::json::object({});
+      result[success_lbl] = true;
+
+      if(command==statistics_cmd)
+        {
+          result[metrics_lbl] = metrics.to_json();
+          result[threads_lbl] = (pool!=NULL? pool->size():0);
+        }
+      else if(command==reload_cmd)
+        {
+          nlohmann::json info;
+          get_snapshot(info);
+
+          // the current model, unless another one is given
+          std::string root = request.value(root_lbl, info[root_lbl].get<std::string>());
+          result[success_lbl] = reload(root);
+        }
+      else if(command==shutdown_cmd)
+        {
+          running = false;
+        }
+      else
+        {
+          return to_error("unknown command `"+command+"`: use `"+statistics_cmd+"`, `"
+                          +reload_cmd+"` or `"+shutdown_cmd+"`");
+        }
+
+      nlohmann::json info;
+      get_snapshot(info);
+
+      result[model_lbl] = info;
+
+      return result;
+    }
+
+    /*
+     * All query-flows of a batch see the same snapshot, even if a reload
+     * happens while the batch is executed.
+     */
+    template<typename model_type>
+    nlohmann::json model_cli<SERVE, model_type>::execute_batch(const nlohmann::json& queries)
+    {
+      auto t0 = std::chrono::system_clock::now();
+
+      if(not queries.is_array())
+        {
+          return to_error("`"+queries_lbl+"` needs to be an array of query-flows");
+        }
+      else if(queries.size()>configuration.max_batch_size)
+        {
+          return to_error("the batch exceeds the maximum of "
+                          +std::to_string(configuration.max_batch_size)+" query-flows");
+        }
+
+      nlohmann::json info;
+      auto snapshot = get_snapshot(info);
+
+      std::vector<std::future<nlohmann::json> > futures={};
+      for(const auto& query:queries)
+        {
+          futures.push_back(submit(snapshot, query));
+        }
+
+      nlohmann::json result = nlohmann::json::object({});
+      result[success_lbl] = true;
+
+      auto& results = result[results_lbl];
+      results = nlohmann::json::array({});
+
+      for(auto& future:futures)
+        {
+          nlohmann::json item = (future.valid()? future.get():to_error("the server is shutting down"));
+
+          result[success_lbl] = (result[success_lbl].get<bool>() and item.value(success_lbl, false));
+          results.push_back(item);
+        }
+
+      metrics.add_batch();
+
+      std::chrono::duration<double, std::milli> delta_t = std::chrono::system_clock::now()-t0;
+
+      result[model_lbl] = info;
+      result[metrics_lbl][serve_metrics::total_lbl] = delta_t.count();
+
+      return result;
+    }
+
+    template<typename model_type>
+    std::future<nlohmann::json> model_cli<SERVE, model_type>::submit(std::shared_ptr<const model_type> snapshot,
+                                                                     const nlohmann::json& query)
+    {
+      return submit(std::make_shared<qflow_type>(snapshot), query);
+    }
+
+    /*
+     * The query-flows run with at most `flow-threads` threads each, on top
+     * of the threads of the pool. Without a cap, a flow that asks for all
+     * cores (the default of `num-threads`) on every worker oversubscribes
+     * the machine quadratically. Whatever a flow throws is turned into an
+     * error response, so every request gets an answer.
+     */
+    template<typename model_type>
+    std::future<nlohmann::json> model_cli<SERVE, model_type>::submit(std::shared_ptr<qflow_type> qflow,
+                                                                     const nlohmann::json& query)
+    {
+      if(pool==NULL)
+        {
+          return std::future<nlohmann::json>();
+        }
+
+      time_type t0 = std::chrono::system_clock::now();
+
+      std::size_t max_threads = configuration.flow_threads;
+
+      return pool->submit([this, qflow, query, max_threads, t0]()
+      {
+        time_type t1 = std::chrono::system_clock::now();
+
+        nlohmann::json result = nlohmann::json::object({});
+
+        bool success=false;
+        try
+          {
+            if(query.is_null() or qflow->from_config(query))
+              {
+                std::size_t num_threads = qflow->get_num_threads();
+                if(max_threads>0 and (num_threads==0 or num_threads>max_threads))
+                  {
+                    qflow->set_num_threads(max_threads);
+                  }
+
+                success = qflow->execute();
+              }
+
+            if(success)
+              {
+                result = qflow->to_json();
+              }
+            else
+              {
+                result[error_lbl] = "could not execute the query-flow";
+              }
+          }
+        catch(std::exception& exc)
+          {
+            LOG_S(ERROR) << "query-flow failed: " << exc.what();
+
+            success = false;
+            result = nlohmann::json::object({});
+            result[error_lbl] = exc.what();
+          }
+        catch(...)
+          {
+            LOG_S(ERROR) << "query-flow failed with an unknown exception";
+
+            success = false;
+            result = nlohmann::json::object({});
+            result[error_lbl] = "unknown exception while executing the query-flow";
+          }
+
+        time_type t2 = std::chrono::system_clock::now();
+
+        std::chrono::duration<double, std::milli> queue_time = t1-t0;
+        std::chrono::duration<double, std::milli> execute_time = t2-t1;
+
+        metrics.add_request(success, queue_time.count(), execute_time.count());
+
+        result[success_lbl] = success;
+
+        auto& item = result[metrics_lbl];
+        {
+          item[serve_metrics::queue_lbl] = queue_time.count();
+          item[serve_metrics::execute_lbl] = execute_time.count();
+          item[serve_metrics::total_lbl] = queue_time.count()+execute_time.count();
+        }
+
+        return result;
+      });
+    }
+
+    template<typename model_type>
+    nlohmann::json model_cli<SERVE, model_type>::to_error(std::string error)
+    {
+      nlohmann::json result = nlohmann::json::object({});
+
+      result[success_lbl] = false;
+      result[error_lbl] = error;
+
+      return result;
+    }
+
+    /*
+     * Polls the watch-directory for the newest complete model. A model is
+     * only loaded once its files did not change between two polls, so that
+     * we do not pick up a model that is still being written.
+     */
+    template<typename model_type>
+    void model_cli<SERVE, model_type>::watch()
+    {
+      std::map<std::filesystem::path, signature_type> last_seen={};
+
+      auto interval = std::chrono::milliseconds(std::size_t(1000*configuration.watch_interval));
+      auto t0 = std::chrono::system_clock::now();
+
+      while(running and (not interrupted))
+        {
+          std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+          if(std::chrono::system_clock::now()-t0<interval)
+            {
+              continue;
+            }
+          t0 = std::chrono::system_clock::now();
+
+          std::error_code ec;
+
+          std::map<std::filesystem::path, signature_type> seen={};
+          for(auto itr=std::filesystem::directory_iterator(configuration.watch_dir, ec);
+              (not ec) and itr!=std::filesystem::directory_iterator(); itr.increment(ec))
+            {
+              signature_type signature;
+              if(itr->is_directory(ec) and get_signature(itr->path(), signature))
+                {
+                  seen[itr->path()] = signature;
+                }
+            }
+
+          std::filesystem::path newest;
+          signature_type newest_signature;
+
+          for(auto& item:seen)
+            {
+              if(newest.empty() or newest_signature.first<item.second.first)
+                {
+                  newest = item.first;
+                  newest_signature = item.second;
+                }
+            }
+
+          std::filesystem::file_time_type current_time;
+          {
+            std::scoped_lock lock(snapshot_mtx);
+            current_time = snapshot_time;
+          }
+
+          if((not newest.empty()) and current_time<newest_signature.first and
+             last_seen.count(newest)==1 and last_seen.at(newest)==newest_signature)
+            {
+              LOG_S(INFO) << "new model detected: " << newest;
+              reload(newest);
+            }
+
+          last_seen = seen;
+        }
+    }
+
+    /*
+     * Loads the model at `path` next to the current one and swaps it in.
+     * If the load fails, the current model keeps being served.
+     */
+    template<typename model_type>
+    bool model_cli<SERVE, model_type>::reload(std::filesystem::path path)
+    {
+      std::scoped_lock reload_lock(reload_mtx);
+
+      signature_type signature;
+      if(not get_signature(path, signature))
+        {
+          LOG_S(WARNING) << "no complete model in " << path << ": keep serving the current model";
+          return false;
+        }
+
+      auto t0 = std::chrono::system_clock::now();
+
+      std::shared_ptr<const model_type> new_snapshot=NULL;
+      try
+        {
+          // the load-options of the config, with the new root
+          nlohmann::json load_config = config;
+          load_config[io_base::io_lbl][io_base::load_lbl][root_lbl] = path.string();
+
+          model_op<LOAD> io;
+
+          io.from_config(load_config);
+          io.set_incremental(false);
+
+          // the reload runs next to the pool, by default it does not take more threads than the pool
+          if(load_config[io_base::io_lbl][io_base::load_lbl].value(io_base::num_threads_lbl, 0)==0)
+            {
+              io.set_num_threads(configuration.num_threads);
+            }
+
+          auto new_model = std::make_shared<model_type>();
+          if(io.load(new_model))
+            {
+              new_snapshot = model_type::snapshot(new_model);
+            }
+        }
+      catch(std::exception& exc)
+        {
+          LOG_S(ERROR) << exc.what();
+        }
+
+      if(new_snapshot==NULL)
+        {
+          LOG_S(WARNING) << "could not load " << path << ": keep serving the current model";
+          return false;
+        }
+
+      {
+        std::scoped_lock lock(snapshot_mtx);
+
+        snapshot = new_snapshot;
+        snapshot_path = path;
+        snapshot_time = signature.first;
+
+        generation += 1;
+      }
+
+      std::chrono::duration<double> delta_t = std::chrono::system_clock::now()-t0;
+      LOG_S(INFO) << "serving " << path << " (loaded in " << delta_t.count() << " sec)";
+
+      return true;
+    }
+
+    template<typename model_type>
+    bool model_cli<SERVE, model_type>::get_signature(std::filesystem::path path, signature_type& signature)
+    {
+      // the default time-point is the epoch of the file-clock, which is not the earliest time
+      signature = signature_type(std::filesystem::file_time_type::min(), 0);
+
+      for(std::string name:{"parameters.json", "topology.json", "nodes.bin", "edges.bin"})
+        {
+          std::error_code ec;
+
+          std::filesystem::path file = path / name;
+
+          auto time = std::filesystem::last_write_time(file, ec);
+          if(ec)
+            {
+              return false;
+            }
+
+          auto size = std::filesystem::file_size(file, ec);
+          if(ec)
+            {
+              return false;
+            }
+
+          signature.first = std::max(signature.first, time);
+          signature.second += size;
+        }
+
+      return true;
+    }
+
+  }
+
+}
+
+#endif
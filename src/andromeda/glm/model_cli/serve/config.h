@@ -0,0 +1,113 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_MODEL_CLI_SERVE_CONFIG_H_
+#define ANDROMEDA_MODELS_GLM_MODEL_CLI_SERVE_CONFIG_H_
+
+namespace andromeda
+{
+  namespace glm
+  {
+    class serve_config
+    {
+      const static inline std::string serve_lbl = to_string(SERVE);
+
+      const static inline std::string socket_lbl = "socket"; // path of a Unix domain socket
+      const static inline std::string port_lbl = "port"; // localhost TCP, if there is no socket
+
+      const static inline std::string num_threads_lbl = "number-of-threads"; // 0: #-cores
+      const static inline std::string flow_threads_lbl = "flow-threads"; // per query-flow, 0: no cap
+      const static inline std::string max_batch_size_lbl = "max-batch-size";
+      const static inline std::string max_request_size_lbl = "max-request-size"; // in bytes
+
+      const static inline std::string watch_dir_lbl = "watch-directory"; // new models appear here
+      const static inline std::string watch_interval_lbl = "watch-interval"; // in sec
+
+    public:
+
+      serve_config();
+      serve_config(nlohmann::json config);
+
+      void from_json(nlohmann::json& config);
+
+      nlohmann::json to_json();
+
+    public:
+
+      std::string socket_path;
+      int port;
+
+      std::size_t num_threads;
+      std::size_t flow_threads;
+      std::size_t max_batch_size;
+      std::size_t max_request_size;
+
+      std::string watch_dir;
+      double watch_interval;
+    };
+
+    serve_config::serve_config():
+      socket_path("./glm-serve.sock"),
+      port(0),
+
+      num_threads(0),
+      flow_threads(1),
+      max_batch_size(64),
+      max_request_size(1<<26),
+
+      watch_dir(""),
+      watch_interval(10.0)
+    {}
+
+    serve_config::serve_config(nlohmann::json config):
+      serve_config()
+    {
+      from_json(config);
+    }
+
+    void serve_config::from_json(nlohmann::json& config)
+    {
+      if(config.count(serve_lbl)==1)
+        {
+          nlohmann::json& serve = config[serve_lbl];
+
+          socket_path = serve.value(socket_lbl, socket_path);
+          port = serve.value(port_lbl, port);
+
+          num_threads = serve.value(num_threads_lbl, num_threads);
+          flow_threads = serve.value(flow_threads_lbl, flow_threads);
+          max_batch_size = serve.value(max_batch_size_lbl, max_batch_size);
+          max_request_size = serve.value(max_request_size_lbl, max_request_size);
+
+          watch_dir = serve.value(watch_dir_lbl, watch_dir);
+          watch_interval = serve.value(watch_interval_lbl, watch_interval);
+        }
+    }
+
+    nlohmann::json serve_config::to_json()
+    {
+      nlohmann::json result;
+
+      result["mode"] = to_string(SERVE);
+
+      auto& serve = result[serve_lbl];
+      {
+        serve[socket_lbl] = socket_path;
+        serve[port_lbl] = port;
+
+        serve[num_threads_lbl] = num_threads;
+        serve[flow_threads_lbl] = flow_threads;
+        serve[max_batch_size_lbl] = max_batch_size;
+        serve[max_request_size_lbl] = max_request_size;
+
+        serve[watch_dir_lbl] = watch_dir;
+        serve[watch_interval_lbl] = watch_interval;
+      }
+
+      return result;
+    }
+
+  }
+
+}
+
+#endif
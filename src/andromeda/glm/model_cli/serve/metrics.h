@@ -0,0 +1,161 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_MODEL_CLI_SERVE_METRICS_H_
+#define ANDROMEDA_MODELS_GLM_MODEL_CLI_SERVE_METRICS_H_
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Latency statistics of the served query-flows. The percentiles are
+     * computed over a window of the most recent requests, the counters
+     * since the server started.
+     */
+    class serve_metrics
+    {
+    public:
+
+      const static inline std::string requests_lbl = "#-requests";
+      const static inline std::string failures_lbl = "#-failures";
+      const static inline std::string batches_lbl = "#-batches";
+
+      const static inline std::string uptime_lbl = "uptime [sec]";
+
+      const static inline std::string queue_lbl = "queue [msec]";
+      const static inline std::string execute_lbl = "execute [msec]";
+      const static inline std::string total_lbl = "total [msec]";
+
+    public:
+
+      serve_metrics(std::size_t window=4096);
+
+      void add_batch();
+      void add_request(bool success, double queue_time, double execute_time);
+
+      nlohmann::json to_json();
+
+    private:
+
+      static nlohmann::json to_json(std::vector<double> times);
+
+    private:
+
+      std::mutex mtx;
+
+      std::chrono::time_point<std::chrono::system_clock> t0;
+
+      std::size_t num_requests, num_failures, num_batches;
+
+      // ring-buffers of the last `window` requests
+      std::size_t window;
+      std::vector<double> queue_times, execute_times;
+    };
+
+    serve_metrics::serve_metrics(std::size_t window):
+      mtx(),
+
+      t0(std::chrono::system_clock::now()),
+
+      num_requests(0),
+      num_failures(0),
+      num_batches(0),
+
+      window(std::max(std::size_t(1), window)),
+      queue_times({}),
+      execute_times({})
+    {}
+
+    void serve_metrics::add_batch()
+    {
+      std::scoped_lock lock(mtx);
+      num_batches += 1;
+    }
+
+    void serve_metrics::add_request(bool success, double queue_time, double execute_time)
+    {
+      std::scoped_lock lock(mtx);
+
+      if(queue_times.size()<window)
+        {
+          queue_times.push_back(queue_time);
+          execute_times.push_back(execute_time);
+        }
+      else
+        {
+          queue_times.at(num_requests%window) = queue_time;
+          execute_times.at(num_requests%window) = execute_time;
+        }
+
+      num_requests += 1;
+      num_failures += (success? 0:1);
+    }
+
+    nlohmann::json serve_metrics::to_json()
+    {
+      std::vector<double> queue={}, execute={}, total={};
+      nlohmann::json result = nlohmann::json::object({});
+
+      {
+        std::scoped_lock lock(mtx);
+
+        std::chrono::duration<double> uptime = std::chrono::system_clock::now()-t0;
+
+        result[requests_lbl] = num_requests;
+        result[failures_lbl] = num_failures;
+        result[batches_lbl] = num_batches;
+
+        result[uptime_lbl] = uptime.count();
+
+        queue = queue_times;
+        execute = execute_times;
+      }
+
+      for(std::size_t l=0; l<queue.size(); l++)
+        {
+          total.push_back(queue.at(l)+execute.at(l));
+        }
+
+      result[queue_lbl] = to_json(queue);
+      result[execute_lbl] = to_json(execute);
+      result[total_lbl] = to_json(total);
+
+      return result;
+    }
+
+    nlohmann::json serve_metrics::to_json(std::vector<double> times)
+    {
+      nlohmann::json result = nlohmann::json::object({});
+
+      if(times.size()==0)
+        {
+          return result;
+        }
+
+      std::sort(times.begin(), times.end());
+
+      double sum=0.0;
+      for(auto time:times)
+        {
+          sum += time;
+        }
+
+      auto percentile = [&](double p)
+      {
+        return times.at(std::min(times.size()-1, std::size_t(p*times.size())));
+      };
+
+      result["mean"] = sum/times.size();
+      result["p50"] = percentile(0.50);
+      result["p90"] = percentile(0.90);
+      result["p99"] = percentile(0.99);
+      result["max"] = times.back();
+
+      return result;
+    }
+
+  }
+
+}
+
+#endif
@@ -0,0 +1,112 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_MODEL_CLI_SERVE_POOL_H_
+#define ANDROMEDA_MODELS_GLM_MODEL_CLI_SERVE_POOL_H_
+
+#include <future>
+#include <thread>
+
+#include <andromeda/glm/model_cli/create/work_queue.h>
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Fixed set of worker threads that execute the submitted tasks in
+     * order of arrival. The pending tasks are bounded by the capacity of
+     * the queue, so a burst of requests blocks the clients instead of
+     * piling up in memory. On `stop`, the pending tasks are finished before
+     * the workers are joined.
+     */
+    class serve_pool
+    {
+      typedef std::function<void()> task_type;
+
+    public:
+
+      serve_pool(std::size_t num_threads, std::size_t capacity);
+      ~serve_pool();
+
+      std::size_t size() { return workers.size(); }
+
+      template<typename func_type>
+      std::future<std::invoke_result_t<func_type> > submit(func_type func);
+
+      void stop();
+
+    private:
+
+      void run();
+
+    private:
+
+      work_queue<task_type> tasks;
+      std::vector<std::thread> workers;
+    };
+
+    serve_pool::serve_pool(std::size_t num_threads, std::size_t capacity):
+      tasks("serve", capacity),
+      workers()
+    {
+      for(std::size_t l=0; l<num_threads; l++)
+        {
+          workers.emplace_back(&serve_pool::run, this);
+        }
+    }
+
+    serve_pool::~serve_pool()
+    {
+      stop();
+    }
+
+    /*
+     * The future is invalid if the pool was stopped, the caller checks it
+     * with `valid()`.
+     */
+    template<typename func_type>
+    std::future<std::invoke_result_t<func_type> > serve_pool::submit(func_type func)
+    {
+      typedef std::invoke_result_t<func_type> result_type;
+
+      // std::function needs a copyable task
+      auto task = std::make_shared<std::packaged_task<result_type()> >(std::move(func));
+      std::future<result_type> result = task->get_future();
+
+      if(not tasks.push([task]() { (*task)(); }))
+        {
+          return std::future<result_type>();
+        }
+
+      return result;
+    }
+
+    void serve_pool::stop()
+    {
+      tasks.close();
+
+      for(auto& worker:workers)
+        {
+          if(worker.joinable())
+            {
+              worker.join();
+            }
+        }
+
+      workers.clear();
+    }
+
+    void serve_pool::run()
+    {
+      task_type task;
+      while(tasks.pop(task))
+        {
+          task();
+        }
+    }
+
+  }
+
+}
+
+#endif
@@ -0,0 +1,336 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_MODEL_CLI_SERVE_SOCKET_H_
+#define ANDROMEDA_MODELS_GLM_MODEL_CLI_SERVE_SOCKET_H_
+
+#ifndef _WIN32
+#include <poll.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Listening socket of the server: a Unix domain socket if a path is
+     * given, otherwise TCP bound to the loopback interface only. The server
+     * is meant for local clients, it has no authentication.
+     */
+    class serve_socket
+    {
+    public:
+
+      serve_socket();
+      ~serve_socket();
+
+      serve_socket(const serve_socket&) = delete;
+      serve_socket& operator=(const serve_socket&) = delete;
+
+      bool open(std::string path, int port);
+      void close();
+
+      std::string get_address() const;
+
+      // the file-descriptor of a new client, or -1 if none connected within `timeout` msec
+      int accept(int timeout);
+
+    private:
+
+      int fd;
+
+      std::string path;
+      int port;
+    };
+
+    /*
+     * Line-oriented connection with a client: every request and every
+     * response is a single line of JSON.
+     */
+    class serve_connection
+    {
+    public:
+
+      serve_connection(int fd);
+      ~serve_connection();
+
+      serve_connection(const serve_connection&) = delete;
+      serve_connection& operator=(const serve_connection&) = delete;
+
+      // 1: a line was read, 0: no complete line within `timeout` msec, -1: closed or too long
+      int read_line(std::string& line, int timeout, std::size_t max_size);
+
+      bool write_line(const std::string& line);
+
+    private:
+
+      int fd;
+
+      std::string buffer;
+      std::size_t scanned; // the bytes of `buffer` that have no newline
+    };
+
+#ifndef _WIN32
+
+    serve_socket::serve_socket():
+      fd(-1),
+
+      path(""),
+      port(0)
+    {}
+
+    serve_socket::~serve_socket()
+    {
+      close();
+    }
+
+    bool serve_socket::open(std::string socket_path, int socket_port)
+    {
+      close();
+
+      path = socket_path;
+      port = socket_port;
+
+      if(path!="")
+        {
+          sockaddr_un addr;
+          std::memset(&addr, 0, sizeof(addr));
+
+          if(path.size()>=sizeof(addr.sun_path))
+            {
+              LOG_S(ERROR) << "socket path is too long: " << path;
+              return false;
+            }
+
+          addr.sun_family = AF_UNIX;
+          std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path)-1);
+
+          // a socket-file left behind by a previous server
+          if(std::filesystem::exists(path))
+            {
+              std::filesystem::remove(path);
+            }
+
+          fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+          if(fd<0 or ::bind(fd, (sockaddr*)&addr, sizeof(addr))!=0)
+            {
+              LOG_S(ERROR) << "could not bind socket " << path << ": " << std::strerror(errno);
+              close();
+
+              return false;
+            }
+        }
+      else
+        {
+          sockaddr_in addr;
+          std::memset(&addr, 0, sizeof(addr));
+
+          addr.sin_family = AF_INET;
+          addr.sin_port = htons(port);
+          addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+          fd = ::socket(AF_INET, SOCK_STREAM, 0);
+
+          int reuse=1;
+          if(fd>=0)
+            {
+              ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            }
+
+          if(fd<0 or ::bind(fd, (sockaddr*)&addr, sizeof(addr))!=0)
+            {
+              LOG_S(ERROR) << "could not bind localhost:" << port << ": " << std::strerror(errno);
+              close();
+
+              return false;
+            }
+
+          // the port that was assigned if `port` is 0
+          socklen_t len = sizeof(addr);
+          if(::getsockname(fd, (sockaddr*)&addr, &len)==0)
+            {
+              port = ntohs(addr.sin_port);
+            }
+        }
+
+      if(::listen(fd, SOMAXCONN)!=0)
+        {
+          LOG_S(ERROR) << "could not listen on " << get_address() << ": " << std::strerror(errno);
+          close();
+
+          return false;
+        }
+
+      return true;
+    }
+
+    void serve_socket::close()
+    {
+      if(fd>=0)
+        {
+          ::close(fd);
+          fd = -1;
+
+          if(path!="" and std::filesystem::exists(path))
+            {
+              std::filesystem::remove(path);
+            }
+        }
+    }
+
+    std::string serve_socket::get_address() const
+    {
+      return (path!=""? path:("localhost:"+std::to_string(port)));
+    }
+
+    int serve_socket::accept(int timeout)
+    {
+      pollfd pfd = { fd, POLLIN, 0 };
+
+      if(fd<0 or ::poll(&pfd, 1, timeout)<=0)
+        {
+          return -1;
+        }
+
+      int client = ::accept(fd, NULL, NULL);
+
+#ifdef SO_NOSIGPIPE
+      if(client>=0)
+        {
+          int one=1;
+          ::setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+        }
+#endif
+
+      return client;
+    }
+
+    serve_connection::serve_connection(int fd):
+      fd(fd),
+
+      buffer(""),
+      scanned(0)
+    {}
+
+    serve_connection::~serve_connection()
+    {
+      if(fd>=0)
+        {
+          ::close(fd);
+        }
+    }
+
+    int serve_connection::read_line(std::string& line, int timeout, std::size_t max_size)
+    {
+      while(true)
+        {
+          std::size_t pos = buffer.find('\n', scanned);
+
+          if(pos!=std::string::npos)
+            {
+              line = buffer.substr(0, pos);
+              buffer.erase(0, pos+1);
+
+              scanned = 0;
+              return 1;
+            }
+
+          scanned = buffer.size();
+
+          if(buffer.size()>max_size)
+            {
+              LOG_S(WARNING) << "request exceeds " << max_size << " bytes: closing connection";
+              return -1;
+            }
+
+          pollfd pfd = { fd, POLLIN, 0 };
+
+          int ready = ::poll(&pfd, 1, timeout);
+          if(ready==0)
+            {
+              return 0;
+            }
+          else if(ready<0)
+            {
+              return (errno==EINTR? 0:-1);
+            }
+
+          char chunk[65536];
+
+          ssize_t len = ::recv(fd, chunk, sizeof(chunk), 0);
+          if(len<=0)
+            {
+              return -1;
+            }
+
+          buffer.append(chunk, len);
+        }
+
+      return -1;
+    }
+
+    bool serve_connection::write_line(const std::string& line)
+    {
+#ifdef MSG_NOSIGNAL
+      const int flags = MSG_NOSIGNAL;
+#else
+      const int flags = 0;
+#endif
+
+      std::string data = line+"\n";
+
+      std::size_t beg=0;
+      while(beg<data.size())
+        {
+          ssize_t len = ::send(fd, data.data()+beg, data.size()-beg, flags);
+
+          if(len<0 and errno==EINTR)
+            {
+              continue;
+            }
+          else if(len<=0)
+            {
+              return false;
+            }
+
+          beg += len;
+        }
+
+      return true;
+    }
+
+#else
+
+    serve_socket::serve_socket(): fd(-1), path(""), port(0) {}
+    serve_socket::~serve_socket() {}
+
+    bool serve_socket::open(std::string path, int port)
+    {
+      LOG_S(ERROR) << "the `serve` mode is not supported on Windows";
+      return false;
+    }
+
+    void serve_socket::close() {}
+
+    std::string serve_socket::get_address() const { return ""; }
+
+    int serve_socket::accept(int timeout) { return -1; }
+
+    serve_connection::serve_connection(int fd): fd(fd), buffer(""), scanned(0) {}
+    serve_connection::~serve_connection() {}
+
+    int serve_connection::read_line(std::string& line, int timeout, std::size_t max_size) { return -1; }
+
+    bool serve_connection::write_line(const std::string& line) { return false; }
+
+#endif
+
+  }
+
+}
+
+#endif
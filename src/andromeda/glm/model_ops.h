@@ -12,7 +12,8 @@ namespace andromeda
        SAVE,
        LOAD,
 
-       MERGE
+       MERGE,
+       APPEND
       };
     
     std::string to_string(model_op_name name)
@@ -23,6 +24,7 @@ namespace andromeda
 	  case LOAD: return "LOAD";
 
 	  case MERGE: return "MERGE";
+	  case APPEND: return "APPEND";
 	  }
 
 	return "UNKNOWN_MODELOP";
@@ -38,5 +40,6 @@ namespace andromeda
 
 #include <andromeda/glm/model_ops/io.h>
 #include <andromeda/glm/model_ops/merge.h>
+#include <andromeda/glm/model_ops/append.h>
 
 #endif
@@ -0,0 +1,201 @@
+//-*-C++-*-
+
+#ifndef ANDROMEDA_MODELS_GLM_MODELOPS_APPEND_H_
+#define ANDROMEDA_MODELS_GLM_MODELOPS_APPEND_H_
+
+namespace andromeda
+{
+  namespace glm
+  {
+    /*
+     * Appends a (small) delta model to a model on disk. The base model is
+     * memory-mapped and merged flavor by flavor with the delta straight
+     * into the new binaries, reusing the sorted order of the base. Hence,
+     * the base is never materialised nor re-sorted, and only the nodes and
+     * edges touched by the delta are re-ordered.
+     *
+     * The new binaries are written next to the old ones and only moved in
+     * place at the end, so the output can be the base model itself.
+     */
+    template<>
+    class model_op<APPEND>: public io_base
+    {
+      typedef andromeda::glm::model model_type;
+
+      typedef typename model_type::nodes_type nodes_type;
+      typedef typename model_type::edges_type edges_type;
+
+      typedef typename model_type::topology_type topology_type;
+
+      typedef typename nodes_type::node_type node_type;
+      typedef typename edges_type::edge_coll_type edge_coll_type;
+
+    public:
+
+      model_op();
+      ~model_op();
+
+      static bool has_append(const nlohmann::json& config);
+
+      bool from_config(nlohmann::json& config);
+
+      bool append(std::shared_ptr<model_type> delta);
+
+      bool append(std::filesystem::path base_path,
+                  std::shared_ptr<model_type> delta,
+                  std::filesystem::path path);
+
+    private:
+
+      std::filesystem::path base_path;
+      std::filesystem::path model_path;
+    };
+
+    model_op<APPEND>::model_op():
+      io_base(),
+
+      base_path(),
+      model_path()
+    {}
+
+    model_op<APPEND>::~model_op()
+    {}
+
+    bool model_op<APPEND>::has_append(const nlohmann::json& config)
+    {
+      return (io_base::has_load(config) and io_base::has_save(config) and
+              config[io_base::io_lbl][io_base::save_lbl].value(io_base::append_lbl, false));
+    }
+
+    bool model_op<APPEND>::from_config(nlohmann::json& config)
+    {
+      if(not has_append(config))
+        {
+          LOG_S(ERROR) << "appending needs `io.load.root`, `io.save.root` and `io.save.append`";
+          return false;
+        }
+
+      auto& io = config[io_base::io_lbl];
+
+      base_path = io[io_base::load_lbl][io_base::root_lbl].get<std::string>();
+      model_path = io[io_base::save_lbl][io_base::root_lbl].get<std::string>();
+
+      return true;
+    }
+
+    bool model_op<APPEND>::append(std::shared_ptr<model_type> delta)
+    {
+      return this->append(base_path, delta, model_path);
+    }
+
+    bool model_op<APPEND>::append(std::filesystem::path base_path,
+                                  std::shared_ptr<model_type> delta,
+                                  std::filesystem::path path)
+    {
+      LOG_S(INFO) << "appending to " << base_path << " started ...";
+
+      auto start = std::chrono::system_clock::now();
+
+      io_base::set_paths(base_path);
+      if(glm_binary::get_version(nodes_file)!=glm_binary::VERSION or
+         glm_binary::get_version(edges_file)!=glm_binary::VERSION)
+        {
+          LOG_S(ERROR) << "can only append to a model in binary-format 2: " << base_path;
+          return false;
+        }
+
+      auto base = std::make_shared<model_type>();
+      {
+        model_op<LOAD> loader;
+        if(not loader.load(base_path, base))
+          {
+            return false;
+          }
+      }
+
+      if(not io_base::create_paths(path))
+        {
+          return false;
+        }
+
+      // the topology is collected while writing, the base is released before it is saved
+      topology_type topology;
+
+      std::filesystem::path nodes_tmp = nodes_file.string()+".tmp";
+      std::filesystem::path edges_tmp = edges_file.string()+".tmp";
+
+      std::size_t num_nodes=0, num_edges=0;
+      {
+        auto& nodes = base->get_nodes();
+
+        LOG_S(INFO) << "writing " << nodes_tmp.string() << " (v" << glm_binary::VERSION << ")";
+        std::ofstream ofs(nodes_tmp.c_str(), std::ios::binary);
+
+        num_nodes = nodes.write_appended(ofs, delta->get_nodes(), [&topology](const node_type& node)
+        {
+          topology.add_node(node);
+        });
+      }
+
+      {
+        auto& edges = base->get_edges();
+
+        LOG_S(INFO) << "writing " << edges_tmp.string() << " (v" << glm_binary::VERSION << ")";
+        std::ofstream ofs(edges_tmp.c_str(), std::ios::binary);
+
+        num_edges = edges.write_appended(ofs, delta->get_edges(), [&topology](flvr_type flvr,
+                                                                             const edge_coll_type& coll)
+        {
+          topology.add_edges(flvr, coll.get_count_column());
+        });
+      }
+
+      if(num_nodes==0 or num_edges==0)
+        {
+          std::filesystem::remove(nodes_tmp);
+          std::filesystem::remove(edges_tmp);
+
+          return false;
+        }
+
+      nlohmann::json param = (base->get_parameters()).to_json();
+
+      // release the mapping of the base, before its files are replaced
+      base.reset();
+
+      std::filesystem::rename(nodes_tmp, nodes_file);
+      std::filesystem::rename(edges_tmp, edges_file);
+
+      {
+        LOG_S(INFO) << "writing " << param_file.string();
+        std::ofstream ofs(param_file.c_str());
+
+        ofs << std::setw(2) << param;
+      }
+
+      {
+        LOG_S(INFO) << "writing " << topo_file.string();
+        std::ofstream ofs_a(topo_file.c_str());
+
+        nlohmann::json data = topology.to_json();
+        ofs_a << std::setw(2) << data;
+
+        LOG_S(INFO) << "writing " << topo_file_text.string();
+
+        std::ofstream ofs_b(topo_file_text.c_str());
+        topology.to_txt(ofs_b);
+      }
+
+      std::chrono::duration<double, std::milli> delta_t = std::chrono::system_clock::now()-start;
+
+      LOG_S(INFO) << "appending done: " << num_nodes << " nodes, " << num_edges << " edges ("
+                  << std::fixed << std::setprecision(1) << delta_t.count()/1000.0 << " sec)";
+
+      return true;
+    }
+
+  }
+
+}
+
+#endif
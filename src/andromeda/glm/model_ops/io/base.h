@@ -23,6 +23,15 @@ namespace andromeda
       const static inline std::string write_csv_lbl = "write-CSV";
       
       const static inline std::string save_rtext_lbl = "write-path-text";
+
+      const static inline std::string format_lbl = "binary-format"; // 1 (legacy), 2 (mmap-able) or 3 (compressed)
+      const static inline std::string mmap_lbl = "memory-map";
+      const static inline std::string text_index_lbl = "text-index"; // trigrams of the node-texts for regex filters
+      const static inline std::string term_index_lbl = "term-index"; // sorted token/term texts for prefix and fuzzy selects
+      const static inline std::string compact_lbl = "compact-counters"; // packs the resident nodes and edge-counts after loading
+      const static inline std::string num_threads_lbl = "number-of-threads"; // for building the indexes, 0: #-cores
+
+      const static inline std::string append_lbl = "append"; // to the model in `IO.load.root`
       
     public:
 
@@ -29,24 +29,51 @@ namespace andromeda
 
       void set_incremental(bool incr);
 
+      void set_num_threads(std::size_t num_threads);
+
       bool load(std::shared_ptr<model_type> model_ptr);
       
       bool load(std::filesystem::path path,
 		std::shared_ptr<model_type> model_ptr);
 
+      // loads and seals a new model, which is shared read-only (NULL on failure)
+      std::shared_ptr<const model_type> load_snapshot();
+
+    private:
+
+      bool load_v1(std::shared_ptr<model_type> model_ptr);
+      bool load_v2(std::shared_ptr<model_type> model_ptr);
+      bool load_v3(std::shared_ptr<model_type> model_ptr);
+
     private:
 
       std::filesystem::path model_path;
 
       bool read_nodes_incremental;
       bool read_edges_incremental;
+
+      bool memory_map;
+      bool text_index;
+      bool term_index;
+
+      bool compact;
+
+      std::size_t num_threads;
     };
 
     model_op<LOAD>::model_op():
       model_path(),
 
       read_nodes_incremental(false),
-      read_edges_incremental(false)    
+      read_edges_incremental(false),
+
+      memory_map(true),
+      text_index(false),
+      term_index(false),
+
+      compact(false),
+
+      num_threads(0)
     {}
 
     model_op<LOAD>::~model_op()
@@ -57,6 +84,11 @@ namespace andromeda
       read_nodes_incremental = incr;
       read_edges_incremental = incr;
     }
+
+    void model_op<LOAD>::set_num_threads(std::size_t num_threads)
+    {
+      this->num_threads = num_threads;
+    }
     
     nlohmann::json model_op<LOAD>::to_config()
     {
@@ -66,6 +98,11 @@ namespace andromeda
         auto& load = io[io_base::load_lbl];
 
         load[io_base::root_lbl] = "<path-to-root-dir>";
+        load[io_base::mmap_lbl] = true;
+        load[io_base::text_index_lbl] = false;
+        load[io_base::term_index_lbl] = false;
+        load[io_base::compact_lbl] = false;
+        load[io_base::num_threads_lbl] = 0;
       }
 
       return config;
@@ -90,6 +127,12 @@ namespace andromeda
               LOG_S(ERROR) << "path to model does not exists: " << model_path;
               return false;
             }
+
+          memory_map = load.value(io_base::mmap_lbl, memory_map);
+          text_index = load.value(io_base::text_index_lbl, text_index);
+          term_index = load.value(io_base::term_index_lbl, term_index);
+          compact = load.value(io_base::compact_lbl, compact);
+          num_threads = load.value(io_base::num_threads_lbl, num_threads);
           //result = this->load(model_path);
         }
       else
@@ -107,6 +150,18 @@ namespace andromeda
       return this->load(model_path, model_ptr);
     }
     
+    std::shared_ptr<const model> model_op<LOAD>::load_snapshot()
+    {
+      auto model_ptr = std::make_shared<model_type>();
+
+      if(not this->load(model_path, model_ptr))
+        {
+          return NULL;
+        }
+
+      return model_type::snapshot(model_ptr);
+    }
+
     bool model_op<LOAD>::load(std::filesystem::path path, std::shared_ptr<model_type> model_ptr)
     {
       LOG_S(INFO) << "reading started ...";
@@ -142,6 +197,74 @@ namespace andromeda
         topology.from_json(data);
       }
 
+      uint32_t nodes_version = glm_binary::get_version(nodes_file);
+      uint32_t edges_version = glm_binary::get_version(edges_file);
+
+      if(nodes_version!=edges_version)
+        {
+          LOG_S(ERROR) << "nodes (v" << nodes_version << ") and edges (v"
+                       << edges_version << ") differ in binary-format";
+          return false;
+        }
+      else if(nodes_version==glm_binary::COMPRESSED_VERSION)
+        {
+          if(not load_v3(model_ptr))
+            {
+              return false;
+            }
+        }
+      else if(nodes_version!=0)
+        {
+          if(not load_v2(model_ptr))
+            {
+              return false;
+            }
+        }
+      else if(not load_v1(model_ptr))
+        {
+          return false;
+        }
+
+      if(text_index)
+        {
+          model_ptr->get_text_index().build(model_ptr->get_nodes(), glm_parallel::number_of_threads(num_threads));
+        }
+      else
+        {
+          model_ptr->get_text_index().clear();
+        }
+
+      if(term_index)
+        {
+          model_ptr->get_term_index().build(model_ptr->get_nodes(), glm_parallel::number_of_threads(num_threads));
+        }
+      else
+        {
+          model_ptr->get_term_index().clear();
+        }
+
+      // a mapped model is not packed, its columns are views into the binary
+      if(compact)
+        {
+          std::size_t before = model_ptr->memory_size();
+          model_ptr->pack();
+          std::size_t after = model_ptr->memory_size();
+
+          LOG_S(INFO) << "packed model: " << before/1.e6 << " MB -> " << after/1.e6 << " MB";
+        }
+
+      {
+        LOG_S(INFO) << "reading done!";
+
+        auto& topology = model_ptr->get_topology();
+        topology.to_shell();
+      }
+
+      return true;
+    }
+
+    bool model_op<LOAD>::load_v1(std::shared_ptr<model_type> model_ptr)
+    {
       {
         auto& nodes = model_ptr->get_nodes();
 
@@ -175,7 +298,11 @@ namespace andromeda
 
       {
         auto& edges = model_ptr->get_edges();
-        edges.clear();
+
+	if(not read_edges_incremental)
+	  {
+	    edges.clear();
+	  }
 
         LOG_S(INFO) << "reading " << edges_file.string();
         std::ifstream ifs(edges_file.c_str(), std::ios::binary);
@@ -218,25 +345,164 @@ namespace andromeda
 		edges.push_back(edge, read_edges_incremental);
 	      }	    
           }
+
+	// the edges were pushed back without their index (eg a v1 model that is saved again)
+	if(not read_edges_incremental)
+	  {
+	    edges.init_hashmap();
+	  }
 	
 	for(auto itr=overview.begin(); itr!=overview.end(); itr++)
 	  {
 	    LOG_S(INFO) << "edge-flvr: " << itr->first << " -> "
 			<< (itr->second).first << ";" << (itr->second).second;
-	    edges.set_sorted(itr->first, (itr->second).second);
+
+	    // the merged counts are not in the order of the file anymore
+	    edges.set_sorted(itr->first, (itr->second).second and (not read_edges_incremental));
 	  }
-      }
-      
-      {
-        LOG_S(INFO) << "reading done!";
 
-        auto& topology = model_ptr->get_topology();
-        topology.to_shell();
+	if(read_edges_incremental)
+	  {
+	    edges.sort();
+	  }
+
+	edges.freeze();
       }
 
       return true;
     }
 
+    bool model_op<LOAD>::load_v2(std::shared_ptr<model_type> model_ptr)
+    {
+      auto& nodes = model_ptr->get_nodes();
+      auto& edges = model_ptr->get_edges();
+
+      auto nodes_map = std::make_shared<glm_mmap_file>();
+      auto edges_map = std::make_shared<glm_mmap_file>();
+
+      LOG_S(INFO) << "mapping " << nodes_file.string() << " and " << edges_file.string();
+      if((not nodes_map->open(nodes_file)) or
+         (not edges_map->open(edges_file)))
+        {
+          return false;
+        }
+
+      if(read_nodes_incremental)
+        {
+          // merge the mapped nodes into the existing ones
+          nodes_type mapped;
+          if(not mapped.attach(nodes_map))
+            {
+              return false;
+            }
+
+          for(auto flvr_itr=mapped.begin(); flvr_itr!=mapped.end(); flvr_itr++)
+            {
+              for(auto& node:flvr_itr->second)
+                {
+                  nodes.insert(node, false);
+                }
+            }
+        }
+      else if(not nodes.attach(nodes_map))
+        {
+          return false;
+        }
+
+      if(read_edges_incremental)
+        {
+          // merge the mapped edges into the existing ones, summing their counts
+          edges_type mapped;
+          if(not mapped.attach(edges_map))
+            {
+              return false;
+            }
+
+          edges.merge(mapped);
+          edges.freeze();
+        }
+      else if(not edges.attach(edges_map))
+        {
+          return false;
+        }
+
+      LOG_S(INFO) << "#-nodes: " << nodes.size() << ", #-edges: " << edges.size()
+                  << (nodes.is_mapped()? " (memory-mapped)": "");
+
+      if(not memory_map)
+        {
+          nodes.materialise();
+          edges.materialise();
+
+          edges.freeze();
+        }
+
+      return true;
+    }
+
+    /*
+     * Compressed binaries can not be memory-mapped in place: the blocks
+     * are decoded (concurrently) from the mapped files, which are released
+     * afterwards.
+     */
+    bool model_op<LOAD>::load_v3(std::shared_ptr<model_type> model_ptr)
+    {
+      auto& nodes = model_ptr->get_nodes();
+      auto& edges = model_ptr->get_edges();
+
+      auto nodes_map = std::make_shared<glm_mmap_file>();
+      auto edges_map = std::make_shared<glm_mmap_file>();
+
+      LOG_S(INFO) << "decoding " << nodes_file.string() << " and " << edges_file.string();
+      if((not nodes_map->open(nodes_file)) or
+         (not edges_map->open(edges_file)))
+        {
+          return false;
+        }
+
+      if(read_nodes_incremental)
+        {
+          nodes_type decoded;
+          if(not decoded.read_compressed(nodes_map))
+            {
+              return false;
+            }
+
+          for(auto flvr_itr=decoded.begin(); flvr_itr!=decoded.end(); flvr_itr++)
+            {
+              for(auto& node:flvr_itr->second)
+                {
+                  nodes.insert(node, false);
+                }
+            }
+        }
+      else if(not nodes.read_compressed(nodes_map))
+        {
+          return false;
+        }
+
+      if(read_edges_incremental)
+        {
+          edges_type decoded;
+          if(not decoded.read_compressed(edges_map))
+            {
+              return false;
+            }
+
+          edges.merge(decoded);
+        }
+      else if(not edges.read_compressed(edges_map))
+        {
+          return false;
+        }
+
+      LOG_S(INFO) << "#-nodes: " << nodes.size() << ", #-edges: " << edges.size();
+
+      edges.freeze();
+
+      return true;
+    }
+
   }
 
 }
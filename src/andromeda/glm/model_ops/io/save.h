@@ -32,6 +32,18 @@ namespace andromeda
       bool to_bin(std::filesystem::path path,
 		  std::shared_ptr<model_type> model_ptr);
 
+      template<typename model_type>
+      void to_bin_v1(std::shared_ptr<model_type> model_ptr,
+                     std::filesystem::path nodes_path, std::filesystem::path edges_path);
+
+      template<typename model_type>
+      void to_bin_v2(std::shared_ptr<model_type> model_ptr,
+                     std::filesystem::path nodes_path, std::filesystem::path edges_path);
+
+      template<typename model_type>
+      void to_bin_v3(std::shared_ptr<model_type> model_ptr,
+                     std::filesystem::path nodes_path, std::filesystem::path edges_path);
+
       template<typename model_type>
       bool to_csv(std::filesystem::path path,
 		  std::shared_ptr<model_type> model_ptr);
@@ -45,6 +57,8 @@ namespace andromeda
       bool save_to_json, save_to_csv;
       bool save_resolved_text;
 
+      std::size_t binary_format;
+
       std::filesystem::path model_path;
     };
 
@@ -56,6 +70,8 @@ namespace andromeda
 
       save_resolved_text(true),
 
+      binary_format(glm_binary::VERSION),
+
       model_path()
     {}
 
@@ -75,6 +91,10 @@ namespace andromeda
         save[io_base::write_csv_lbl] = false;
 
         save[io_base::save_rtext_lbl] = false;
+
+        save[io_base::format_lbl] = glm_binary::VERSION;
+
+        save[io_base::append_lbl] = false;
       }
 
       return config;
@@ -103,6 +123,8 @@ namespace andromeda
           save_to_csv = save.value(io_base::write_csv_lbl, save_to_csv);
 
           save_resolved_text = save.value(io_base::save_rtext_lbl, save_resolved_text);
+
+          binary_format = save.value(io_base::format_lbl, binary_format);
         }
       else
         {
@@ -135,7 +157,7 @@ namespace andromeda
     bool model_op<SAVE>::save(std::filesystem::path path,
 			      std::shared_ptr<model_type> model_ptr)
     {
-      return this->to_bin(model_path, model_ptr);
+      return this->to_bin(path, model_ptr);
     }
     
     template<typename model_type>
@@ -174,13 +196,41 @@ namespace andromeda
         topology.to_txt(ofs_b);
       }
 
+      // the model can still be mapped from the binaries it replaces (eg when it is saved
+      // into the directory it was loaded from), so they are only replaced at the end
+      std::filesystem::path nodes_tmp = nodes_file.string()+".tmp";
+      std::filesystem::path edges_tmp = edges_file.string()+".tmp";
+
+      if(binary_format==1)
+        {
+          to_bin_v1(model_ptr, nodes_tmp, edges_tmp);
+        }
+      else if(binary_format==glm_binary::COMPRESSED_VERSION)
+        {
+          to_bin_v3(model_ptr, nodes_tmp, edges_tmp);
+        }
+      else
+        {
+          to_bin_v2(model_ptr, nodes_tmp, edges_tmp);
+        }
+
+      std::filesystem::rename(nodes_tmp, nodes_file);
+      std::filesystem::rename(edges_tmp, edges_file);
+
+      return true;
+    }
+
+    template<typename model_type>
+    void model_op<SAVE>::to_bin_v1(std::shared_ptr<model_type> model_ptr,
+                                   std::filesystem::path nodes_path, std::filesystem::path edges_path)
+    {
       {
         auto& nodes = model_ptr->get_nodes();
 
 	nodes.sort();
 	
-        LOG_S(INFO) << "writing " << nodes_file.string();
-        std::ofstream ofs(nodes_file.c_str(), std::ios::binary);
+        LOG_S(INFO) << "writing " << nodes_path.string();
+        std::ofstream ofs(nodes_path.c_str(), std::ios::binary);
 
         std::size_t tot = nodes.size();
         ofs.write((char*)&tot, sizeof(tot));
@@ -205,8 +255,8 @@ namespace andromeda
       {
         auto& edges = model_ptr->get_edges();
 
-        LOG_S(INFO) << "writing " << edges_file.string();
-        std::ofstream ofs(edges_file.c_str(), std::ios::binary);
+        LOG_S(INFO) << "writing " << edges_path.string();
+        std::ofstream ofs(edges_path.c_str(), std::ios::binary);
 
         std::size_t M=edges.number_of_flavors();
         ofs.write((char*)&M, sizeof(M));
@@ -234,8 +284,64 @@ namespace andromeda
               }
           }
       }
+    }
 
-      return true;
+    template<typename model_type>
+    void model_op<SAVE>::to_bin_v2(std::shared_ptr<model_type> model_ptr,
+                                   std::filesystem::path nodes_path, std::filesystem::path edges_path)
+    {
+      {
+        auto& nodes = model_ptr->get_nodes();
+
+        nodes.sort();
+
+        LOG_S(INFO) << "writing " << nodes_path.string() << " (v" << glm_binary::VERSION << ")";
+        std::ofstream ofs(nodes_path.c_str(), std::ios::binary);
+
+        nodes.write(ofs);
+      }
+
+      {
+        auto& edges = model_ptr->get_edges();
+
+        // sorted & frozen flavors are stored with their adjacency, so that a
+        // memory-mapped model can be traversed without rebuilding anything
+        edges.sort();
+        edges.freeze();
+
+        LOG_S(INFO) << "writing " << edges_path.string() << " (v" << glm_binary::VERSION << ")";
+        std::ofstream ofs(edges_path.c_str(), std::ios::binary);
+
+        edges.write(ofs);
+      }
+    }
+
+    template<typename model_type>
+    void model_op<SAVE>::to_bin_v3(std::shared_ptr<model_type> model_ptr,
+                                   std::filesystem::path nodes_path, std::filesystem::path edges_path)
+    {
+      {
+        auto& nodes = model_ptr->get_nodes();
+
+        nodes.sort();
+
+        LOG_S(INFO) << "writing " << nodes_path.string() << " (v" << glm_binary::COMPRESSED_VERSION << ")";
+        std::ofstream ofs(nodes_path.c_str(), std::ios::binary);
+
+        nodes.write_compressed(ofs);
+      }
+
+      {
+        auto& edges = model_ptr->get_edges();
+
+        // the adjacencies are not stored, they are rebuilt when loading
+        edges.sort();
+
+        LOG_S(INFO) << "writing " << edges_path.string() << " (v" << glm_binary::COMPRESSED_VERSION << ")";
+        std::ofstream ofs(edges_path.c_str(), std::ios::binary);
+
+        edges.write_compressed(ofs);
+      }
     }
 
     template<typename model_type>
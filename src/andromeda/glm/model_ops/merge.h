@@ -66,11 +66,17 @@ namespace andromeda
     {
       auto& curr_edges = current->get_edges();
       auto& other_edges = other->get_edges();
+
+      if(not check_size)
+	{
+	  curr_edges.merge(other_edges);
+	  return;
+	}
       
       for(auto itr=other_edges.begin(); itr!=other_edges.end(); itr++)
 	{
 	  auto& flvr_coll = itr->second;
-	  for(auto& edge:flvr_coll)
+	  for(const auto& edge:flvr_coll)
 	    {
 	      curr_edges.insert(edge, check_size);
 	    }	  
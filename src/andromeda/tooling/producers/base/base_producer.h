@@ -57,6 +57,11 @@ namespace andromeda
     virtual bool set_ofs(std::filesystem::path path) { return false; }
     
     virtual bool keep_reading(std::size_t cnt) { return ((path_itr!=paths.end()) and (cnt<maxnum_docs)); }
+
+    /* POSITION in the input, so that reading can be resumed later on */
+
+    virtual nlohmann::json get_position() { return nlohmann::json::object({}); }
+    virtual bool set_position(const nlohmann::json& position) { return false; }
     
     /* NEXT will execute `read` and `apply` in consecutive order */
     
@@ -78,6 +83,15 @@ namespace andromeda
     virtual bool apply(paragraph_type& subj) { return false; };
     virtual bool apply(doc_type& subj) { return false; };    
 
+    /* FETCH and PARSE split up READ: only `fetch` touches the state of the
+       producer (and needs to be serialised), `parse` can run concurrently */
+
+    virtual bool fetch(std::string& raw, std::filesystem::path& path, std::size_t& cnt) { return false; };
+
+    virtual bool parse(table_type& subj, const std::string& raw, const std::filesystem::path& path) { return false; };
+    virtual bool parse(paragraph_type& subj, const std::string& raw, const std::filesystem::path& path) { return false; };
+    virtual bool parse(doc_type& subj, const std::string& raw, const std::filesystem::path& path) { return false; };
+
   protected:
 
     virtual bool initialise(nlohmann::json& config);
@@ -38,6 +38,9 @@ namespace andromeda
     virtual bool reset_pointer();
 
     virtual bool set_ofs(std::filesystem::path odir);
+
+    virtual nlohmann::json get_position();
+    virtual bool set_position(const nlohmann::json& position);
     
     /* next */
     
@@ -56,6 +59,15 @@ namespace andromeda
     //virtual bool read(webdoc_type& subj, std::size_t& cnt) { return false; };
     virtual bool read(doc_type& subj, std::size_t& cnt);
 
+    /* fetch & parse */
+
+    virtual bool fetch(std::string& raw, std::filesystem::path& path, std::size_t& cnt);
+
+    virtual bool parse(table_type& subj, const std::string& raw, const std::filesystem::path& path) { return false; };
+    virtual bool parse(paragraph_type& subj, const std::string& raw, const std::filesystem::path& path) { return false; };
+
+    virtual bool parse(doc_type& subj, const std::string& raw, const std::filesystem::path& path);
+
     /* write */
     
     virtual bool write(table_type& subj) { return false; };
@@ -186,6 +198,33 @@ namespace andromeda
     return true;
   }
   
+  nlohmann::json producer<DOCUMENT>::get_position()
+  {
+    nlohmann::json position = nlohmann::json::object({});
+    {
+      position["path-index"] = std::size_t(path_itr-paths.begin());
+      position["documents"] = curr_docs;
+    }
+
+    return position;
+  }
+
+  bool producer<DOCUMENT>::set_position(const nlohmann::json& position)
+  {
+    std::size_t ind = position.value("path-index", std::size_t(0));
+    if(ind>paths.size())
+      {
+        return false;
+      }
+
+    reset_pointer();
+
+    path_itr += ind;
+    curr_docs = position.value("documents", curr_docs);
+
+    return true;
+  }
+
   bool producer<DOCUMENT>::next(doc_type& subject, std::size_t& cnt)
   {    
     if(read(subject, cnt))
@@ -197,6 +236,22 @@ namespace andromeda
   }
 
   bool producer<DOCUMENT>::read(doc_type& subject, std::size_t& count)
+  {
+    std::string raw;
+    std::filesystem::path path;
+
+    while(fetch(raw, path, count))
+      {
+	if(parse(subject, raw, path))
+	  {
+	    return true;
+	  }
+      }
+
+    return false;
+  }
+
+  bool producer<DOCUMENT>::fetch(std::string& raw, std::filesystem::path& path, std::size_t& count)
   {
     if(curr_docs>=maxnum_docs)
       {
@@ -210,37 +265,41 @@ namespace andromeda
 	
         return false;
       }
-    
-    bool valid=false, success=false;
 
-    while((not valid) and (path_itr!=path_end))
+    while(path_itr!=path_end)
       {
-	// LOG_S(INFO) << "reading: " << path_itr->c_str();
-  LOG_S(INFO) << "reading: " << path_itr->string();
+	path = *(path_itr++);
+	LOG_S(INFO) << "reading: " << path.string();
 
-	// std::ifstream ifs(path_itr->c_str());
-  std::ifstream ifs(path_itr->string());
+	std::ifstream ifs(path.string(), std::ios::binary);
 
 	if(ifs)
 	  {
-	    nlohmann::json data;
-	    ifs >> data;
+	    // only the raw bytes, the json-parsing is left to `parse`
+	    raw.assign(std::istreambuf_iterator<char>(ifs),
+		       std::istreambuf_iterator<char>());
 
-	    valid = subject.set_data(*path_itr, data, order_text);
-	  }
+	    count += 1;
+	    curr_docs += 1;
 
-	success = ((valid) and (path_itr!=path_end));
-	
-	path_itr++;
+	    return true;
+	  }
       }
+    
+    return false;
+  }
 
-    if(success)
+  bool producer<DOCUMENT>::parse(doc_type& subject, const std::string& raw, const std::filesystem::path& path)
+  {
+    nlohmann::json data = nlohmann::json::parse(raw, NULL, false);
+
+    if(data.is_discarded())
       {
-	count += 1;
-	curr_docs += 1;
+	LOG_S(ERROR) << "could not json-parse document: " << path.string();
+	return false;
       }
-    
-    return success;
+
+    return subject.set_data(path, data, order_text);
   }
 
   bool producer<DOCUMENT>::apply(doc_type& subject)
@@ -35,6 +35,9 @@ namespace andromeda
 
     virtual bool set_ofs(std::filesystem::path path);
 
+    virtual nlohmann::json get_position();
+    virtual bool set_position(const nlohmann::json& position);
+
     /* next */
 
     virtual bool next(std::string& text, std::size_t& cnt);
@@ -49,6 +52,14 @@ namespace andromeda
     virtual bool read(paragraph_type& subj, std::size_t& cnt);
     virtual bool read(doc_type& subj, std::size_t& cnt) { return false; };
 
+    /* fetch & parse */
+
+    virtual bool fetch(std::string& raw, std::filesystem::path& path, std::size_t& cnt);
+
+    virtual bool parse(table_type& subj, const std::string& raw, const std::filesystem::path& path) { return false; };
+    virtual bool parse(paragraph_type& subj, const std::string& raw, const std::filesystem::path& path);
+    virtual bool parse(doc_type& subj, const std::string& raw, const std::filesystem::path& path) { return false; };
+
     /* write */
 
     virtual bool write(table_type& subj) { return false; };
@@ -67,10 +78,13 @@ namespace andromeda
                     std::string format="txt",
                     std::string key="");
 
+    bool to_text(const std::string& line, std::string& text) const;
+
   private:
 
     std::string key;
     std::size_t start_line, curr_line;
+    std::size_t skip_lines; // lines to skip when resuming (see `set_position`)
 
     std::ifstream ifs;
     std::ofstream ofs;
@@ -82,7 +96,8 @@ namespace andromeda
     key(""),
 
     start_line(0),
-    curr_line(0)
+    curr_line(0),
+    skip_lines(0)
   {}
 
   producer<TEXT>::producer(std::vector<model_ptr_type> models):
@@ -91,7 +106,8 @@ namespace andromeda
     key(""),
 
     start_line(0),
-    curr_line(0)
+    curr_line(0),
+    skip_lines(0)
   {}
 
   producer<TEXT>::producer(nlohmann::json& config, std::vector<model_ptr_type>& models):
@@ -100,7 +116,8 @@ namespace andromeda
     key(""),
 
     start_line(0),
-    curr_line(0)
+    curr_line(0),
+    skip_lines(0)
   {
     initialise(config);
   }
@@ -111,7 +128,8 @@ namespace andromeda
     key(other.key),
 
     start_line(other.start_line),
-    curr_line(other.curr_line)
+    curr_line(other.curr_line),
+    skip_lines(other.skip_lines)
   {}
 
   producer<TEXT>::~producer()
@@ -215,8 +233,45 @@ namespace andromeda
     return ofs.good();
   }
 
+  nlohmann::json producer<TEXT>::get_position()
+  {
+    nlohmann::json position = nlohmann::json::object({});
+    {
+      position["path-index"] = std::size_t(path_itr-paths.begin());
+      position["line"] = (ifs.is_open()? curr_line: 0);
+    }
+
+    return position;
+  }
+
+  bool producer<TEXT>::set_position(const nlohmann::json& position)
+  {
+    std::size_t ind = position.value("path-index", std::size_t(0));
+    if(ind>paths.size())
+      {
+        return false;
+      }
+
+    reset_pointer();
+
+    path_itr += ind;
+    skip_lines = position.value("line", std::size_t(0));
+
+    return true;
+  }
+
   bool producer<TEXT>::next(std::string& text,
                             std::size_t& cnt)
+  {
+    std::string line;
+    std::filesystem::path path;
+
+    return (fetch(line, path, cnt) and to_text(line, text));
+  }
+
+  bool producer<TEXT>::fetch(std::string& line,
+                             std::filesystem::path& path,
+                             std::size_t& cnt)
   {
     if(cnt++>=maxnum_docs)
       {
@@ -233,7 +288,6 @@ namespace andromeda
 
     //LOG_S(INFO) << "(path_itr==path_end): " << (path_itr==path_end);
 
-    std::string line;
     while(not (ifs.is_open() and std::getline(ifs, line)))
       {
         //LOG_S(INFO) << "file open: " << ifs.is_open() << " -> " << line;
@@ -264,6 +318,10 @@ namespace andromeda
               }
 
             curr_line=0;
+
+            // resuming in the middle of the file
+            for(; curr_line<skip_lines and std::getline(ifs, line); curr_line++) {}
+            skip_lines = 0;
           }
       }
 
@@ -279,6 +337,14 @@ namespace andromeda
         curr_line += 1;
       }
 
+    path = *path_itr;
+    
+    return true;
+  }
+
+  bool producer<TEXT>::to_text(const std::string& line,
+                               std::string& text) const
+  {
     if(iformat=="txt")
       {
         text = line;
@@ -322,10 +388,20 @@ namespace andromeda
   bool producer<TEXT>::read(paragraph_type& subject,
                             std::size_t& cnt)
   {
-    subject.clear();
-    
     std::string line;
-    if(next(line, cnt) and subject.set_text(line))
+    std::filesystem::path path;
+
+    return (fetch(line, path, cnt) and parse(subject, line, path));
+  }
+
+  bool producer<TEXT>::parse(paragraph_type& subject,
+                             const std::string& line,
+                             const std::filesystem::path& path)
+  {
+    subject.clear();
+
+    std::string text;
+    if(to_text(line, text) and subject.set_text(text))
       {
         return true;
       }
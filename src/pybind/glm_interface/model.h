@@ -141,6 +141,12 @@ namespace andromeda_py
 
   nlohmann::json glm_model::distill(nlohmann::json config)
   {
+    // keep the model of this object intact, unless asked otherwise
+    if(not config.contains(andromeda::glm::distill_config::in_place_lbl))
+      {
+        config[andromeda::glm::distill_config::in_place_lbl] = false;
+      }
+
     std::shared_ptr<glm_model_type> new_model=NULL;
     andromeda::glm::distill_glm_model(config, model, new_model);
 